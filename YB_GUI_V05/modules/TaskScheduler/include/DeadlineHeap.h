@@ -0,0 +1,70 @@
+#ifndef DEADLINE_HEAP_H
+#define DEADLINE_HEAP_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "TaskScheduler.h"
+
+namespace YB {
+
+// 任务超时的截止时间：按截止时间排序的索引最小堆，每个任务最多一个条目（排队时限或执行时限）。
+// 任务对象记录自己在堆中的位置（Task::deadlineSlot），开始执行时替换、结束时移除均为O(log n)；
+// 超时线程睡眠到最早的截止时间，只取出已到期的条目，开销与到期数量成正比，与任务总数无关
+class DeadlineHeap {
+public:
+    enum class Kind {
+        QUEUE_WAIT,     // 提交到开始执行
+        EXECUTION       // 开始执行到结束
+    };
+
+    struct Expired {
+        std::shared_ptr<Task> task;
+        Kind kind;
+    };
+
+    DeadlineHeap() = default;
+
+    DeadlineHeap(const DeadlineHeap&) = delete;
+    DeadlineHeap& operator=(const DeadlineHeap&) = delete;
+
+    // 设置任务的截止时间，任务已有条目时替换；成为最早的截止时间时唤醒等待方
+    void arm(const std::shared_ptr<Task>& task, Kind kind, std::chrono::steady_clock::time_point deadline);
+
+    // 移除任务的条目（没有时不做任何事）
+    void disarm(Task& task);
+
+    // 等待到最早的截止时间或wakeAt（先到者为准），取出全部已到期的条目；stop后立即返回
+    std::vector<Expired> waitExpired(std::chrono::steady_clock::time_point wakeAt);
+
+    // 唤醒并结束等待（关闭调度器时）
+    void stop();
+
+    // 丢弃全部条目并恢复等待（重新初始化前，调用方保证没有线程在等待）
+    void clear();
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::chrono::steady_clock::time_point deadline;
+        Kind kind;
+        std::shared_ptr<Task> task;
+    };
+
+    void place(size_t index, Entry entry);
+    size_t siftUp(size_t index);
+    void siftDown(size_t index);
+    Entry removeAt(size_t index);
+
+    std::vector<Entry> heap_;
+    bool stopped_ = false;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+};
+
+} // namespace YB
+
+#endif // DEADLINE_HEAP_H
@@ -0,0 +1,205 @@
+#ifndef FIBER_H
+#define FIBER_H
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <future>
+#include <cstdint>
+
+namespace YB {
+
+class ThreadPool;
+
+namespace detail {
+struct Fiber;
+struct FiberCarrier;
+}
+
+// 纤程运行时配置
+struct FiberConfig {
+    size_t stackSize = 64 * 1024;   // 每个纤程的栈大小（向上取整到页）
+    bool guardPages = true;         // 栈底保护页，溢出时触发SIGSEGV而不是静默破坏内存
+    size_t maxPooledStacks = 1024;  // 缓存复用的空闲栈上限
+};
+
+// 带保护页的纤程栈分配器，释放的栈进入池中复用
+// 注意：每个带保护页的栈占用两个内存映射区，大量纤程需要调高vm.max_map_count
+class FiberStackAllocator {
+public:
+    struct Stack {
+        void* base = nullptr;   // 可用区域的低地址
+        size_t size = 0;        // 可用区域大小（不含保护页）
+    };
+
+    FiberStackAllocator(size_t stackSize, bool guardPages, size_t maxPooledStacks);
+    ~FiberStackAllocator();
+
+    FiberStackAllocator(const FiberStackAllocator&) = delete;
+    FiberStackAllocator& operator=(const FiberStackAllocator&) = delete;
+
+    // 分配栈（失败时抛出std::bad_alloc）
+    Stack allocate();
+
+    // 归还栈
+    void deallocate(const Stack& stack);
+
+    size_t getStackSize() const;
+    size_t getGuardSize() const;
+    size_t getPooledStacks() const;
+    size_t getMappedStacks() const;
+
+private:
+    void unmap(const Stack& stack);
+
+    size_t stackSize_;
+    size_t guardSize_;
+    size_t maxPooledStacks_;
+
+    mutable std::mutex mutex_;
+    std::vector<Stack> pool_;
+    std::atomic<size_t> mappedStacks_;
+};
+
+// 随纤程迁移的线程局部状态（例如调度器记录的当前任务和优先级）：纤程挂起前调用save取出
+// 当前线程上的值并恢复线程原有的值，恢复运行后（可能已换到另一个载体线程）调用restore写回
+class FiberLocalState {
+public:
+    virtual ~FiberLocalState() = default;
+    virtual void save() = 0;
+    virtual void restore() = 0;
+};
+
+// M:N纤程运行时：纤程在若干个ThreadPool工作线程（载体线程）上复用执行，
+// 纤程在FiberMutex/FiberCondVar上等待时只切换纤程，不阻塞载体线程
+class FiberRuntime {
+public:
+    FiberRuntime(ThreadPool& pool, size_t numCarriers, const FiberConfig& config = FiberConfig());
+    ~FiberRuntime();
+
+    FiberRuntime(const FiberRuntime&) = delete;
+    FiberRuntime& operator=(const FiberRuntime&) = delete;
+
+    // 创建纤程并加入就绪队列
+    void spawn(std::function<void()> function);
+
+    // 等待所有纤程结束
+    void waitIdle();
+
+    // 执行完就绪纤程后停止载体线程（仍在等待的纤程在析构时释放）
+    void shutdown();
+
+    // 当前是否在纤程中执行
+    static bool inFiber();
+
+    // 让出当前纤程（没有其他就绪纤程时立即返回）
+    static void yield();
+
+    // 设置当前纤程挂起/恢复时保存的线程局部状态，返回原先设置的状态（不在纤程中时不做任何事）
+    static FiberLocalState* exchangeLocalState(FiberLocalState* state);
+
+    size_t getLiveFibers() const;
+    size_t getCarrierCount() const;
+    uint64_t getContextSwitches() const;
+    FiberStackAllocator& getStackAllocator();
+
+private:
+    friend class FiberMutex;
+    friend class FiberCondVar;
+    friend struct detail::Fiber;
+
+    // 载体线程主循环
+    void carrierLoop();
+
+    // 纤程入口
+    static void fiberMain(detail::Fiber* fiber);
+
+    // 就绪队列操作
+    void makeReady(detail::Fiber* fiber);
+    detail::Fiber* tryPopReady();
+
+    // 挂起当前纤程，切换完成后释放guard
+    static void park(std::mutex& guard);
+
+    // 切出当前纤程，转到下一个就绪纤程或载体调度上下文
+    static void switchOut(detail::FiberCarrier* carrier, detail::Fiber* self);
+
+    // 切换完成后执行上一个上下文留下的动作
+    static void afterSwitch();
+
+    // 释放纤程
+    void destroyFiber(detail::Fiber* fiber);
+
+    // 当前纤程（不在纤程中返回nullptr）
+    static detail::Fiber* currentFiber();
+
+private:
+    FiberStackAllocator stackAllocator_;
+    size_t numCarriers_;
+
+    // 就绪队列
+    std::deque<detail::Fiber*> readyQueue_;
+    std::mutex readyMutex_;
+    std::condition_variable readyCondition_;
+    size_t idleCarriers_;
+    bool stopping_;
+
+    // 所有存活纤程（侵入式链表，用于析构时释放仍在等待的纤程）
+    detail::Fiber* allFibers_;
+    std::mutex fibersMutex_;
+    std::condition_variable idleCondition_;
+
+    std::vector<std::future<void>> carriers_;
+    std::atomic<size_t> liveFibers_;
+    std::atomic<uint64_t> contextSwitches_;
+};
+
+// 纤程互斥锁：纤程中竞争时挂起纤程，锁直接移交给等待者；
+// 在普通线程上调用时退化为让出CPU的自旋等待
+class FiberMutex {
+public:
+    FiberMutex() = default;
+    FiberMutex(const FiberMutex&) = delete;
+    FiberMutex& operator=(const FiberMutex&) = delete;
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    std::mutex guard_;
+    bool locked_ = false;
+    std::deque<detail::Fiber*> waiters_;
+};
+
+// 纤程条件变量，配合FiberMutex使用
+class FiberCondVar {
+public:
+    FiberCondVar() = default;
+    FiberCondVar(const FiberCondVar&) = delete;
+    FiberCondVar& operator=(const FiberCondVar&) = delete;
+
+    void wait(std::unique_lock<FiberMutex>& lock);
+
+    template<typename Predicate>
+    void wait(std::unique_lock<FiberMutex>& lock, Predicate pred) {
+        while (!pred()) {
+            wait(lock);
+        }
+    }
+
+    void notify_one();
+    void notify_all();
+
+private:
+    std::mutex guard_;
+    std::deque<detail::Fiber*> waiters_;
+    uint64_t generation_ = 0;
+};
+
+} // namespace YB
+
+#endif // FIBER_H
@@ -0,0 +1,83 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <chrono>
+#include "TaskScheduler.h"
+#include "ThreadShards.h"
+
+namespace YB {
+
+// 任务延迟记录：每个（优先级, 任务类型）组合一组HDR直方图（排队等待、执行、端到端），首次记录时分配。
+// 每个记录线程写自己的分片（ThreadShards），用relaxed读写代替原子加；记录一个任务不加锁、不分配，
+// 查询时把所有分片中需要的组合按桶合并
+class LatencyRecorder {
+public:
+    void record(Priority priority, TaskType type, std::chrono::steady_clock::time_point submit,
+                std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    LatencyDistribution distribution(LatencyKind kind, std::optional<Priority> priority,
+                                     std::optional<TaskType> type) const;
+
+private:
+    static constexpr size_t kPriorityCount = 5;
+    static constexpr size_t kTaskTypeCount = 5;
+    static constexpr size_t kKindCount = 3;
+    static constexpr size_t kCellCount = kPriorityCount * kTaskTypeCount;
+
+    struct Cell {
+        std::atomic<uint64_t> buckets[kKindCount][LatencyDistribution::kBucketCount] = {};
+    };
+
+    struct Shard {
+        std::atomic<Cell*> cells[kCellCount] = {};
+
+        Shard() = default;
+        Shard(const Shard&) = delete;
+        Shard& operator=(const Shard&) = delete;
+        ~Shard();
+    };
+
+    static uint64_t nanos(std::chrono::steady_clock::duration duration) {
+        return duration.count() > 0
+            ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count())
+            : 0;
+    }
+
+    static void increment(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Cell& cellFor(Priority priority, TaskType type);
+
+    ThreadShards<Shard> shards_;
+};
+
+inline void LatencyRecorder::record(Priority priority, TaskType type, std::chrono::steady_clock::time_point submit,
+                                    std::chrono::steady_clock::time_point start,
+                                    std::chrono::steady_clock::time_point end) {
+    Cell& cell = cellFor(priority, type);
+    increment(cell.buckets[static_cast<size_t>(LatencyKind::QUEUE_WAIT)]
+                          [LatencyDistribution::bucketIndex(nanos(start - submit))]);
+    increment(cell.buckets[static_cast<size_t>(LatencyKind::EXECUTION)]
+                          [LatencyDistribution::bucketIndex(nanos(end - start))]);
+    increment(cell.buckets[static_cast<size_t>(LatencyKind::END_TO_END)]
+                          [LatencyDistribution::bucketIndex(nanos(end - submit))]);
+}
+
+inline LatencyRecorder::Cell& LatencyRecorder::cellFor(Priority priority, TaskType type) {
+    auto& slot = shards_.local().cells[static_cast<size_t>(priority) * kTaskTypeCount + static_cast<size_t>(type)];
+    Cell* cell = slot.load(std::memory_order_relaxed);
+    if (!cell) {
+        // 只有本线程写入这个分片，发布给查询方即可
+        cell = new Cell();
+        slot.store(cell, std::memory_order_release);
+    }
+    return *cell;
+}
+
+} // namespace YB
+
+#endif // LATENCY_HISTOGRAM_H
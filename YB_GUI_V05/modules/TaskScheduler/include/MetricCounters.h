@@ -0,0 +1,93 @@
+#ifndef METRIC_COUNTERS_H
+#define METRIC_COUNTERS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "ThreadShards.h"
+
+namespace YB {
+
+// 调度器的累计计数
+enum class Metric : size_t {
+    TASKS_SUBMITTED,
+    TASKS_COMPLETED,
+    TASKS_FAILED,
+    TASKS_RUN_INLINE,
+    TASKS_REJECTED,
+    TASKS_TIMED_OUT,
+    SUBMIT_BATCHES,
+    WORKER_CONTEXTS_CREATED,
+    AFFINITY_TASKS,
+    AFFINITY_LOCAL_HITS,
+    AFFINITY_STEALS,
+    EXECUTION_MILLIS,       // 已完成任务的执行时间之和
+    GANGS_RUN,
+    GANG_WAIT_MICROS,       // gang集结等待时间之和
+    COUNT
+};
+
+// 按线程分片的计数器：每个线程的计数放在独占缓存行的分片中，只有该线程写入，
+// 递增不加锁也不做原子加；读取时合并所有分片。reset记录当前值作为基线，不修改分片
+class MetricCounters {
+public:
+    static constexpr bool kEnabled = true;
+    static constexpr size_t kCount = static_cast<size_t>(Metric::COUNT);
+    using Values = std::array<uint64_t, kCount>;
+
+    void add(Metric metric, uint64_t value = 1) {
+        auto& counter = shards_.local().values[static_cast<size_t>(metric)];
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // 自上次reset以来的合计
+    Values snapshot() const {
+        Values total = sum();
+        for (size_t i = 0; i < kCount; ++i) {
+            total[i] -= baseline_[i].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void reset() {
+        Values total = sum();
+        for (size_t i = 0; i < kCount; ++i) {
+            baseline_[i].store(total[i], std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> values[kCount] = {};
+    };
+
+    Values sum() const {
+        Values total{};
+        shards_.forEach([&total](const Shard& shard) {
+            for (size_t i = 0; i < kCount; ++i) {
+                total[i] += shard.values[i].load(std::memory_order_relaxed);
+            }
+        });
+        return total;
+    }
+
+    ThreadShards<Shard> shards_;
+    std::atomic<uint64_t> baseline_[kCount] = {};
+};
+
+// 不统计的计数策略（BasicScheduler的MetricsPolicy）：计数和延迟直方图的记录在编译期去掉，
+// 与运行时关闭SchedulerConfig::collectMetrics相比连开关判断也不执行；getPerformanceMetrics中的计数始终为0
+class NoMetrics {
+public:
+    static constexpr bool kEnabled = false;
+    static constexpr size_t kCount = MetricCounters::kCount;
+    using Values = MetricCounters::Values;
+
+    void add(Metric, uint64_t = 1) {}
+    Values snapshot() const { return {}; }
+    void reset() {}
+};
+
+} // namespace YB
+
+#endif // METRIC_COUNTERS_H
@@ -0,0 +1,314 @@
+#ifndef PARALLEL_ALGORITHMS_H
+#define PARALLEL_ALGORITHMS_H
+
+#include "TaskScheduler.h"
+#include "ThreadPool.h"
+#include "ThreadPriority.h"
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <random>
+
+namespace YB {
+
+// 并行算法使用的默认线程池（首次调用时创建，调用线程也参与计算）
+ThreadPool& defaultParallelPool();
+
+// 类似std执行策略的参数：在哪个线程池上执行、分块大小以及分块继承的优先级
+struct ParallelPolicy {
+    ThreadPool* pool = nullptr;                // 为空时使用defaultParallelPool()
+    Priority priority = currentTaskPriority(); // 默认继承当前任务的优先级
+    size_t grainSize = 16 * 1024;              // 每个分块的最少元素数
+    bool mapOsPriority = true;                 // 辅助线程按priority切换OS调度类别
+
+    ParallelPolicy() = default;
+    explicit ParallelPolicy(ThreadPool& threadPool) : pool(&threadPool) {}
+
+    ThreadPool& getPool() const { return pool ? *pool : defaultParallelPool(); }
+};
+
+namespace detail {
+
+// 把[0, numChunks)个分块分给线程池辅助线程和调用线程，调用线程等待所有分块完成；
+// 分块按原子计数器认领，迟到的辅助线程只访问共享状态，不会触及已返回的调用栈
+template<typename Body>
+void runChunks(const ParallelPolicy& policy, size_t numChunks, const Body& body) {
+    if (numChunks == 0) {
+        return;
+    }
+
+    ThreadPool& pool = policy.getPool();
+    size_t helpers = std::min(numChunks - 1, pool.getPoolSize());
+    if (helpers == 0 || pool.isStopped()) {
+        for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+            body(chunk);
+        }
+        return;
+    }
+
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> finished{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto state = std::make_shared<State>();
+
+    auto claimLoop = [state, numChunks, &body] {
+        size_t chunk;
+        while ((chunk = state->next.fetch_add(1)) < numChunks) {
+            if (!state->failed) {
+                try {
+                    body(chunk);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) {
+                        state->error = std::current_exception();
+                    }
+                    state->failed = true;
+                }
+            }
+            if (state->finished.fetch_add(1) + 1 == numChunks) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done.notify_all();
+            }
+        }
+    };
+
+    Priority priority = policy.priority;
+    bool mapOsPriority = policy.mapOsPriority;
+    for (size_t i = 0; i < helpers; ++i) {
+        pool.enqueue([state, numChunks, claimLoop, priority, mapOsPriority] {
+            if (state->next >= numChunks) {
+                return;
+            }
+            TaskPriorityScope priorityScope(priority);
+            if (mapOsPriority) {
+                applyThreadPriority(priority, false);
+            }
+            claimLoop();
+            if (mapOsPriority) {
+                resetThreadPriority();
+            }
+        });
+    }
+
+    // 调用线程也参与，保证线程池繁忙时仍能推进
+    claimLoop();
+
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&state, numChunks] { return state->finished == numChunks; });
+    }
+
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+// 元素数量对应的分块数：不少于grainSize，也不超过参与线程数的若干倍
+inline size_t chunkCount(const ParallelPolicy& policy, size_t count) {
+    size_t grain = std::max<size_t>(1, policy.grainSize);
+    size_t maxChunks = (policy.getPool().getPoolSize() + 1) * 4;
+    return std::max<size_t>(1, std::min((count + grain - 1) / grain, maxChunks));
+}
+
+} // namespace detail
+
+// 对[0, count)按分块并行调用body(begin, end)
+template<typename Body>
+void parallelFor(const ParallelPolicy& policy, size_t count, const Body& body) {
+    size_t numChunks = detail::chunkCount(policy, count);
+    detail::runChunks(policy, numChunks, [count, numChunks, &body](size_t chunk) {
+        size_t begin = count * chunk / numChunks;
+        size_t end = count * (chunk + 1) / numChunks;
+        if (begin < end) {
+            body(begin, end);
+        }
+    });
+}
+
+// 并行std::transform（要求随机访问迭代器）
+template<typename InputIt, typename OutputIt, typename UnaryOp>
+OutputIt parallelTransform(const ParallelPolicy& policy, InputIt first, InputIt last, OutputIt dFirst, UnaryOp op) {
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    parallelFor(policy, count, [first, dFirst, &op](size_t begin, size_t end) {
+        std::transform(first + begin, first + end, dFirst + begin, op);
+    });
+    return dFirst + count;
+}
+
+// 并行std::transform_reduce，reduceOp需满足结合律和交换律
+template<typename InputIt, typename T, typename ReduceOp, typename TransformOp>
+T parallelTransformReduce(const ParallelPolicy& policy, InputIt first, InputIt last, T init,
+                          ReduceOp reduceOp, TransformOp transformOp) {
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    size_t numChunks = detail::chunkCount(policy, count);
+    std::vector<std::optional<T>> partials(numChunks);
+
+    detail::runChunks(policy, numChunks, [&](size_t chunk) {
+        size_t begin = count * chunk / numChunks;
+        size_t end = count * (chunk + 1) / numChunks;
+        if (begin == end) {
+            return;
+        }
+        T accumulator = transformOp(first[begin]);
+        for (size_t i = begin + 1; i < end; ++i) {
+            accumulator = reduceOp(std::move(accumulator), transformOp(first[i]));
+        }
+        partials[chunk] = std::move(accumulator);
+    });
+
+    for (auto& partial : partials) {
+        if (partial) {
+            init = reduceOp(std::move(init), std::move(*partial));
+        }
+    }
+    return init;
+}
+
+// 并行std::reduce
+template<typename InputIt, typename T, typename ReduceOp = std::plus<>>
+T parallelReduce(const ParallelPolicy& policy, InputIt first, InputIt last, T init, ReduceOp op = ReduceOp()) {
+    return parallelTransformReduce(policy, first, last, std::move(init), op,
+        [](const auto& value) -> const auto& { return value; });
+}
+
+// 并行std::inclusive_scan：先并行求各分块之和，串行求分块偏移，再并行扫描各分块
+template<typename InputIt, typename OutputIt, typename BinaryOp = std::plus<>>
+OutputIt parallelInclusiveScan(const ParallelPolicy& policy, InputIt first, InputIt last, OutputIt dFirst,
+                               BinaryOp op = BinaryOp()) {
+    using T = typename std::iterator_traits<InputIt>::value_type;
+
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    size_t numChunks = detail::chunkCount(policy, count);
+    if (numChunks == 1) {
+        return std::inclusive_scan(first, last, dFirst, op);
+    }
+
+    auto bounds = [count, numChunks](size_t chunk) {
+        return std::make_pair(count * chunk / numChunks, count * (chunk + 1) / numChunks);
+    };
+
+    // 第一遍：各分块之和（最后一块不需要）
+    std::vector<std::optional<T>> sums(numChunks);
+    detail::runChunks(policy, numChunks - 1, [&](size_t chunk) {
+        auto [begin, end] = bounds(chunk);
+        if (begin == end) {
+            return;
+        }
+        T sum = first[begin];
+        for (size_t i = begin + 1; i < end; ++i) {
+            sum = op(std::move(sum), first[i]);
+        }
+        sums[chunk] = std::move(sum);
+    });
+
+    // 分块偏移：offsets[k]为前k块之和
+    std::vector<std::optional<T>> offsets(numChunks);
+    for (size_t chunk = 1; chunk < numChunks; ++chunk) {
+        offsets[chunk] = offsets[chunk - 1];
+        if (sums[chunk - 1]) {
+            offsets[chunk] = offsets[chunk] ? op(*offsets[chunk], *sums[chunk - 1]) : *sums[chunk - 1];
+        }
+    }
+
+    // 第二遍：带偏移扫描各分块
+    detail::runChunks(policy, numChunks, [&](size_t chunk) {
+        auto [begin, end] = bounds(chunk);
+        if (begin == end) {
+            return;
+        }
+        if (offsets[chunk]) {
+            std::inclusive_scan(first + begin, first + end, dFirst + begin, op, *offsets[chunk]);
+        } else {
+            std::inclusive_scan(first + begin, first + end, dFirst + begin, op);
+        }
+    });
+
+    return dFirst + count;
+}
+
+// 并行样本排序：抽样选出分割点，按桶分发到临时缓冲区后各桶并行std::sort
+// 元素类型需可默认构造和移动；不保证稳定性
+template<typename RandomIt, typename Compare = std::less<>>
+void parallelSort(const ParallelPolicy& policy, RandomIt first, RandomIt last, Compare comp = Compare()) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    size_t grain = std::max<size_t>(1, policy.grainSize);
+    size_t workers = policy.getPool().getPoolSize() + 1;
+    size_t numBuckets = std::min(workers * 4, count / grain);
+    if (numBuckets < 2) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // 抽样选分割点（每桶过采样32个，固定种子保证可复现）
+    const size_t oversampling = 32;
+    std::vector<T> samples;
+    samples.reserve(numBuckets * oversampling);
+    std::mt19937_64 random(count);
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    for (size_t i = 0; i < numBuckets * oversampling; ++i) {
+        samples.push_back(first[pick(random)]);
+    }
+    std::sort(samples.begin(), samples.end(), comp);
+
+    std::vector<T> splitters;
+    splitters.reserve(numBuckets - 1);
+    for (size_t i = 1; i < numBuckets; ++i) {
+        splitters.push_back(samples[i * oversampling]);
+    }
+
+    auto bucketOf = [&splitters, &comp](const T& value) {
+        return static_cast<size_t>(std::upper_bound(splitters.begin(), splitters.end(), value, comp) -
+                                   splitters.begin());
+    };
+
+    // 第一遍：各输入分块中每个桶的元素数
+    size_t numChunks = detail::chunkCount(policy, count);
+    std::vector<size_t> counts(numChunks * numBuckets, 0);
+    detail::runChunks(policy, numChunks, [&](size_t chunk) {
+        size_t* chunkCounts = &counts[chunk * numBuckets];
+        for (size_t i = count * chunk / numChunks; i < count * (chunk + 1) / numChunks; ++i) {
+            chunkCounts[bucketOf(first[i])]++;
+        }
+    });
+
+    // 按桶优先、分块其次求写入偏移，同一桶内保持分块顺序
+    std::vector<size_t> bucketBegin(numBuckets + 1, 0);
+    size_t offset = 0;
+    for (size_t bucket = 0; bucket < numBuckets; ++bucket) {
+        bucketBegin[bucket] = offset;
+        for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+            size_t n = counts[chunk * numBuckets + bucket];
+            counts[chunk * numBuckets + bucket] = offset;
+            offset += n;
+        }
+    }
+    bucketBegin[numBuckets] = offset;
+
+    // 第二遍：重新分类并移动到临时缓冲区（不保存桶编号，避免额外的O(n)内存）
+    std::vector<T> buffer(count);
+    detail::runChunks(policy, numChunks, [&](size_t chunk) {
+        size_t* cursor = &counts[chunk * numBuckets];
+        for (size_t i = count * chunk / numChunks; i < count * (chunk + 1) / numChunks; ++i) {
+            buffer[cursor[bucketOf(first[i])]++] = std::move(first[i]);
+        }
+    });
+
+    // 各桶排序后移回原区间
+    detail::runChunks(policy, numBuckets, [&](size_t bucket) {
+        auto begin = buffer.begin() + bucketBegin[bucket];
+        auto end = buffer.begin() + bucketBegin[bucket + 1];
+        std::sort(begin, end, comp);
+        std::move(begin, end, first + bucketBegin[bucket]);
+    });
+}
+
+} // namespace YB
+
+#endif // PARALLEL_ALGORITHMS_H
@@ -2,37 +2,100 @@
 #define PRIORITY_QUEUE_H
 
 #include <queue>
+#include <deque>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
 #include <memory>
 #include <atomic>
 #include <functional>
+#include <unordered_set>
 #include "TaskScheduler.h"
 
 namespace YB {
 
-class PriorityQueue {
+// 带专用条件变量的等待者：入队和wakeOne只唤醒一个等待者，wake可以唤醒指定的等待者而不惊动其他线程
+struct QueueWaiter {
+    std::condition_variable condition;
+    bool signaled = false;  // 以下受队列锁保护
+    bool waiting = false;
+};
+
+// 出队顺序：按优先级出队，同一优先级内按提交顺序（二叉堆）
+class HeapOrder {
+public:
+    void push(std::shared_ptr<Task> task) { heap_.push(std::move(task)); }
+    const std::shared_ptr<Task>& top() const { return heap_.top(); }
+    void pop() { heap_.pop(); }
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+    // 用一组任务整体重建，O(n)
+    void assign(std::vector<std::shared_ptr<Task>> tasks) {
+        heap_ = std::priority_queue<std::shared_ptr<Task>, std::vector<std::shared_ptr<Task>>, TaskComparator>(
+            TaskComparator(), std::move(tasks));
+    }
+    
+private:
+    std::priority_queue<std::shared_ptr<Task>, std::vector<std::shared_ptr<Task>>, TaskComparator> heap_;
+};
+
+// 出队顺序：忽略优先级，按入队顺序，入队出队均为O(1)；适合只有一种优先级的组件
+class FifoOrder {
+public:
+    void push(std::shared_ptr<Task> task) { items_.push_back(std::move(task)); }
+    const std::shared_ptr<Task>& top() const { return items_.front(); }
+    void pop() { items_.pop_front(); }
+    bool empty() const { return items_.empty(); }
+    size_t size() const { return items_.size(); }
+    void assign(std::vector<std::shared_ptr<Task>> tasks) {
+        items_.assign(std::make_move_iterator(tasks.begin()), std::make_move_iterator(tasks.end()));
+    }
+    
+private:
+    std::deque<std::shared_ptr<Task>> items_;
+};
+
+// 任务队列，Order决定出队顺序（HeapOrder或FifoOrder），在PriorityQueue.cpp中显式实例化；
+// PriorityQueue和FifoQueue两个别名见TaskScheduler.h
+template<typename Order>
+class TaskQueue {
 public:
-    PriorityQueue();
-    ~PriorityQueue();
+    using Waiter = QueueWaiter;
+    
+    TaskQueue();
+    ~TaskQueue();
     
     // 禁用拷贝构造和拷贝赋值
-    PriorityQueue(const PriorityQueue&) = delete;
-    PriorityQueue& operator=(const PriorityQueue&) = delete;
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
     
     // 添加任务到队列
     void push(std::shared_ptr<Task> task);
     
+    // 一次加锁添加一批任务
+    void pushBatch(const std::vector<std::shared_ptr<Task>>& tasks);
+    
     // 从队列取出最高优先级任务（阻塞直到有任务）
     std::shared_ptr<Task> pop();
     
+    // 阻塞直到有任务、停止或被唤醒（以调用方先前取得的唤醒序号为准），后两种情况返回空
+    std::shared_ptr<Task> pop(uint64_t wakeEpoch);
+    
+    // 同上，在waiter自己的条件变量上等待，还会被wake(waiter)唤醒（唤醒早于进入等待时同样立即返回）
+    std::shared_ptr<Task> pop(uint64_t wakeEpoch, Waiter& waiter);
+    
     // 尝试从队列取出任务（非阻塞）
     std::shared_ptr<Task> tryPop();
     
-    // 带超时的pop
+    // 带超时的pop，被wakeAll/wakeOne唤醒时提前返回空
     std::shared_ptr<Task> popWithTimeout(std::chrono::milliseconds timeout);
     
+    // 同上，但以调用方先前取得的唤醒序号为准，取序号之后的唤醒不会丢失
+    std::shared_ptr<Task> popWithTimeout(std::chrono::milliseconds timeout, uint64_t wakeEpoch);
+    
+    // 当前唤醒序号，每次wakeAll/wakeOne加一
+    uint64_t wakeEpoch() const;
+    
     // 检查队列是否为空
     bool empty() const;
     
@@ -45,6 +108,15 @@ public:
     // 停止队列（唤醒所有等待的线程）
     void stop();
     
+    // 唤醒所有等待出队的线程（不停止队列）
+    void wakeAll();
+    
+    // 唤醒一个等待出队的线程
+    void wakeOne();
+    
+    // 只唤醒指定的等待者
+    void wake(Waiter& waiter);
+    
     // 恢复队列
     void resume();
     
@@ -57,29 +129,37 @@ public:
     // 移除指定ID的任务
     bool removeTask(TaskID taskId);
     
+    // 一次遍历移除一组任务，返回实际移除的任务
+    std::vector<std::shared_ptr<Task>> removeTasks(const std::unordered_set<TaskID>& taskIds);
+    
     // 获取队列中所有任务ID
     std::vector<TaskID> getAllTaskIds() const;
     
 private:
-    // 内部优先级队列
-    std::priority_queue<std::shared_ptr<Task>, 
-                       std::vector<std::shared_ptr<Task>>, 
-                       TaskComparator> queue_;
+    // 内部队列
+    Order queue_;
     
     // 同步相关
     mutable std::mutex mutex_;
     std::condition_variable notEmpty_;
+    std::vector<Waiter*> waiters_;  // 正在等待、尚未被唤醒的等待者，最近开始等待的在末尾
     
     // 状态控制
     std::atomic<bool> stopped_;
+    uint64_t wakeEpoch_ = 0;  // 受mutex_保护
     
     // 任务计数（按优先级）
     mutable std::map<Priority, size_t> priorityCount_;
     
     // 辅助函数
     void updatePriorityCount(Priority priority, int delta);
+    void notifyOneLocked();
+    void notifyAllLocked();
 };
 
+extern template class TaskQueue<HeapOrder>;
+extern template class TaskQueue<FifoOrder>;
+
 } // namespace YB
 
 #endif // PRIORITY_QUEUE_H
\ No newline at end of file
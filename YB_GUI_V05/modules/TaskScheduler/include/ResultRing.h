@@ -0,0 +1,91 @@
+#ifndef RESULT_RING_H
+#define RESULT_RING_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <functional>
+#include "TaskScheduler.h"
+#include "SpinLock.h"
+
+namespace YB {
+
+// 完成结果环：容量固定（向上取2的幂），每个结果带全局递增的序号，写满后覆盖最早的结果，淘汰为O(1)。
+// 结果以只读的共享指针放在槽位中，槽位上记有结果的序号和任务ID，读取方先据此跳过已被覆盖或不相符的槽位。
+// 复制和替换槽位中的指针由各槽位自己的自旋锁保护，只在复制指针期间持有（不使用libstdc++为
+// std::atomic_load<shared_ptr>准备的全局锁池）；写入方只与正在读同一槽位的读取方竞争，
+// 回调在不持有任何锁时执行。被覆盖的结果交还给写入方，由其在释放自己的锁后销毁
+class ResultRing {
+public:
+    explicit ResultRing(size_t capacity);
+
+    ResultRing(const ResultRing&) = delete;
+    ResultRing& operator=(const ResultRing&) = delete;
+
+    // 追加一个结果，返回被覆盖的结果（没有时为空），调用方应在释放自己的锁后再销毁它。
+    // 写入方之间由调用方串行化（调度器的statusMutex_）
+    std::shared_ptr<const void> push(TaskResult result);
+
+    // 从cursor起按完成顺序读取最多maxResults个结果，cursor前进到最后读到的结果之后。
+    // 落后超过容量（或读取期间被覆盖）的结果跳过并计入cursor.missed；clear之前的结果直接跳过
+    size_t read(ResultCursor& cursor, const std::function<void(const TaskResult&)>& callback,
+                size_t maxResults) const;
+
+    // 按ID查找仍在环中的结果（从最新的开始），找不到时返回空
+    std::shared_ptr<const TaskResult> find(TaskID id) const;
+
+    // 按完成顺序复制环中的全部结果
+    std::vector<TaskResult> snapshot() const;
+
+    // 丢弃环中的全部结果，之后的读取从下一个结果开始；返回被丢弃的结果，由调用方在锁外销毁。
+    // 调用方与push串行化
+    std::vector<std::shared_ptr<const void>> clear();
+
+    uint64_t head() const;      // 下一个结果的序号
+    size_t capacity() const;
+
+    // 请求的容量实际对应的环容量
+    static size_t capacityFor(size_t requested);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};      // 槽位中结果的序号 + 1（0表示空），加锁前据此跳过已被覆盖的槽位
+        std::atomic<TaskID> id{0};              // 槽位中结果的任务ID，find只在ID相符时加锁读取
+        mutable SpinLock lock;                  // 保护result的复制和替换
+        std::shared_ptr<const TaskResult> result;
+    };
+
+    // 取出序号为sequence的结果；槽位已清空时返回空，已被覆盖时另置overwritten
+    std::shared_ptr<const TaskResult> load(uint64_t sequence, bool* overwritten = nullptr) const;
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_;
+    size_t mask_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> floor_{0};    // clear时的head，之前的结果视为不存在
+};
+
+// 不保留完成结果的结果策略（BasicScheduler的ResultPolicy），接口与ResultRing相同：
+// 写入直接丢弃，读取和查找总是为空。waitForTask只按状态返回结果，
+// getCompletedTasks等读取不到结果；登记时前驱已完成的数据流任务取不到输入，按依赖失败处理
+class NoResults {
+public:
+    explicit NoResults(size_t) {}
+
+    NoResults(const NoResults&) = delete;
+    NoResults& operator=(const NoResults&) = delete;
+
+    std::shared_ptr<const void> push(TaskResult) { return nullptr; }
+    size_t read(ResultCursor&, const std::function<void(const TaskResult&)>&, size_t) const { return 0; }
+    std::shared_ptr<const TaskResult> find(TaskID) const { return nullptr; }
+    std::vector<TaskResult> snapshot() const { return {}; }
+    std::vector<std::shared_ptr<const void>> clear() { return {}; }
+    uint64_t head() const { return 0; }
+    size_t capacity() const { return 0; }
+
+    static size_t capacityFor(size_t) { return 0; }
+};
+
+} // namespace YB
+
+#endif // RESULT_RING_H
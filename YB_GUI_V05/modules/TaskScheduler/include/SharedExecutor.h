@@ -0,0 +1,101 @@
+#ifndef SHARED_EXECUTOR_H
+#define SHARED_EXECUTOR_H
+
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace YB {
+
+class ThreadPool;
+
+// 共享执行器运行统计
+struct ExecutorMetrics {
+    size_t maxThreads = 0;            // 全局线程上限
+    size_t poolThreads = 0;           // 执行器线程池当前大小
+    size_t processPoolThreads = 0;    // 进程内所有ThreadPool的线程总数
+    size_t hardwareConcurrency = 0;
+    double oversubscription = 0.0;    // processPoolThreads / hardwareConcurrency
+    size_t attachedSources = 0;
+    size_t tasksExecuted = 0;
+    std::vector<std::pair<std::string, size_t>> tasksPerSource;  // 各调度器执行的任务数
+};
+
+// 进程级共享执行器：多个TaskScheduler挂接到同一组工作线程上，
+// 各调度器保留自己的队列、优先级和指标，执行器在它们之间轮转取任务
+class SharedExecutor {
+public:
+    using SourceId = uint64_t;
+
+    explicit SharedExecutor(size_t maxThreads = std::thread::hardware_concurrency());
+    ~SharedExecutor();
+
+    SharedExecutor(const SharedExecutor&) = delete;
+    SharedExecutor& operator=(const SharedExecutor&) = delete;
+
+    // 进程默认的共享执行器（首次调用时创建）
+    static std::shared_ptr<SharedExecutor> processDefault();
+
+    // 挂接任务来源：runOne取出并执行一个任务，没有可执行任务时返回false
+    SourceId attach(const std::string& name, std::function<bool()> runOne);
+
+    // 解除挂接，等待该来源正在执行的任务结束
+    void detach(SourceId id);
+
+    // 通知执行器有新任务
+    void notify();
+
+    // 获取运行统计
+    ExecutorMetrics getMetrics() const;
+
+    // 获取执行器的线程池
+    ThreadPool& getThreadPool();
+
+    // 停止执行器
+    void stop();
+
+private:
+    struct Source {
+        SourceId id = 0;
+        std::string name;
+        std::function<bool()> runOne;
+        std::atomic<bool> detached{false};
+        std::atomic<size_t> activeRuns{0};
+        std::atomic<size_t> tasksExecuted{0};
+    };
+
+    // 工作线程循环
+    void workerLoop();
+
+    // 从cursor开始轮转尝试各来源，执行一个任务
+    bool runOneTask(const std::vector<std::shared_ptr<Source>>& sources);
+
+    std::unique_ptr<ThreadPool> threadPool_;
+    size_t maxThreads_;
+
+    // 来源列表（写时复制，工作线程按版本号刷新本地快照）
+    mutable std::mutex sourcesMutex_;
+    std::shared_ptr<const std::vector<std::shared_ptr<Source>>> sources_;
+    std::atomic<uint64_t> sourcesVersion_;
+    SourceId nextSourceId_;
+    std::condition_variable detachCondition_;
+
+    // 空闲等待
+    std::mutex idleMutex_;
+    std::condition_variable idleCondition_;
+    std::atomic<uint64_t> notifyGeneration_;
+    size_t idleWorkers_;
+
+    std::atomic<size_t> cursor_;
+    std::atomic<bool> stop_;
+    std::atomic<size_t> tasksExecuted_;
+};
+
+} // namespace YB
+
+#endif // SHARED_EXECUTOR_H
@@ -0,0 +1,35 @@
+#ifndef SPIN_LOCK_H
+#define SPIN_LOCK_H
+
+#include <atomic>
+#include <thread>
+
+namespace YB {
+
+// 自旋锁（满足Lockable）：临界区只有几条指令时省去futex系统调用；
+// 自旋一段时间后让出CPU，持有者被抢占时仍能前进
+class SpinLock {
+public:
+    void lock() {
+        while (locked_.exchange(true, std::memory_order_acquire)) {
+            for (int spins = 0; locked_.load(std::memory_order_relaxed); ++spins) {
+                if (spins >= 64) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    bool try_lock() {
+        return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() { locked_.store(false, std::memory_order_release); }
+
+private:
+    std::atomic<bool> locked_{false};
+};
+
+} // namespace YB
+
+#endif // SPIN_LOCK_H
@@ -0,0 +1,62 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <vector>
+
+namespace YB {
+
+// 单生产者单消费者环形缓冲区，不加锁；容量向上取整为2的幂。
+// 同一时刻只能有一个线程调用tryPush、一个线程调用drainTo（消费方可以轮换，由调用方串行化）
+template<typename Item>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // 生产者：已满时返回false，item保持不变
+    bool tryPush(Item& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+            return false;
+        }
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：按写入顺序取出当前全部元素追加到out，返回取出的个数
+    size_t drainTo(std::vector<Item>& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        for (size_t i = head; i != tail; ++i) {
+            out.push_back(std::move(slots_[i & mask_]));
+        }
+        head_.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+
+    // 尚未取出的元素数（并发读写时为近似值）
+    size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    std::vector<Item> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};   // 消费位置
+    alignas(64) std::atomic<size_t> tail_{0};   // 生产位置
+};
+
+} // namespace YB
+
+#endif // SPSC_RING_H
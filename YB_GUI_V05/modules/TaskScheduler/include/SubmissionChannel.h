@@ -0,0 +1,52 @@
+#ifndef SUBMISSION_CHANNEL_H
+#define SUBMISSION_CHANNEL_H
+
+#include "TaskScheduler.h"
+#include "SpscRing.h"
+
+namespace YB {
+
+// 单生产者提交通道：供一个专用线程（如GUI主线程）提交短任务。
+// submit分配任务ID后写入环形缓冲区，由工作线程批量取出后登记和入队，登记和入队的开销不在生产者上。
+// 提交不是无等待的：分配记录槽位用CAS，与其他线程并发提交或回收时可能重试；
+// 有空闲的工作线程（或共享执行器）时要获取队列的锁来唤醒它，可能等待持锁的线程。
+// 工作线程都在忙时不获取任何锁。同一线程经通道和submitTask提交的任务保持提交顺序。通道必须在调度器销毁前析构
+class SubmissionChannel {
+public:
+    // capacity向上取整为2的幂
+    explicit SubmissionChannel(TaskScheduler& scheduler, size_t capacity = 1024);
+    ~SubmissionChannel();
+
+    SubmissionChannel(const SubmissionChannel&) = delete;
+    SubmissionChannel& operator=(const SubmissionChannel&) = delete;
+
+    // 提交任务，调度器未运行或已暂停时返回0；
+    // 缓冲区已满时在当前线程上先取出已提交的任务再入队（慢路径，计入overflowCount）
+    TaskID submit(TaskType type, Priority priority, std::function<TaskResult()> function);
+    TaskID submit(std::shared_ptr<Task> task);
+
+    size_t capacity() const { return ring_.capacity(); }
+
+    // 尚未被取出的任务数（近似值）
+    size_t pending() const;
+
+    // 缓冲区满走慢路径的次数
+    size_t overflowCount() const { return overflows_.load(); }
+
+private:
+    template<typename, typename, typename, typename> friend class BasicScheduler;
+
+    // 生产者：写入缓冲区，已满时返回false
+    bool tryPush(std::shared_ptr<Task>& task);
+
+    // 消费者：按提交顺序取出所有任务（调用方持有调度器的通道锁，保证只有一个消费者）
+    void drainTo(std::vector<std::shared_ptr<Task>>& out);
+
+    TaskScheduler& scheduler_;
+    SpscRing<std::shared_ptr<Task>> ring_;
+    alignas(64) std::atomic<size_t> overflows_{0};
+};
+
+} // namespace YB
+
+#endif // SUBMISSION_CHANNEL_H
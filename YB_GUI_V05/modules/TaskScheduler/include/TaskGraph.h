@@ -0,0 +1,141 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include "TaskScheduler.h"
+
+namespace YB {
+
+// 任务图统计（各次run累计）
+struct TaskGraphStats {
+    size_t runs = 0;
+    size_t nodesRun = 0;            // 执行的节点数（增量模式下即重新计算的节点）
+    size_t nodesReused = 0;         // 增量模式下输入未变、复用上次结果而未执行的节点数
+    size_t nodesSkipped = 0;        // 因前驱失败而跳过的节点数
+    size_t lastRunNodesRun = 0;
+    size_t lastRunNodesReused = 0;
+};
+
+// 预建任务图：构建一次后反复run。节点、邻接表（CSR）、计数器和节点任务对象在构建后复用，
+// 每次运行不分配TaskID、不登记状态和结果、不构造依赖列表；节点按拓扑顺序在调度器的工作线程上执行，
+// 节点结束时递减后继的计数，减到0的后继由本线程直接接着执行一个，其余入队。
+// 节点抛出异常时其（间接）后继被跳过，其余节点照常执行。
+// 增量模式下只执行输入改变的节点及其下游，其余节点复用上次的输出
+class TaskGraph {
+public:
+    using NodeID = size_t;
+    using NodeFunction = std::function<void(const std::any& params)>;
+    // 带输出的节点：inputs为各前驱的输出，顺序与addEdge的调用顺序一致
+    using ValueFunction = std::function<std::any(const std::any& params, const std::vector<const std::any*>& inputs)>;
+
+    explicit TaskGraph(TaskScheduler& scheduler);
+    ~TaskGraph();
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // 构建：添加节点，返回节点编号；不能与run并发调用
+    NodeID addNode(NodeFunction function, Priority priority = Priority::NORMAL);
+
+    // 构建：添加带输出的节点，输出保存在图中，供后继作为输入和run之后读取
+    NodeID addValueNode(ValueFunction function, Priority priority = Priority::NORMAL);
+
+    // 构建：from先于to执行，编号无效或from == to时返回false
+    bool addEdge(NodeID from, NodeID to);
+
+    // 执行一次并等待所有节点结束，params传给每个节点；同一图的多次run依次执行。
+    // 在调度器任务中调用时帮忙执行排队任务。有节点失败或被取消、图中有环、调度器未运行时返回false
+    bool run(std::any params = {});
+
+    // 最近一次run的第一个错误
+    std::string lastError() const;
+
+    // 增量模式（默认关闭，每次run执行所有节点）：只执行输入指纹改变、上次未成功执行或被invalidate的节点
+    // 及其全部下游，彼此独立的脏节点并行释放；其余节点不入队，保留上次的输出
+    void setIncremental(bool enabled);
+
+    // 节点外部输入的指纹（如数据分区的版本或内容哈希），与上次执行时不同则该节点变脏；不能与run并发调用
+    void setFingerprint(NodeID node, uint64_t fingerprint);
+
+    // 下一次run重新执行该节点及其下游
+    void invalidate(NodeID node);
+
+    // 带输出节点最近一次执行的输出，在run返回后读取
+    const std::any& output(NodeID node) const;
+
+    TaskGraphStats getStats() const;
+
+    size_t size() const { return nodes_.size(); }
+
+private:
+    static constexpr NodeID kNoNode = static_cast<NodeID>(-1);
+
+    struct Node {
+        NodeFunction function;
+        ValueFunction valueFunction;
+        std::shared_ptr<Task> task;           // 入队用的节点任务，各次运行复用
+        std::vector<NodeID> successors;       // 构建时的邻接表
+        std::vector<NodeID> predecessors;     // 按addEdge顺序，对应inputs
+        std::vector<const std::any*> inputs;  // 前驱输出的地址，prepare时生成
+        std::any output;
+        uint64_t fingerprint = 0;
+        uint64_t executedFingerprint = 0;     // 上次成功执行时的指纹
+        bool valid = false;                   // 上次执行成功且此后未被invalidate
+    };
+
+    // 每次运行重置的计数
+    struct NodeState {
+        std::atomic<size_t> remaining{0};     // 尚未结束的前驱数
+        std::atomic<bool> skipped{false};     // 有前驱失败或被跳过
+    };
+
+    NodeID addTaskNode(Node node, Priority priority);
+
+    // 首次运行或图改变后生成CSR邻接表和入度，检查是否有环
+    bool prepare();
+
+    // 增量模式：从脏节点出发收集本次要执行的节点，按其中的前驱设置计数
+    void collectDirtyNodes();
+
+    // 在当前线程上执行节点，并接着执行由它释放的一个后继
+    void runNode(NodeID index);
+
+    // 节点结束：递减后继计数，入队就绪的后继；返回可由本线程接着执行的后继
+    NodeID finishNode(NodeID index, bool succeeded);
+
+    void recordError(const std::string& error);
+
+    TaskScheduler& scheduler_;
+    std::vector<Node> nodes_;
+    bool prepared_ = false;
+
+    // CSR邻接表：节点i的后继为successorIndex_[successorOffset_[i], successorOffset_[i + 1])
+    std::vector<size_t> successorOffset_;
+    std::vector<NodeID> successorIndex_;
+    std::vector<size_t> indegree_;
+    std::vector<NodeID> roots_;
+    std::unique_ptr<NodeState[]> states_;
+
+    // 增量模式：本次执行的节点和其中入度为0的节点，inRun_标记节点是否已收集
+    bool incremental_ = false;
+    std::vector<NodeID> runNodes_;
+    std::vector<NodeID> runRoots_;
+    std::vector<char> inRun_;
+
+    // 当前运行
+    std::mutex runMutex_;
+    std::any params_;
+    std::atomic<size_t> pending_{0};          // 尚未结束的节点数
+    std::atomic<bool> failed_{false};
+    std::atomic<size_t> nodesRun_{0};
+    std::atomic<size_t> nodesSkipped_{0};
+
+    mutable std::mutex mutex_;
+    std::condition_variable finished_;
+    bool running_ = false;
+    std::string error_;
+    TaskGraphStats stats_;
+};
+
+} // namespace YB
+
+#endif // TASK_GRAPH_H
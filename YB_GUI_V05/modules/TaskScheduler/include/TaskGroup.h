@@ -0,0 +1,60 @@
+#ifndef TASK_GROUP_H
+#define TASK_GROUP_H
+
+#include "TaskScheduler.h"
+
+namespace YB {
+
+// 任务组统计
+struct TaskGroupStats {
+    size_t submitted = 0;
+    size_t completed = 0;
+    size_t failed = 0;
+    size_t cancelled = 0;
+    size_t pending = 0;                                    // 尚未结束的任务数
+    std::chrono::milliseconds totalExecutionTime{0};       // 各任务执行时间之和
+    std::chrono::milliseconds wallTime{0};                 // 首个任务提交到最后一个任务结束
+    double throughput = 0.0;                               // 每秒结束的任务数
+};
+
+// 结构化任务组：一批相关任务共享完成计数，wait()每个任务结束只需O(1)计数，
+// 不再逐个轮询getTaskStatus；析构时等待所有任务结束
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // 向组内提交任务，失败时返回0
+    TaskID run(TaskType type, Priority priority, std::function<TaskResult()> function);
+    TaskID run(std::shared_ptr<Task> task);
+
+    // 等待组内所有任务结束；在调度器任务中调用时帮忙执行排队任务
+    void wait();
+
+    // 带超时的等待，超时返回false
+    bool waitFor(std::chrono::milliseconds timeout);
+
+    // 一次队列遍历取消组内所有仍在排队的任务，返回取消的数量
+    size_t cancelAll();
+
+    TaskGroupStats getStats() const;
+
+private:
+    void onTaskComplete(const TaskResult& result);
+
+    TaskScheduler& scheduler_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable done_;
+    std::vector<TaskID> members_;
+    TaskGroupStats stats_;
+    std::chrono::steady_clock::time_point firstSubmit_;
+    std::chrono::steady_clock::time_point lastCompletion_;
+};
+
+} // namespace YB
+
+#endif // TASK_GROUP_H
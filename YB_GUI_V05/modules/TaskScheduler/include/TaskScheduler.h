@@ -17,16 +17,48 @@
 #include <exception>
 #include <string>
 #include <any>
+#include <optional>
+#include <variant>
+#include <type_traits>
+#include <stdexcept>
+#include <cstdint>
+#include "SpinLock.h"
 
 namespace YB {
 
 // 前向声明
 class ThreadPool;
-class PriorityQueue;
+template<typename Order> class TaskQueue;
+class HeapOrder;
+class FifoOrder;
+class TaskTable;
+class ResultRing;
+class NoResults;
+class DeadlineHeap;
+class LatencyRecorder;
+class MetricCounters;
+class NoMetrics;
+enum class Metric : size_t;
+class FiberRuntime;
+class SharedExecutor;
+class SubmissionChannel;
+struct GangState;
+struct WorkerContextSlots;
+template<typename Queue> struct AffinitySlot;
+struct SubmitCombiner;
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy> class BasicScheduler;
 class PerformanceMonitor;
-class TaskTimeoutManager;
 class Logger;
 
+// 按优先级出队的任务队列，以及忽略优先级、按入队顺序出队的任务队列（见PriorityQueue.h）
+using PriorityQueue = TaskQueue<HeapOrder>;
+using FifoQueue = TaskQueue<FifoOrder>;
+
+// 默认的调度器：全部功能，见BasicScheduler
+using TaskScheduler = BasicScheduler<PriorityQueue, std::mutex, ResultRing, MetricCounters>;
+
+template<typename T, typename Scheduler = TaskScheduler> class TaskHandle;
+
 // 类型定义
 using TaskID = uint64_t;
 
@@ -63,6 +95,13 @@ enum class ResultStatus {
     CANCELLED
 };
 
+// 队列达到maxQueueSize时的处理方式
+enum class RejectionPolicy {
+    UNBOUNDED,      // 不限制队列长度
+    REJECT,         // 拒绝提交，返回无效任务ID
+    CALLER_RUNS     // 在提交线程上直接执行，形成自然背压
+};
+
 enum class LoadBalancingStrategy {
     ROUND_ROBIN,
     LEAST_LOADED,
@@ -72,40 +111,97 @@ enum class LoadBalancingStrategy {
 
 // 结构体定义
 struct TaskResult {
-    TaskID taskId;
-    ResultStatus status;
+    TaskID taskId = 0;
+    ResultStatus status = ResultStatus::SUCCESS;
     std::any result;
     std::string errorMessage;
-    std::chrono::milliseconds executionTime;
+    std::chrono::milliseconds executionTime{0};
     std::chrono::steady_clock::time_point completionTime;
+    bool forwarded = false;     // 结果值已移交给数据流后继，这里只保留状态
     
     TaskResult() = default;
     TaskResult(TaskID id, ResultStatus s) : taskId(id), status(s) {}
 };
 
+// 完成结果的读取位置：每个读取方各持有一个，每次只读到上次读取之后完成的结果
+struct ResultCursor {
+    uint64_t next = 0;      // 下一个要读的结果序号
+    uint64_t missed = 0;    // 读取方落后超过结果环容量、被覆盖而没有读到的结果数
+};
+
+// 数据流中传递的大块数据（如图像缓冲区）放在引用计数的句柄里作为结果，任务之间只传递指针；
+// 接收方持有唯一引用（use_count() == 1）时可以就地修改后作为自己的结果传下去
+template<typename T>
+using DataHandle = std::shared_ptr<T>;
+
 struct Task {
-    TaskID id;
+    TaskID id = 0;
     TaskType type;
     Priority priority;
     std::function<TaskResult()> function;
-    std::chrono::milliseconds timeout;
+    // 执行时限（从开始执行起算）与排队时限（从submitTime起算，含等待依赖的时间），max()表示不限；
+    // 执行时限为max()时使用SchedulerConfig::defaultTimeout（默认同样不限），不设时限的任务不进入超时堆。
+    // 排队超时的任务不再执行；执行超时的任务无法中止，状态和结果立即变为TIMEOUT，
+    // 任务可用TaskScheduler::currentTaskTimedOut()检查后提前结束
+    std::chrono::milliseconds timeout = std::chrono::milliseconds::max();
+    std::chrono::milliseconds queueTimeout = std::chrono::milliseconds::max();
     std::chrono::steady_clock::time_point submitTime;
     std::unordered_map<std::string, std::any> parameters;
-    std::vector<TaskID> dependencies;
+    std::vector<TaskID> dependencies;  // 前驱任务全部成功完成后才入队；任一前驱失败或取消时本任务被取消
+    bool runOnFiber = false;  // 在纤程上执行，可使用FiberMutex/FiberCondVar等待而不占用线程
+    std::function<void(const TaskResult&)> onComplete;  // 任务结束（完成、失败或取消）时调用一次
+    uint64_t affinityKey = 0;  // 非0时优先在该键对应的工作线程上执行，访问同一数据的任务共享缓存
+    bool detached = false;     // 不登记状态和结果，由入队方自己跟踪完成（TaskGraph的节点）
+    bool dataflow = false;     // 数据流任务：前驱的结果在前驱完成时放入inputs中与dependencies对应的位置
+    std::vector<std::any> inputs;
+    
+    // 依赖调度状态（由调度器维护）：尚未结束的前驱数，以及本任务结束时需要通知的后继（受状态锁保护）
+    std::atomic<size_t> remainingDependencies{0};
+    std::vector<std::shared_ptr<Task>> successors;
+    
+    // 超时状态（由调度器维护）：在超时堆中的位置（-1表示没有），以及是否已执行超时
+    size_t deadlineSlot = static_cast<size_t>(-1);
+    std::atomic<bool> expired{false};
+    
+    // 仍在队列中时已结束排队（被等待方认领在调用线程上执行，或排队超时；受状态锁保护）：
+    // 队列中的旧条目出队时跳过，在此之前不计入排队任务数
+    bool staleQueueEntry = false;
     
     Task() = default;
     Task(TaskID taskId, TaskType taskType, Priority prio, std::function<TaskResult()> func)
         : id(taskId), type(taskType), priority(prio), function(std::move(func)),
-          timeout(std::chrono::milliseconds(30000)),
           submitTime(std::chrono::steady_clock::now()) {}
 };
 
+// 工作线程上下文（如模型会话、临时缓冲区）：按TaskType注册工厂，
+// 每个工作线程首次执行该类型的上下文任务时创建，之后由该线程上的同类任务复用，线程退出时销毁
+class WorkerContext {
+public:
+    virtual ~WorkerContext() = default;
+};
+
+using WorkerContextFactory = std::function<std::unique_ptr<WorkerContext>()>;
+
 struct PerformanceMetrics {
     size_t totalTasksSubmitted = 0;
     size_t totalTasksCompleted = 0;
     size_t totalTasksFailed = 0;
+    size_t totalTasksRunInline = 0;     // 在调用线程上执行的任务数（submitAndWait/waitForTask/CALLER_RUNS）
+    size_t totalTasksRejected = 0;      // 因队列已满被拒绝的任务数
+    size_t totalTasksTimedOut = 0;      // 排队或执行超过时限的任务数
+    size_t totalGangsRun = 0;           // 已集结执行的gang任务数
+    double averageGangWaitTime = 0.0;   // gang从提交到N个线程集结完成的平均时间（毫秒）
+    double maxGangWaitTime = 0.0;       // gang集结等待的最长时间（毫秒）
+    size_t totalWorkerContextsCreated = 0;  // 工作线程上下文的创建次数
+    size_t totalAffinityTasks = 0;      // 工作线程执行的带亲和键任务数
+    size_t affinityLocalHits = 0;       // 其中在首选工作线程上执行的任务数
+    size_t totalAffinitySteals = 0;     // 因积压超过阈值被其他线程窃取的任务数
+    double affinityHitRate = 0.0;       // 局部性命中率：affinityLocalHits / totalAffinityTasks
+    size_t totalSubmitBatches = 0;      // 批量登记的批次数（合并提交和提交通道）
+    size_t taskRecordSlots = 0;         // 任务记录表已分配的槽位数（活跃任务与保留的已结束记录的峰值）
+    size_t retainedTaskRecords = 0;     // 保留的已结束任务记录数
     double averageExecutionTime = 0.0;
-    double averageWaitTime = 0.0;
+    double averageWaitTime = 0.0;       // 提交到开始执行的平均等待时间（毫秒，由排队等待直方图估算）
     size_t currentActiveThreads = 0;
     size_t currentQueueSize = 0;
     double cpuUsage = 0.0;
@@ -120,11 +216,76 @@ struct QueueStatus {
     std::map<Priority, size_t> priorityDistribution;
 };
 
+// 任务延迟的种类：排队等待（提交到开始执行）、执行时间、端到端（提交到执行结束）
+enum class LatencyKind {
+    QUEUE_WAIT,
+    EXECUTION,
+    END_TO_END
+};
+
+// 延迟分布（HDR直方图的快照）：纳秒值按2的幂分段，每段再分16个等宽子桶，桶宽不超过桶下界的1/16，
+// 分位数的相对误差不超过6.25%。不同优先级、任务类型的分布按桶相加合并
+class LatencyDistribution {
+public:
+    static constexpr unsigned kSubBucketBits = 4;
+    static constexpr unsigned kMaxValueBits = 42;    // 超过约73分钟的值计入最后一个桶
+    static constexpr size_t kBucketCount = size_t(kMaxValueBits - kSubBucketBits + 1) << kSubBucketBits;
+
+    static size_t bucketIndex(uint64_t nanos);
+    static uint64_t bucketLowerBound(size_t index);
+    static uint64_t bucketUpperBound(size_t index);
+
+    LatencyDistribution() : buckets(kBucketCount, 0) {}
+
+    uint64_t count() const;
+    // 以下均为毫秒：分位数取所在桶的上界（percent为0~100，如99.9），平均值按桶中点估算
+    double percentile(double percent) const;
+    double mean() const;
+    double max() const;
+
+    void merge(const LatencyDistribution& other);
+
+    std::vector<uint64_t> buckets;
+};
+
+inline size_t LatencyDistribution::bucketIndex(uint64_t nanos) {
+    const uint64_t limit = (uint64_t(1) << kMaxValueBits) - 1;
+    if (nanos > limit) {
+        nanos = limit;
+    }
+    if (nanos < (uint64_t(1) << kSubBucketBits)) {
+        return static_cast<size_t>(nanos);
+    }
+    unsigned shift = 63 - static_cast<unsigned>(__builtin_clzll(nanos)) - kSubBucketBits;
+    return (size_t(shift + 1) << kSubBucketBits) + static_cast<size_t>((nanos >> shift) - (uint64_t(1) << kSubBucketBits));
+}
+
 struct SchedulerConfig {
     size_t minThreads = 2;
     size_t maxThreads = 16;
     size_t maxQueueSize = 1000;
-    std::chrono::milliseconds defaultTimeout = std::chrono::milliseconds(30000);
+    RejectionPolicy rejectionPolicy = RejectionPolicy::UNBOUNDED;  // 队列已满时的处理方式
+    size_t maxCompensationThreads = 8;  // 任务进入BlockingScope时可临时补偿的线程上限
+    bool enableOsPriorityMapping = false;  // 按任务优先级切换工作线程的OS调度类别
+    bool allowRealtimeScheduling = false;  // 权限允许时CRITICAL任务使用SCHED_FIFO
+    size_t fiberCarriers = 0;              // 纤程载体线程数，0表示不启用纤程运行时
+    size_t fiberStackSize = 64 * 1024;     // 纤程栈大小
+    // 亲和队列积压超过该数量时允许其他空闲线程窃取；0表示只要有积压就窃取
+    size_t affinityStealThreshold = 4;
+    // 并发提交时生产者把请求发布到各自的槽位，由一个线程批量登记和入队（flat combining）；
+    // 适合多核上大量线程同时提交，生产者少或核数少时额外开销大于收益，默认关闭
+    bool combineSubmissions = false;
+    // 累计计数和延迟直方图的记录（均按线程分片，不加锁）；关闭后getPerformanceMetrics中的计数和延迟分布不再增长
+    bool collectMetrics = true;
+    // 非空时挂接到共享执行器：不创建自己的线程池，线程数由执行器全局限制（此时不启用纤程载体线程）
+    std::shared_ptr<SharedExecutor> sharedExecutor;
+    // 未指定执行时限（Task::timeout为max()）的任务使用的执行时限，max()表示不限
+    std::chrono::milliseconds defaultTimeout = std::chrono::milliseconds::max();
+    // 已结束任务的状态记录最多保留的数量和时长，超出时回收最早结束的记录；被回收的ID查询时视为不存在，作为依赖时视为已完成
+    size_t maxFinishedTaskRecords = 100000;
+    std::chrono::milliseconds finishedTaskRetention = std::chrono::minutes(10);
+    // 完成结果环的容量（向上取2的幂），写满后覆盖最早的结果
+    size_t completedResultCapacity = 1024;
     bool enableLoadBalancing = true;
     LoadBalancingStrategy strategy = LoadBalancingStrategy::ADAPTIVE;
     std::chrono::milliseconds monitorInterval = std::chrono::milliseconds(1000);
@@ -133,16 +294,24 @@ struct SchedulerConfig {
 };
 
 // 主要类声明
-class TaskScheduler {
+// 按策略在编译期组合的调度器，TaskScheduler是其中全部功能的组合：
+//   QueuePolicy   全局和亲和队列：PriorityQueue（按优先级）或FifoQueue（忽略优先级，入队出队O(1)）
+//   LockPolicy    任务状态锁：std::mutex或SpinLock（临界区很短、线程数不超过核数时省去futex系统调用）
+//   ResultPolicy  完成结果：ResultRing或NoResults（不保留结果，waitForTask只返回状态）
+//   MetricsPolicy 累计计数和延迟直方图：MetricCounters或NoMetrics（记录在编译期去掉）
+// 接口与TaskScheduler相同。成员函数定义在TaskScheduler.cpp中，只对文件末尾列出的组合显式实例化；
+// TaskGroup、TaskGraph、SubmissionChannel和并行算法只接受TaskScheduler
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+class BasicScheduler {
 public:
     // 构造函数和析构函数
-    TaskScheduler();
-    explicit TaskScheduler(const SchedulerConfig& config);
-    ~TaskScheduler();
+    BasicScheduler();
+    explicit BasicScheduler(const SchedulerConfig& config);
+    ~BasicScheduler();
     
     // 禁用拷贝构造和赋值
-    TaskScheduler(const TaskScheduler&) = delete;
-    TaskScheduler& operator=(const TaskScheduler&) = delete;
+    BasicScheduler(const BasicScheduler&) = delete;
+    BasicScheduler& operator=(const BasicScheduler&) = delete;
     
     // 初始化和生命周期管理
     bool initialize(const SchedulerConfig& config);
@@ -152,19 +321,89 @@ public:
     // 任务管理
     TaskID submitTask(std::shared_ptr<Task> task);
     TaskID submitTask(TaskType type, Priority priority, std::function<TaskResult()> function);
+    // timeout为执行时限，queueTimeout为排队时限（见Task::timeout）
     TaskID submitTask(TaskType type, Priority priority, std::function<TaskResult()> function,
-                     std::chrono::milliseconds timeout);
+                     std::chrono::milliseconds timeout,
+                     std::chrono::milliseconds queueTimeout = std::chrono::milliseconds::max());
+    // 依赖任务在登记时挂到未结束的前驱上，最后一个前驱完成时入队，不轮询前驱状态；
+    // 前驱失败、取消或不存在时任务（及其后继）直接取消；记录已被回收的前驱视为已完成（已无法区分其成败）。
+    // 等待依赖期间状态为PENDING，可取消
     TaskID submitTask(TaskType type, Priority priority, std::function<TaskResult()> function,
                      const std::vector<TaskID>& dependencies);
     
+    // 提交在纤程上执行的任务（未启用纤程运行时则在工作线程上执行）
+    TaskID submitFiberTask(TaskType type, Priority priority, std::function<TaskResult()> function);
+    
+    // 提交任务并在调用线程上同步执行，省去入队和跨线程交接
+    TaskResult submitAndWait(TaskType type, Priority priority, std::function<TaskResult()> function);
+    
+    // 等待任务结束并返回结果；任务尚未被工作线程取走时直接在调用线程上执行
+    // 在本调度器的任务中调用时，被等待的任务在其他线程上运行期间会帮忙执行其他排队任务
+    TaskResult waitForTask(TaskID taskId,
+                           std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+    
+    // 等待一组任务（如递归分治的子任务），结果顺序与taskIds一致
+    std::vector<TaskResult> waitForTasks(const std::vector<TaskID>& taskIds);
+    
+    // 提交gang任务：parts个部分在parts个工作线程上同时开始、同时释放，
+    // 适合内部用屏障同步的协作任务；parts超过工作线程数时返回0，集结完成前线程池缩减到不足parts个线程时任务失败
+    TaskID submitGangTask(TaskType type, Priority priority, size_t parts,
+                          std::function<void(size_t part, size_t parts)> function);
+    
+    // 提交带亲和键的任务：同一键的任务优先在同一工作线程上执行（共享执行器模式下不区分线程）
+    TaskID submitAffinityTask(TaskType type, Priority priority, uint64_t affinityKey,
+                              std::function<TaskResult()> function);
+    
+    // 注册TaskType对应的工作线程上下文工厂；替换工厂后各线程已有的上下文在下次使用时重建
+    void setWorkerContextFactory(TaskType type, WorkerContextFactory factory);
+    
+    // 提交使用工作线程上下文的任务，执行时传入当前线程上该类型的上下文；
+    // 未注册工厂时任务失败。同一线程上嵌套执行（等待时帮忙执行）的同类任务使用临时上下文
+    TaskID submitContextTask(TaskType type, Priority priority,
+                             std::function<TaskResult(WorkerContext&)> function);
+    
+    // 提交数据流任务：前驱完成时其结果直接移入本任务的输入槽（inputs[i]对应dependencies[i]），
+    // 不经过getCompletedTasks查找；结果交给数据流后继的前驱在完成列表中只保留状态，不保留结果值。
+    // 登记时前驱已完成的，从完成列表中取其结果；结果已交给其他数据流后继或已被覆盖时取不到输入，
+    // 本任务按依赖失败处理（状态为CANCELLED，不执行）
+    TaskID submitDataflowTask(TaskType type, Priority priority,
+                              std::function<TaskResult(std::vector<std::any>& inputs)> function,
+                              const std::vector<TaskID>& dependencies);
+    
+    // 提交任意可调用对象，返回带确切结果类型的句柄：可调用对象和结果与Task在同一次分配中存放，
+    // 结果不经过std::any，可调用对象可以只支持移动。登记、排队、取消和等待与submitTask相同
+    template<typename F>
+    TaskHandle<std::invoke_result_t<std::decay_t<F>&>, BasicScheduler> submit(TaskType type, Priority priority, F&& function);
+    
     bool cancelTask(TaskID taskId);
+    
+    // 在任务中调用：当前任务已超过执行时限（状态已是TIMEOUT）时返回true，长任务可据此提前结束
+    static bool currentTaskTimedOut();
+    
+    // 一次队列遍历取消一组仍在排队的任务，返回取消的数量
+    size_t cancelTasks(const std::vector<TaskID>& taskIds);
+    // 不加锁读取（ID不存在或记录已被回收时返回CANCELLED）
     TaskStatus getTaskStatus(TaskID taskId);
+    
+    // 任务记录是否仍在表中：已回收的旧ID和从未分配的ID返回false
+    bool hasTaskRecord(TaskID taskId) const;
+    // 复制结果环中的全部结果；持续消费完成结果时用readCompletedTasks或drainCompletedTasks
     std::vector<TaskResult> getCompletedTasks();
     void clearCompletedTasks();
     
+    // 位于当前最新结果之后的游标：之后的读取只看到此后完成的结果（默认构造的游标从环中最早的结果开始）
+    ResultCursor completedTasksCursor() const;
+    // 按完成顺序把cursor之后的结果（最多maxResults个）交给callback，返回个数。不加锁：回调期间不阻塞工作线程，
+    // 各读取方持有各自的游标互不影响；落后超过环容量时跳过被覆盖的结果并计入cursor.missed
+    size_t readCompletedTasks(ResultCursor& cursor, const std::function<void(const TaskResult&)>& callback,
+                              size_t maxResults = SIZE_MAX) const;
+    // 用调度器内部的游标读取：每个结果只被drain交出一次，多个drain调用方之间串行
+    size_t drainCompletedTasks(const std::function<void(const TaskResult&)>& callback, size_t maxResults = SIZE_MAX);
+    
     // 配置和控制
     void updateConfig(const SchedulerConfig& config);
     SchedulerConfig getConfig() const;
+    // 暂停返回后不再有任务被工作线程认领，已出队的任务放回队列；恢复后按原顺序继续
     void pauseScheduling();
     void resumeScheduling();
     bool isPaused() const;
@@ -172,54 +411,285 @@ public:
     // 监控和统计
     PerformanceMetrics getPerformanceMetrics();
     QueueStatus getQueueStatus();
+    
+    // 已执行任务的延迟分布，按优先级和任务类型筛选，不指定时合并全部；记录为O(1)，查询时合并
+    LatencyDistribution getLatencyDistribution(LatencyKind kind,
+                                               std::optional<Priority> priority = std::nullopt,
+                                               std::optional<TaskType> type = std::nullopt) const;
+    // 延迟分位数（毫秒），percent为0~100（如50、90、99、99.9）
+    double getLatencyPercentile(LatencyKind kind, double percent,
+                                std::optional<Priority> priority = std::nullopt,
+                                std::optional<TaskType> type = std::nullopt) const;
     std::vector<std::string> getSystemLogs();
     void exportMetrics(const std::string& filePath);
     
     // 高级功能
     void setLoadBalancingStrategy(LoadBalancingStrategy strategy);
+    
+    // 调整执行任务的工作线程数（不含纤程载体线程）；缩小时多余的线程执行完当前任务后退出，
+    // 调用方等待它们退出，在本调度器的任务中调用时不等待
     void adjustThreadPoolSize(size_t newSize);
     void flushLogs();
     
 private:
+    friend class TaskGroup;
+    friend class TaskGraph;
+    friend class SubmissionChannel;
+    
+    static constexpr size_t kNoAffinitySlot = static_cast<size_t>(-1);
+    
     // 内部方法
     TaskID generateTaskId();
-    void workerThread();
+    void workerThread(size_t affinitySlot = kNoAffinitySlot, bool compensation = false);
+    void startWorkers(size_t count);
+    bool retireSurplusWorker(size_t affinitySlot);
+    void moveAffinityTasks(AffinitySlot<QueuePolicy>& slot);
+    void waitWhilePaused(uint64_t wakeEpoch);
+    void wakeWorkers();
+    void requeueTask(const std::shared_ptr<Task>& task);
+    bool runNextTask();
+    void executeTask(std::shared_ptr<Task> task);
     void monitorThread();
     void timeoutCheckThread();
-    void processTask(std::shared_ptr<Task> task);
+    void armQueueDeadline(const std::shared_ptr<Task>& task);
+    void expireTasks(const std::vector<std::shared_ptr<Task>>& queued, const std::vector<std::shared_ptr<Task>>& running);
+    bool registerTask(std::shared_ptr<Task> task, bool queued);
+    void cancelUnqueued(const std::vector<std::shared_ptr<Task>>& tasks);
+    TaskResult runInline(std::shared_ptr<Task> task);
+    bool claimTask(const std::shared_ptr<Task>& task, bool* deferred = nullptr);
+    size_t queuedTaskCount() const;
+    size_t affinitySlotFor(uint64_t affinityKey) const;
+    size_t ownAffinitySlot() const;
+    QueuePolicy& queueFor(const Task& task);
+    void pushAffinityTask(const std::shared_ptr<Task>& task);
+    void enqueueTask(const std::shared_ptr<Task>& task);
+    TaskID submitDependentTask(const std::shared_ptr<Task>& task);
+    void releaseSuccessors(std::vector<std::shared_ptr<Task>>& successors, bool succeeded);
+    bool submitCombined(const std::shared_ptr<Task>& task);
+    void combineSubmissions(SubmitCombiner& combiner);
+    void enqueueBatch(std::vector<std::shared_ptr<Task>>& batch);
+    void attachChannel(SubmissionChannel* channel);
+    void detachChannel(SubmissionChannel* channel);
+    TaskID submitToChannel(SubmissionChannel& channel, std::shared_ptr<Task> task);
+    bool drainChannels(bool wait);
+    std::shared_ptr<Task> nextAffinityTask(size_t ownSlot);
+    bool awaitTasks(const std::vector<TaskID>& taskIds, std::chrono::steady_clock::time_point deadline,
+                    std::unordered_map<TaskID, TaskResult>& inlineResults);
+    TaskResult lookupResult(TaskID taskId);
+    size_t gangCapacity() const;
+    TaskResult runGang(std::shared_ptr<GangState> gang);
+    bool joinGang();
+    void runGangPart(GangState& gang, size_t part);
+    TaskResult runWithWorkerContext(TaskType type, const std::function<TaskResult(WorkerContext&)>& function);
+    void releaseWorkerContexts();
+    bool canHelp() const;
+    bool helpOneTask();
+    void notifyCancelled(const std::vector<std::shared_ptr<Task>>& tasks,
+                         ResultStatus status = ResultStatus::CANCELLED);
+    TaskResult processTask(std::shared_ptr<Task> task, bool callerThread = false);
     void updateMetrics();
-    void handleTaskCompletion(const TaskResult& result);
-    void handleTaskFailure(TaskID taskId, const std::string& error);
-    bool checkDependencies(const std::vector<TaskID>& dependencies);
+    void countMetric(Metric metric, uint64_t value = 1);
+    void updateMetricsLocked();
+    bool handleTaskCompletion(const TaskResult& result, const Task& task);
+    TaskResult handleTaskFailure(TaskID taskId, const std::string& error);
     
     // 成员变量
     std::unique_ptr<ThreadPool> threadPool_;
-    std::unique_ptr<PriorityQueue> taskQueue_;
+    std::unique_ptr<QueuePolicy> taskQueue_;
+    std::atomic<size_t> staleQueueEntries_{0};  // 已结束排队、尚未出队的条目数，不计入排队任务数
+    std::unique_ptr<FiberRuntime> fiberRuntime_;
+    std::shared_ptr<SharedExecutor> executor_;
+    uint64_t executorSourceId_ = 0;
     // 以下组件将在后续里程碑中实现
     // std::unique_ptr<PerformanceMonitor> performanceMonitor_;
-    // std::unique_ptr<TaskTimeoutManager> timeoutManager_;
     // std::unique_ptr<Logger> logger_;
     
     SchedulerConfig config_;
     std::atomic<bool> running_;
     std::atomic<bool> paused_;
     std::atomic<TaskID> nextTaskId_;
+    std::atomic<bool> osPriorityMapping_;
+    std::atomic<bool> realtimeScheduling_;
+    std::atomic<RejectionPolicy> rejectionPolicy_;
+    std::atomic<size_t> maxQueueSize_;
+    std::atomic<size_t> affinityStealThreshold_{4};
+    std::atomic<bool> combineSubmissions_{false};
+    std::atomic<std::chrono::milliseconds> defaultTimeout_{std::chrono::milliseconds::max()};
     
-    std::unordered_map<TaskID, TaskStatus> taskStatuses_;
-    std::unordered_map<TaskID, std::shared_ptr<Task>> activeTasks_;
-    std::vector<TaskResult> completedTasks_;
+    // 任务状态和活跃任务对象：修改受statusMutex_保护，状态查询不加锁
+    std::unique_ptr<TaskTable> taskTable_;
+    // 最近完成的结果：写入受statusMutex_保护，读取不加锁
+    std::unique_ptr<ResultPolicy> completedTasks_;
+    // 排队等待、执行和端到端延迟的直方图，按优先级和任务类型分开记录，不加锁
+    std::unique_ptr<LatencyRecorder> latencies_;
+    // 累计计数按线程分片，提交、完成和失败时不加锁；读取指标时才合并到currentMetrics_
+    std::unique_ptr<MetricsPolicy> counters_;
+    // 排队和执行时限的截止时间，任务开始执行和结束时更新，超时线程只处理到期的任务
+    std::unique_ptr<DeadlineHeap> deadlines_;
+    std::atomic<bool> collectMetrics_{true};
+    std::mutex drainMutex_;
+    ResultCursor drainCursor_;
     
-    mutable std::mutex statusMutex_;
+    mutable LockPolicy statusMutex_;
     mutable std::mutex resultsMutex_;
     mutable std::mutex configMutex_;
+    // 配合statusMutex_，任务进入终态时通知waitForTask
+    std::conditional_t<std::is_same_v<LockPolicy, std::mutex>, std::condition_variable, std::condition_variable_any> taskFinished_;
+    
+    // gang集结：同一时刻只有一个gang在集结，空闲的工作线程优先加入
+    std::mutex gangMutex_;
+    std::condition_variable gangCondition_;
+    std::shared_ptr<GangState> assemblingGang_;
+    std::atomic<bool> gangAssembling_{false};
+    std::atomic<uint64_t> maxGangWaitMicros_{0};    // 最长集结等待时间，取最大值不能按线程分片累加
+    
+    // 亲和调度：每个常驻工作线程一个软亲和队列（初始化后数量不变）
+    std::vector<std::unique_ptr<AffinitySlot<QueuePolicy>>> affinitySlots_;
+    
+    // 工作循环：目标数量，以及带亲和队列和不带亲和队列的循环数（不含补偿线程）
+    std::mutex workersMutex_;
+    std::mutex resizeMutex_;
+    std::atomic<size_t> targetWorkers_{0};
+    std::atomic<size_t> slotWorkers_{0};
+    std::atomic<size_t> extraWorkers_{0};
+    
+    // 暂停期间工作线程在此等待，wakeWorkers同时唤醒这里和队列上的等待
+    std::mutex pauseMutex_;
+    std::condition_variable resumed_;
+    
+    // 合并提交的发布槽位
+    std::unique_ptr<SubmitCombiner> submitCombiner_;
+    
+    // 单生产者提交通道：channelsMutex_同时保证每个通道只有一个消费者
+    std::mutex channelsMutex_;
+    std::vector<SubmissionChannel*> channels_;
+    std::vector<std::shared_ptr<Task>> channelBatch_;
+    std::atomic<size_t> channelCount_{0};
+    std::atomic<bool> drainRequested_{false};   // 不等待的取出遇到锁被占用，持有者释放后需再取一次
+    std::atomic<size_t> idleWorkers_{0};    // 正准备阻塞等待任务的工作线程数
+    
+    // 工作线程上下文：各TaskType的工厂及版本号，以及每个线程上已创建的上下文
+    std::mutex contextMutex_;
+    std::vector<std::pair<WorkerContextFactory, uint64_t>> contextFactories_;
+    std::unordered_map<std::thread::id, std::shared_ptr<WorkerContextSlots>> workerContexts_;
     
     std::thread monitorThread_;
     std::thread timeoutThread_;
     
-    PerformanceMetrics currentMetrics_;
+    PerformanceMetrics currentMetrics_;     // 合并后的指标快照，受resultsMutex_保护
     std::chrono::steady_clock::time_point startTime_;
 };
 
+extern template class BasicScheduler<PriorityQueue, std::mutex, ResultRing, MetricCounters>;
+extern template class BasicScheduler<PriorityQueue, std::mutex, ResultRing, NoMetrics>;
+extern template class BasicScheduler<PriorityQueue, SpinLock, ResultRing, MetricCounters>;
+extern template class BasicScheduler<FifoQueue, SpinLock, NoResults, NoMetrics>;
+
+namespace detail {
+
+// submit<F>的任务：结果存放在任务对象内（void结果用monostate表示）
+template<typename T>
+struct TypedTaskState : Task {
+    static_assert(!std::is_reference_v<T>, "task callables must return by value");
+    
+    std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>> value;
+    std::exception_ptr error;
+    
+    TypedTaskState(TaskType type, Priority priority) : Task(0, type, priority, nullptr) {}
+    TypedTaskState(const TypedTaskState&) = delete;
+    TypedTaskState& operator=(const TypedTaskState&) = delete;
+};
+
+template<typename T, typename F>
+struct TypedTask final : TypedTaskState<T> {
+    F callable;
+    
+    template<typename G>
+    TypedTask(TaskType type, Priority priority, G&& function)
+        : TypedTaskState<T>(type, priority), callable(std::forward<G>(function)) {
+        // 只捕获this，放得进std::function的内部缓冲区，不额外分配
+        this->function = [this] { return run(); };
+    }
+    
+    // 异常记录后照常抛出，由调度器按失败处理
+    TaskResult run() {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                std::invoke(callable);
+                this->value.emplace();
+            } else {
+                this->value.emplace(std::invoke(callable));
+            }
+        } catch (...) {
+            this->error = std::current_exception();
+            throw;
+        }
+        return TaskResult(this->id, ResultStatus::SUCCESS);
+    }
+};
+
+} // namespace detail
+
+// submit<F>返回的句柄，调度器须在句柄使用期间保持存活；提交失败时句柄无效
+template<typename T, typename Scheduler>
+class TaskHandle {
+public:
+    TaskHandle() = default;
+    TaskHandle(Scheduler& scheduler, std::shared_ptr<detail::TypedTaskState<T>> state)
+        : scheduler_(&scheduler), state_(std::move(state)) {}
+    
+    bool valid() const { return state_ != nullptr; }
+    TaskID id() const { return state_ ? state_->id : 0; }
+    TaskStatus status() const { return state_ ? scheduler_->getTaskStatus(state_->id) : TaskStatus::CANCELLED; }
+    bool cancel() { return state_ && scheduler_->cancelTask(state_->id); }
+    
+    // 等待任务结束，语义与waitForTask相同（未被取走时在调用线程上执行）；返回是否成功完成
+    bool wait(std::chrono::milliseconds timeout = std::chrono::milliseconds::max()) {
+        if (!state_) {
+            return false;
+        }
+        return scheduler_->waitForTask(state_->id, timeout).status == ResultStatus::SUCCESS;
+    }
+    
+    // 等待并取出结果（只能取一次）：任务抛出的异常原样重新抛出，取消或超时时抛出std::runtime_error
+    T get() {
+        if (!state_) {
+            throw std::runtime_error("Invalid task handle");
+        }
+        TaskResult result = scheduler_->waitForTask(state_->id);
+        // 只在任务已执行结束（成功或失败）时读取结果：执行超时的任务仍在运行，还会写入value和error
+        bool finished = result.status == ResultStatus::SUCCESS || result.status == ResultStatus::FAILURE;
+        if (finished && state_->error) {
+            std::rethrow_exception(state_->error);
+        }
+        if (!finished || !state_->value) {
+            throw std::runtime_error("Task " + std::to_string(state_->id) + " did not complete: " +
+                                     (result.errorMessage.empty() ? "cancelled or timed out" : result.errorMessage));
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*state_->value);
+        }
+    }
+    
+private:
+    Scheduler* scheduler_ = nullptr;
+    std::shared_ptr<detail::TypedTaskState<T>> state_;
+};
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+template<typename F>
+TaskHandle<std::invoke_result_t<std::decay_t<F>&>, BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>>
+BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submit(TaskType type, Priority priority, F&& function) {
+    using T = std::invoke_result_t<std::decay_t<F>&>;
+    
+    std::shared_ptr<detail::TypedTaskState<T>> state =
+        std::make_shared<detail::TypedTask<T, std::decay_t<F>>>(type, priority, std::forward<F>(function));
+    if (submitTask(state) == 0) {
+        return {};
+    }
+    return TaskHandle<T, BasicScheduler>(*this, std::move(state));
+}
+
 // 辅助类和函数
 class TaskComparator {
 public:
@@ -227,11 +697,30 @@ public:
         if (a->priority != b->priority) {
             return static_cast<int>(a->priority) > static_cast<int>(b->priority);
         }
-        return a->submitTime > b->submitTime;
+        if (a->submitTime != b->submitTime) {
+            return a->submitTime > b->submitTime;
+        }
+        return a->id > b->id;  // 同一时刻提交的按ID保持先后
     }
 };
 
+// 在作用域内把当前线程标记为正在执行指定优先级的任务，析构时恢复原值
+class TaskPriorityScope {
+public:
+    explicit TaskPriorityScope(Priority priority);
+    ~TaskPriorityScope();
+    
+    TaskPriorityScope(const TaskPriorityScope&) = delete;
+    TaskPriorityScope& operator=(const TaskPriorityScope&) = delete;
+    
+private:
+    Priority previous_;
+};
+
 // 工具函数
+// 当前线程正在执行的任务优先级（不在任务中时为NORMAL）
+Priority currentTaskPriority();
+
 std::string priorityToString(Priority priority);
 std::string taskStatusToString(TaskStatus status);
 std::string taskTypeToString(TaskType type);
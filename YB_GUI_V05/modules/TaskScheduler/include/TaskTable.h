@@ -0,0 +1,125 @@
+#ifndef TASK_TABLE_H
+#define TASK_TABLE_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <chrono>
+#include "TaskScheduler.h"
+
+namespace YB {
+
+// 任务记录表：代际索引的槽位表。TaskID的低kSlotBits位为槽位号，高位为全局递增的序号（槽位的代），
+// 槽位被复用后旧ID与槽位中的ID不符，查询时识别为已回收。状态保存在原子变量中，查询不加锁；
+// 槽位按段分配，段在表销毁前不释放，无锁读取不会访问已释放的内存。
+// 除分配ID外，登记、状态转换和结束都由调用方在调度器的状态锁下进行
+class TaskTable {
+public:
+    static constexpr unsigned kSlotBits = 24;
+
+    TaskTable();
+    ~TaskTable();
+
+    TaskTable(const TaskTable&) = delete;
+    TaskTable& operator=(const TaskTable&) = delete;
+
+    // 已结束记录的保留上限：超过数量或结束时间早于maxAge时回收最早结束的记录
+    void setRetention(size_t maxFinished, std::chrono::milliseconds maxAge);
+
+    // 分配槽位并生成ID（无锁，生产者可在登记前调用）；记录初始为PENDING，尚未关联任务对象。
+    // 槽位用尽或无法分配新段时返回0（不抛出异常，提交方据此拒绝任务）
+    TaskID allocate(uint64_t sequence);
+
+    // 无锁读取：ID不存在或记录已被回收时返回空
+    std::optional<TaskStatus> status(TaskID id) const;
+
+    // ID曾经分配过（代早于nextSequence）且记录已被回收；记录只在任务结束后回收
+    bool reclaimed(TaskID id, uint64_t nextSequence) const;
+
+    // 登记任务对象，任务结束前保持活跃
+    void attach(TaskID id, std::shared_ptr<Task> task, TaskStatus status);
+
+    // 状态转换（原子写入），记录不存在时返回false
+    bool setStatus(TaskID id, TaskStatus status);
+
+    // 活跃的任务对象，不存在或已结束时返回空
+    std::shared_ptr<Task> task(TaskID id) const;
+
+    // 任务不再活跃；进入终态且不再活跃的记录按保留上限回收
+    void release(TaskID id);
+
+    // 回收超过保留时长的记录（无新任务结束时由定时线程调用）
+    void reclaimExpired();
+
+    // 遍历已登记的记录：function(TaskID, TaskStatus, const std::shared_ptr<Task>&)
+    template<typename F>
+    void forEach(F&& function) const;
+
+    // 清空所有记录，已分配的段保留复用
+    void clear();
+
+    size_t capacity() const;    // 已分配的槽位数
+    size_t retained() const;    // 保留的已结束记录数
+
+private:
+    static constexpr unsigned kSegmentBits = 12;
+    static constexpr size_t kSegmentSize = size_t(1) << kSegmentBits;
+    static constexpr size_t kMaxSlots = size_t(1) << kSlotBits;
+    static constexpr TaskID kSlotMask = kMaxSlots - 1;
+
+    struct Slot {
+        std::atomic<TaskID> id{0};                 // 0表示空闲
+        std::atomic<TaskStatus> status{TaskStatus::PENDING};
+        std::atomic<uint32_t> nextFree{0};         // 空闲栈中的下一个槽位号 + 1
+        std::shared_ptr<Task> task;                // 以下受状态锁保护
+        bool retired = false;                      // 已进入待回收队列
+    };
+
+    struct Segment {
+        Slot slots[kSegmentSize];
+    };
+
+    struct Finished {
+        TaskID id;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    Slot& slotAt(size_t index) const;
+
+    // 调用方已确认ID有效
+    Slot* find(TaskID id) const;
+
+    void retire(Slot& slot, TaskID id);
+    void trim(std::chrono::steady_clock::time_point now);
+    void free(Slot& slot, size_t index);
+
+    std::unique_ptr<std::atomic<Segment*>[]> segments_;
+    std::atomic<size_t> nextFresh_{0};
+    std::atomic<uint64_t> freeHead_{0};     // 高32位为防ABA的版本号，低32位为栈顶槽位号 + 1
+
+    std::deque<Finished> finished_;
+    size_t maxFinished_ = 100000;
+    std::chrono::milliseconds maxAge_{std::chrono::minutes(10)};
+};
+
+template<typename F>
+void TaskTable::forEach(F&& function) const {
+    size_t count = std::min(nextFresh_.load(std::memory_order_acquire), kMaxSlots);
+    for (size_t index = 0; index < count; ++index) {
+        if (!segments_[index >> kSegmentBits].load(std::memory_order_acquire)) {
+            continue;
+        }
+        const Slot& slot = slotAt(index);
+        TaskID id = slot.id.load(std::memory_order_acquire);
+        TaskStatus status = slot.status.load(std::memory_order_acquire);
+        // 只分配了ID、尚未登记的记录不算
+        if (id != 0 && (slot.task || status != TaskStatus::PENDING)) {
+            function(id, status, slot.task);
+        }
+    }
+}
+
+} // namespace YB
+
+#endif // TASK_TABLE_H
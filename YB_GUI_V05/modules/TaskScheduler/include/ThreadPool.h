@@ -15,6 +15,8 @@
 
 namespace YB {
 
+class BlockingScope;
+
 class ThreadPool {
 public:
     // 构造函数
@@ -31,8 +33,12 @@ public:
     template<typename F, typename... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type>;
     
-    // 调整线程池大小
-    void resize(size_t newSize);
+    // 调整线程池大小；缩小时多余的线程空闲后退出，wait为true时等待它们退出。
+    // 池内线程上调用时不能等待（要退出的可能正是调用方自己）
+    void resize(size_t newSize, bool wait = true);
+    
+    // 等待此前缩小时多余的线程全部退出
+    void waitForRemovals();
     
     // 获取当前活跃线程数
     size_t getActiveThreads() const;
@@ -49,14 +55,53 @@ public:
     // 检查线程池是否停止
     bool isStopped() const;
     
+    // 设置阻塞补偿线程的硬上限（0表示禁用补偿）
+    void setMaxCompensationThreads(size_t maxThreads);
+    
+    // 设置补偿线程启动后首先运行的任务（用于长期占用工作线程的循环）
+    void setCompensationTask(std::function<void()> task);
+    
+    // 设置补偿线程需要退役时的通知（长期循环阻塞在自己的等待上时，用它唤醒循环检查退役）
+    void setRetireNotifier(std::function<void()> notifier);
+    
+    // 获取当前处于阻塞区域的线程数
+    size_t getBlockedThreads() const;
+    
+    // 获取当前活跃的补偿线程数
+    size_t getCompensationThreads() const;
+    
+    // 获取累计补偿次数（新建或唤醒）
+    size_t getTotalCompensations() const;
+    
+    // 获取进程内所有线程池的工作线程总数（含补偿线程）
+    static size_t getProcessThreadCount();
+    
+    // 获取当前线程所属的线程池（非工作线程返回nullptr）
+    static ThreadPool* current();
+    
+    // 当前线程是多余的补偿线程，应尽快退出长期循环；返回true时已认领退役（补偿数随之减一），
+    // 调用方必须退出循环，多余的补偿线程之间每份多余只有一个返回true
+    static bool currentThreadShouldRetire();
+    
 private:
+    friend class BlockingScope;
+    
     // 工作线程函数
-    void workerThread();
+    void workerThread(bool compensation = false);
+    
+    // 补偿线程入口
+    void compensationThread();
+    void runCompensationTask(const std::function<void()>& task);
+    bool claimRetirement();
+    
+    // 阻塞区域进入/退出
+    void beginBlocking();
+    void endBlocking();
     
     // 添加新线程
     void addThreads(size_t count);
     
-    // 移除线程
+    // 移除线程（不等待）
     void removeThreads(size_t count);
     
 private:
@@ -78,6 +123,33 @@ private:
     
     // 线程池大小
     std::atomic<size_t> poolSize_;
+    
+    // 阻塞补偿相关（除原子计数外均受queueMutex_保护）
+    std::vector<std::thread> compensationWorkers_;
+    std::vector<std::thread::id> retiredCompensationIds_;
+    std::function<void()> compensationTask_;
+    std::function<void()> retireNotifier_;
+    size_t maxCompensationThreads_;
+    size_t parkedCompensationThreads_;
+    size_t compensationWakeups_;
+    std::atomic<size_t> blockedThreads_;
+    std::atomic<size_t> compensationThreads_;
+    std::atomic<size_t> totalCompensations_;
+};
+
+// 阻塞区域标记：任务在调用阻塞API（文件读取、等待future等）前构造，
+// 线程池会临时新建或唤醒一个补偿线程，阻塞结束后补偿线程自动退役。
+// 在线程池之外的线程上构造时不产生任何效果，嵌套使用时只有最外层生效。
+class BlockingScope {
+public:
+    BlockingScope();
+    ~BlockingScope();
+    
+    BlockingScope(const BlockingScope&) = delete;
+    BlockingScope& operator=(const BlockingScope&) = delete;
+    
+private:
+    ThreadPool* pool_;
 };
 
 // 模板函数实现
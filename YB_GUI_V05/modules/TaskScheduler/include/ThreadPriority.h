@@ -0,0 +1,45 @@
+#ifndef THREAD_PRIORITY_H
+#define THREAD_PRIORITY_H
+
+#include "TaskScheduler.h"
+
+namespace YB {
+
+// 操作系统线程调度类别
+enum class OsSchedulingClass {
+    NORMAL,         // SCHED_OTHER，使用nice值区分
+    REALTIME_FIFO,  // SCHED_FIFO
+    IDLE            // SCHED_IDLE
+};
+
+// 任务优先级对应的操作系统调度参数
+struct OsThreadPriority {
+    OsSchedulingClass schedClass = OsSchedulingClass::NORMAL;
+    int niceValue = 0;
+    int realtimePriority = 0;
+};
+
+// 当前进程可用的调度权限（启动时探测一次）
+struct OsPriorityCapabilities {
+    bool supported = false;     // 平台支持线程级调度设置
+    bool canRaise = false;      // 可使用负nice值
+    bool canUseFifo = false;    // 可使用SCHED_FIFO
+    bool canRestore = false;    // 降级（正nice/SCHED_IDLE）后可恢复到默认
+};
+
+// 获取调度权限（结果缓存）
+const OsPriorityCapabilities& getOsPriorityCapabilities();
+
+// 计算任务优先级在当前权限下的调度参数，权限不足时回退到默认
+OsThreadPriority mapPriorityToOs(Priority priority, bool allowRealtime);
+
+// 将当前线程切换到任务优先级对应的调度类别（与当前相同则不做系统调用）
+// 返回false表示设置失败，线程保持原有类别
+bool applyThreadPriority(Priority priority, bool allowRealtime);
+
+// 将当前线程恢复为默认调度类别
+void resetThreadPriority();
+
+} // namespace YB
+
+#endif // THREAD_PRIORITY_H
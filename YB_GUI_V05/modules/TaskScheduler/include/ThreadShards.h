@@ -0,0 +1,87 @@
+#ifndef THREAD_SHARDS_H
+#define THREAD_SHARDS_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace YB {
+
+// 按线程分片的数据：每个线程首次访问时分配自己的分片，之后经线程局部缓存不加锁取得。
+// 分片只由所属线程写入（可用relaxed读写代替原子加），读取方用forEach遍历全部分片合并。
+// 线程退出后分片保留到对象销毁；线程ID被新线程复用时沿用原来的分片，仍只有一个写入方
+template<typename Shard>
+class ThreadShards {
+public:
+    ThreadShards() : id_(nextId()) {}
+
+    ThreadShards(const ThreadShards&) = delete;
+    ThreadShards& operator=(const ThreadShards&) = delete;
+
+    Shard& local();
+
+    // function(const Shard&)，遍历期间新线程的首次访问等待
+    template<typename F>
+    void forEach(F&& function) const;
+
+private:
+    // 每个线程缓存最近访问的几个对象（同一线程可能交替使用多个调度器）
+    static constexpr size_t kCacheEntries = 4;
+
+    struct CacheEntry {
+        uint64_t owner = 0;
+        Shard* shard = nullptr;
+    };
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1);
+    }
+
+    Shard& registerLocal();
+
+    const uint64_t id_;     // 全局唯一，线程局部缓存据此区分对象（地址可能被复用）
+    mutable std::mutex mutex_;
+    std::unordered_map<std::thread::id, std::unique_ptr<Shard>> shards_;
+};
+
+template<typename Shard>
+inline Shard& ThreadShards<Shard>::local() {
+    static thread_local CacheEntry cache[kCacheEntries];
+    static thread_local size_t victim = 0;
+    for (auto& entry : cache) {
+        if (entry.owner == id_) {
+            return *entry.shard;
+        }
+    }
+
+    CacheEntry& entry = cache[victim++ % kCacheEntries];
+    entry.shard = &registerLocal();
+    entry.owner = id_;
+    return *entry.shard;
+}
+
+template<typename Shard>
+Shard& ThreadShards<Shard>::registerLocal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& shard = shards_[std::this_thread::get_id()];
+    if (!shard) {
+        shard = std::make_unique<Shard>();
+    }
+    return *shard;
+}
+
+template<typename Shard>
+template<typename F>
+void ThreadShards<Shard>::forEach(F&& function) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : shards_) {
+        function(static_cast<const Shard&>(*entry.second));
+    }
+}
+
+} // namespace YB
+
+#endif // THREAD_SHARDS_H
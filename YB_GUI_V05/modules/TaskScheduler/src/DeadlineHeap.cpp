@@ -0,0 +1,143 @@
+#include "../include/DeadlineHeap.h"
+#include <algorithm>
+
+namespace YB {
+
+namespace {
+
+constexpr size_t kNotArmed = static_cast<size_t>(-1);
+
+} // namespace
+
+void DeadlineHeap::place(size_t index, Entry entry) {
+    entry.task->deadlineSlot = index;
+    heap_[index] = std::move(entry);
+}
+
+size_t DeadlineHeap::siftUp(size_t index) {
+    Entry entry = std::move(heap_[index]);
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (heap_[parent].deadline <= entry.deadline) {
+            break;
+        }
+        place(index, std::move(heap_[parent]));
+        index = parent;
+    }
+    place(index, std::move(entry));
+    return index;
+}
+
+void DeadlineHeap::siftDown(size_t index) {
+    Entry entry = std::move(heap_[index]);
+    size_t count = heap_.size();
+    while (true) {
+        size_t child = index * 2 + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && heap_[child + 1].deadline < heap_[child].deadline) {
+            child++;
+        }
+        if (entry.deadline <= heap_[child].deadline) {
+            break;
+        }
+        place(index, std::move(heap_[child]));
+        index = child;
+    }
+    place(index, std::move(entry));
+}
+
+DeadlineHeap::Entry DeadlineHeap::removeAt(size_t index) {
+    Entry removed = std::move(heap_[index]);
+    removed.task->deadlineSlot = kNotArmed;
+
+    // 用最后一个条目填补空位，再按它的截止时间上移或下移
+    Entry last = std::move(heap_.back());
+    heap_.pop_back();
+    if (index < heap_.size()) {
+        place(index, std::move(last));
+        if (siftUp(index) == index) {
+            siftDown(index);
+        }
+    }
+    return removed;
+}
+
+void DeadlineHeap::arm(const std::shared_ptr<Task>& task, Kind kind, std::chrono::steady_clock::time_point deadline) {
+    bool earliest = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t index = task->deadlineSlot;
+        if (index == kNotArmed) {
+            index = heap_.size();
+            heap_.push_back(Entry{deadline, kind, task});
+        } else {
+            heap_[index].deadline = deadline;
+            heap_[index].kind = kind;
+        }
+        index = siftUp(index);
+        siftDown(index);
+        earliest = task->deadlineSlot == 0;
+    }
+    if (earliest) {
+        changed_.notify_one();
+    }
+}
+
+void DeadlineHeap::disarm(Task& task) {
+    Entry removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (task.deadlineSlot == kNotArmed) {
+            return;
+        }
+        removed = removeAt(task.deadlineSlot);
+    }
+    // 条目持有的引用在锁外释放，任务对象的析构不在堆的锁内进行
+}
+
+std::vector<DeadlineHeap::Expired> DeadlineHeap::waitExpired(std::chrono::steady_clock::time_point wakeAt) {
+    std::vector<Expired> expired;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto now = std::chrono::steady_clock::now();
+    while (!stopped_ && now < wakeAt && (heap_.empty() || heap_.front().deadline > now)) {
+        auto until = heap_.empty() ? wakeAt : std::min(wakeAt, heap_.front().deadline);
+        changed_.wait_until(lock, until);
+        now = std::chrono::steady_clock::now();
+    }
+
+    while (!heap_.empty() && heap_.front().deadline <= now) {
+        Entry entry = removeAt(0);
+        expired.push_back(Expired{std::move(entry.task), entry.kind});
+    }
+    return expired;
+}
+
+void DeadlineHeap::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    changed_.notify_all();
+}
+
+void DeadlineHeap::clear() {
+    std::vector<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : heap_) {
+            entry.task->deadlineSlot = kNotArmed;
+        }
+        entries.swap(heap_);
+        stopped_ = false;
+    }
+}
+
+size_t DeadlineHeap::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return heap_.size();
+}
+
+} // namespace YB
@@ -0,0 +1,649 @@
+#include "../include/Fiber.h"
+#include "../include/ThreadPool.h"
+#include <iostream>
+#include <new>
+#include <thread>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define YB_FIBER_ASM_SWITCH 1
+#else
+#define YB_FIBER_ASM_SWITCH 0
+#include <ucontext.h>
+#endif
+
+namespace YB {
+
+namespace detail {
+
+// 纤程上下文：x86-64上只保存栈指针（寄存器压在纤程栈上），其他平台使用ucontext
+#if YB_FIBER_ASM_SWITCH
+struct FiberContext {
+    void* sp = nullptr;
+};
+#else
+struct FiberContext {
+    ucontext_t uc;
+};
+#endif
+
+struct Fiber {
+    FiberContext context;
+    FiberStackAllocator::Stack stack;
+    std::function<void()> function;
+    FiberRuntime* runtime = nullptr;
+    void (*entry)(Fiber*) = nullptr;
+    FiberLocalState* localState = nullptr;
+
+    // 存活纤程链表
+    Fiber* prev = nullptr;
+    Fiber* next = nullptr;
+};
+
+// 每个载体线程的调度状态
+struct FiberCarrier {
+    FiberRuntime* runtime = nullptr;
+    FiberContext schedulerContext;
+    Fiber* current = nullptr;
+
+    // 切换完成后由新上下文执行的动作（在切出方栈上执行这些动作会与其他载体线程竞争）
+    std::mutex* unlockAfterSwitch = nullptr;
+    Fiber* readyAfterSwitch = nullptr;
+    Fiber* destroyAfterSwitch = nullptr;
+};
+
+} // namespace detail
+
+namespace {
+
+thread_local detail::FiberCarrier* tlsCarrier = nullptr;
+
+// 纤程可能在另一个载体线程上恢复，禁止编译器跨切换缓存线程局部变量地址
+__attribute__((noinline)) detail::FiberCarrier* currentCarrier() {
+    asm volatile("");
+    return tlsCarrier;
+}
+
+#if YB_FIBER_ASM_SWITCH
+
+extern "C" void yb_fiber_switch(void** from, void* to);
+extern "C" void yb_fiber_trampoline();
+
+// 保存被调用者保存寄存器及MXCSR/x87控制字，然后切换栈指针
+asm(R"(
+    .text
+    .globl yb_fiber_switch
+    .hidden yb_fiber_switch
+    .type yb_fiber_switch,@function
+    .align 16
+yb_fiber_switch:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size yb_fiber_switch,.-yb_fiber_switch
+
+    .globl yb_fiber_trampoline
+    .hidden yb_fiber_trampoline
+    .type yb_fiber_trampoline,@function
+    .align 16
+yb_fiber_trampoline:
+    movq %r12, %rdi
+    callq *%r13
+    ud2
+    .size yb_fiber_trampoline,.-yb_fiber_trampoline
+)");
+
+void initContext(detail::Fiber* fiber) {
+    auto top = reinterpret_cast<uintptr_t>(fiber->stack.base) + fiber->stack.size;
+    // 跳板函数开始执行时rsp需16字节对齐
+    top = (top & ~uintptr_t(15)) - 16;
+
+    void** sp = reinterpret_cast<void**>(top);
+    *--sp = reinterpret_cast<void*>(&yb_fiber_trampoline);   // 返回地址
+    *--sp = nullptr;                                          // rbp
+    *--sp = nullptr;                                          // rbx
+    *--sp = fiber;                                            // r12：入口参数
+    *--sp = reinterpret_cast<void*>(fiber->entry);            // r13：入口函数
+    *--sp = nullptr;                                          // r14
+    *--sp = nullptr;                                          // r15
+    --sp;
+    auto* control = reinterpret_cast<uint32_t*>(sp);
+    control[0] = 0x1F80;                                      // MXCSR默认值
+    control[1] = 0x037F;                                      // x87控制字默认值
+
+    fiber->context.sp = sp;
+}
+
+inline void switchContext(detail::FiberContext& from, detail::FiberContext& to) {
+    yb_fiber_switch(&from.sp, to.sp);
+}
+
+#else
+
+void ucontextEntry(unsigned int high, unsigned int low) {
+    auto* fiber = reinterpret_cast<detail::Fiber*>((static_cast<uintptr_t>(high) << 32) | low);
+    fiber->entry(fiber);
+}
+
+void initContext(detail::Fiber* fiber) {
+    getcontext(&fiber->context.uc);
+    fiber->context.uc.uc_stack.ss_sp = fiber->stack.base;
+    fiber->context.uc.uc_stack.ss_size = fiber->stack.size;
+    fiber->context.uc.uc_link = nullptr;
+
+    auto value = reinterpret_cast<uintptr_t>(fiber);
+    makecontext(&fiber->context.uc, reinterpret_cast<void (*)()>(&ucontextEntry), 2,
+                static_cast<unsigned int>(value >> 32), static_cast<unsigned int>(value & 0xFFFFFFFFu));
+}
+
+inline void switchContext(detail::FiberContext& from, detail::FiberContext& to) {
+    swapcontext(&from.uc, &to.uc);
+}
+
+#endif
+
+} // namespace
+
+// FiberStackAllocator 实现
+FiberStackAllocator::FiberStackAllocator(size_t stackSize, bool guardPages, size_t maxPooledStacks)
+    : maxPooledStacks_(maxPooledStacks), mappedStacks_(0) {
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    stackSize_ = ((std::max(stackSize, pageSize) + pageSize - 1) / pageSize) * pageSize;
+    guardSize_ = guardPages ? pageSize : 0;
+}
+
+FiberStackAllocator::~FiberStackAllocator() {
+    for (const auto& stack : pool_) {
+        unmap(stack);
+    }
+}
+
+FiberStackAllocator::Stack FiberStackAllocator::allocate() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!pool_.empty()) {
+            Stack stack = pool_.back();
+            pool_.pop_back();
+            return stack;
+        }
+    }
+
+    // 按需提交物理页，大量纤程只占用实际用到的栈空间
+    void* memory = mmap(nullptr, stackSize_ + guardSize_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    // 栈向低地址增长，保护页放在最低端
+    if (guardSize_ > 0 && mprotect(memory, guardSize_, PROT_NONE) != 0) {
+        munmap(memory, stackSize_ + guardSize_);
+        throw std::bad_alloc();
+    }
+
+    mappedStacks_++;
+
+    Stack stack;
+    stack.base = static_cast<char*>(memory) + guardSize_;
+    stack.size = stackSize_;
+    return stack;
+}
+
+void FiberStackAllocator::deallocate(const Stack& stack) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pool_.size() < maxPooledStacks_) {
+            pool_.push_back(stack);
+            return;
+        }
+    }
+    unmap(stack);
+}
+
+void FiberStackAllocator::unmap(const Stack& stack) {
+    munmap(static_cast<char*>(stack.base) - guardSize_, stack.size + guardSize_);
+    mappedStacks_--;
+}
+
+size_t FiberStackAllocator::getStackSize() const {
+    return stackSize_;
+}
+
+size_t FiberStackAllocator::getGuardSize() const {
+    return guardSize_;
+}
+
+size_t FiberStackAllocator::getPooledStacks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pool_.size();
+}
+
+size_t FiberStackAllocator::getMappedStacks() const {
+    return mappedStacks_.load();
+}
+
+// FiberRuntime 实现
+FiberRuntime::FiberRuntime(ThreadPool& pool, size_t numCarriers, const FiberConfig& config)
+    : stackAllocator_(config.stackSize, config.guardPages, config.maxPooledStacks),
+      numCarriers_(numCarriers), idleCarriers_(0), stopping_(false), allFibers_(nullptr),
+      liveFibers_(0), contextSwitches_(0) {
+
+    if (numCarriers == 0) {
+        throw std::invalid_argument("FiberRuntime needs at least one carrier thread");
+    }
+
+    for (size_t i = 0; i < numCarriers; ++i) {
+        carriers_.push_back(pool.enqueue([this] { carrierLoop(); }));
+    }
+}
+
+FiberRuntime::~FiberRuntime() {
+    shutdown();
+
+    // 释放仍在等待的纤程（其栈上的对象不会被析构）
+    detail::Fiber* fiber = allFibers_;
+    while (fiber) {
+        detail::Fiber* next = fiber->next;
+        stackAllocator_.deallocate(fiber->stack);
+        delete fiber;
+        fiber = next;
+    }
+}
+
+void FiberRuntime::spawn(std::function<void()> function) {
+    {
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        if (stopping_) {
+            throw std::runtime_error("spawn on stopped FiberRuntime");
+        }
+    }
+
+    auto stack = stackAllocator_.allocate();
+
+    auto* fiber = new detail::Fiber();
+    fiber->stack = stack;
+    fiber->function = std::move(function);
+    fiber->runtime = this;
+    fiber->entry = &FiberRuntime::fiberMain;
+    initContext(fiber);
+
+    {
+        std::lock_guard<std::mutex> lock(fibersMutex_);
+        fiber->next = allFibers_;
+        if (allFibers_) {
+            allFibers_->prev = fiber;
+        }
+        allFibers_ = fiber;
+    }
+
+    liveFibers_++;
+    makeReady(fiber);
+}
+
+void FiberRuntime::waitIdle() {
+    std::unique_lock<std::mutex> lock(fibersMutex_);
+    idleCondition_.wait(lock, [this] { return liveFibers_ == 0; });
+}
+
+void FiberRuntime::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        stopping_ = true;
+    }
+    readyCondition_.notify_all();
+
+    for (auto& carrier : carriers_) {
+        if (carrier.valid()) {
+            carrier.wait();
+        }
+    }
+    carriers_.clear();
+}
+
+bool FiberRuntime::inFiber() {
+    return currentFiber() != nullptr;
+}
+
+FiberLocalState* FiberRuntime::exchangeLocalState(FiberLocalState* state) {
+    detail::Fiber* fiber = currentFiber();
+    if (!fiber) {
+        return nullptr;
+    }
+    FiberLocalState* previous = fiber->localState;
+    fiber->localState = state;
+    return previous;
+}
+
+void FiberRuntime::yield() {
+    detail::FiberCarrier* carrier = currentCarrier();
+    if (!carrier || !carrier->current) {
+        return;
+    }
+
+    detail::Fiber* self = carrier->current;
+    detail::Fiber* next = carrier->runtime->tryPopReady();
+    if (!next) {
+        return;
+    }
+
+    // 切换完成后再把自己放回就绪队列，避免被其他载体线程提前恢复
+    if (self->localState) {
+        self->localState->save();
+    }
+    carrier->readyAfterSwitch = self;
+    carrier->current = next;
+    carrier->runtime->contextSwitches_.fetch_add(1, std::memory_order_relaxed);
+    switchContext(self->context, next->context);
+    afterSwitch();
+    if (self->localState) {
+        self->localState->restore();
+    }
+}
+
+size_t FiberRuntime::getLiveFibers() const {
+    return liveFibers_.load();
+}
+
+size_t FiberRuntime::getCarrierCount() const {
+    return numCarriers_;
+}
+
+uint64_t FiberRuntime::getContextSwitches() const {
+    return contextSwitches_.load();
+}
+
+FiberStackAllocator& FiberRuntime::getStackAllocator() {
+    return stackAllocator_;
+}
+
+void FiberRuntime::carrierLoop() {
+    detail::FiberCarrier carrier;
+    carrier.runtime = this;
+    tlsCarrier = &carrier;
+
+    while (true) {
+        detail::Fiber* fiber = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(readyMutex_);
+            idleCarriers_++;
+            readyCondition_.wait(lock, [this] {
+                return stopping_ || !readyQueue_.empty();
+            });
+            idleCarriers_--;
+
+            if (readyQueue_.empty()) {
+                break;
+            }
+
+            fiber = readyQueue_.front();
+            readyQueue_.pop_front();
+        }
+
+        carrier.current = fiber;
+        contextSwitches_.fetch_add(1, std::memory_order_relaxed);
+        switchContext(carrier.schedulerContext, fiber->context);
+        afterSwitch();
+    }
+
+    tlsCarrier = nullptr;
+}
+
+void FiberRuntime::fiberMain(detail::Fiber* fiber) {
+    afterSwitch();
+
+    try {
+        fiber->function();
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in fiber: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unknown exception in fiber" << std::endl;
+    }
+
+    // 在纤程栈上释放捕获的对象
+    fiber->function = nullptr;
+
+    detail::FiberCarrier* carrier = currentCarrier();
+    carrier->destroyAfterSwitch = fiber;
+    switchOut(carrier, fiber);
+}
+
+void FiberRuntime::makeReady(detail::Fiber* fiber) {
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        readyQueue_.push_back(fiber);
+        wake = idleCarriers_ > 0;
+    }
+
+    if (wake) {
+        readyCondition_.notify_one();
+    }
+}
+
+detail::Fiber* FiberRuntime::tryPopReady() {
+    std::lock_guard<std::mutex> lock(readyMutex_);
+    if (readyQueue_.empty()) {
+        return nullptr;
+    }
+
+    detail::Fiber* fiber = readyQueue_.front();
+    readyQueue_.pop_front();
+    return fiber;
+}
+
+void FiberRuntime::park(std::mutex& guard) {
+    detail::FiberCarrier* carrier = currentCarrier();
+    carrier->unlockAfterSwitch = &guard;
+    switchOut(carrier, carrier->current);
+}
+
+void FiberRuntime::switchOut(detail::FiberCarrier* carrier, detail::Fiber* self) {
+    // 线程局部状态留在本载体线程上会被随后执行的纤程看到，挂起前取出，恢复后（可能在另一个载体线程上）写回
+    if (self->localState) {
+        self->localState->save();
+    }
+
+    detail::Fiber* next = carrier->runtime->tryPopReady();
+    carrier->current = next;
+    carrier->runtime->contextSwitches_.fetch_add(1, std::memory_order_relaxed);
+
+    // 有就绪纤程时直接切换过去，不经过载体调度上下文
+    switchContext(self->context, next ? next->context : carrier->schedulerContext);
+    afterSwitch();
+    if (self->localState) {
+        self->localState->restore();
+    }
+}
+
+void FiberRuntime::afterSwitch() {
+    detail::FiberCarrier* carrier = currentCarrier();
+
+    if (carrier->unlockAfterSwitch) {
+        std::mutex* guard = carrier->unlockAfterSwitch;
+        carrier->unlockAfterSwitch = nullptr;
+        guard->unlock();
+    }
+
+    if (carrier->readyAfterSwitch) {
+        detail::Fiber* fiber = carrier->readyAfterSwitch;
+        carrier->readyAfterSwitch = nullptr;
+        carrier->runtime->makeReady(fiber);
+    }
+
+    if (carrier->destroyAfterSwitch) {
+        detail::Fiber* fiber = carrier->destroyAfterSwitch;
+        carrier->destroyAfterSwitch = nullptr;
+        carrier->runtime->destroyFiber(fiber);
+    }
+}
+
+void FiberRuntime::destroyFiber(detail::Fiber* fiber) {
+    {
+        std::lock_guard<std::mutex> lock(fibersMutex_);
+        if (fiber->prev) {
+            fiber->prev->next = fiber->next;
+        } else {
+            allFibers_ = fiber->next;
+        }
+        if (fiber->next) {
+            fiber->next->prev = fiber->prev;
+        }
+    }
+
+    stackAllocator_.deallocate(fiber->stack);
+    delete fiber;
+
+    if (liveFibers_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(fibersMutex_);
+        idleCondition_.notify_all();
+    }
+}
+
+detail::Fiber* FiberRuntime::currentFiber() {
+    detail::FiberCarrier* carrier = currentCarrier();
+    return carrier ? carrier->current : nullptr;
+}
+
+// FiberMutex 实现
+void FiberMutex::lock() {
+    detail::Fiber* self = FiberRuntime::currentFiber();
+
+    guard_.lock();
+    if (!locked_) {
+        locked_ = true;
+        guard_.unlock();
+        return;
+    }
+
+    if (self) {
+        // 挂起纤程，unlock()会直接把锁移交给我们
+        waiters_.push_back(self);
+        FiberRuntime::park(guard_);
+        return;
+    }
+    guard_.unlock();
+
+    // 普通线程：让出CPU并重试
+    while (true) {
+        std::this_thread::yield();
+        std::lock_guard<std::mutex> lock(guard_);
+        if (!locked_) {
+            locked_ = true;
+            return;
+        }
+    }
+}
+
+bool FiberMutex::try_lock() {
+    std::lock_guard<std::mutex> lock(guard_);
+    if (locked_) {
+        return false;
+    }
+    locked_ = true;
+    return true;
+}
+
+void FiberMutex::unlock() {
+    detail::Fiber* next = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(guard_);
+        if (!waiters_.empty()) {
+            next = waiters_.front();
+            waiters_.pop_front();
+        } else {
+            locked_ = false;
+        }
+    }
+
+    if (next) {
+        next->runtime->makeReady(next);
+    }
+}
+
+// FiberCondVar 实现
+void FiberCondVar::wait(std::unique_lock<FiberMutex>& lock) {
+    FiberMutex* mutex = lock.mutex();
+    detail::Fiber* self = FiberRuntime::currentFiber();
+
+    if (self) {
+        // 先登记再释放互斥锁，notify必须获取guard_，因此不会丢失唤醒
+        guard_.lock();
+        waiters_.push_back(self);
+        mutex->unlock();
+        FiberRuntime::park(guard_);
+        mutex->lock();
+        return;
+    }
+
+    // 普通线程：等待通知代数变化
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> guard(guard_);
+        generation = generation_;
+    }
+    mutex->unlock();
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> guard(guard_);
+            if (generation_ != generation) {
+                break;
+            }
+        }
+        std::this_thread::yield();
+    }
+
+    mutex->lock();
+}
+
+void FiberCondVar::notify_one() {
+    detail::Fiber* next = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(guard_);
+        generation_++;
+        if (!waiters_.empty()) {
+            next = waiters_.front();
+            waiters_.pop_front();
+        }
+    }
+
+    if (next) {
+        next->runtime->makeReady(next);
+    }
+}
+
+void FiberCondVar::notify_all() {
+    std::deque<detail::Fiber*> waiters;
+    {
+        std::lock_guard<std::mutex> lock(guard_);
+        generation_++;
+        waiters.swap(waiters_);
+    }
+
+    for (auto* fiber : waiters) {
+        fiber->runtime->makeReady(fiber);
+    }
+}
+
+} // namespace YB
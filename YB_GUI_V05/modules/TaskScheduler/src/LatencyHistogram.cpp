@@ -0,0 +1,116 @@
+#include "../include/LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace YB {
+
+namespace {
+
+constexpr double kNanosPerMilli = 1e6;
+
+} // namespace
+
+uint64_t LatencyDistribution::bucketLowerBound(size_t index) {
+    if (index < (size_t(1) << kSubBucketBits)) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index >> kSubBucketBits) - 1;
+    uint64_t subBucket = index & ((size_t(1) << kSubBucketBits) - 1);
+    return ((uint64_t(1) << kSubBucketBits) + subBucket) << shift;
+}
+
+uint64_t LatencyDistribution::bucketUpperBound(size_t index) {
+    if (index < (size_t(1) << kSubBucketBits)) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index >> kSubBucketBits) - 1;
+    return bucketLowerBound(index) + (uint64_t(1) << shift) - 1;
+}
+
+uint64_t LatencyDistribution::count() const {
+    uint64_t total = 0;
+    for (uint64_t bucket : buckets) {
+        total += bucket;
+    }
+    return total;
+}
+
+double LatencyDistribution::percentile(double percent) const {
+    uint64_t total = count();
+    if (total == 0) {
+        return 0.0;
+    }
+
+    // 第rank个（从1计）值所在的桶
+    double clamped = std::min(std::max(percent, 0.0), 100.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return bucketUpperBound(i) / kNanosPerMilli;
+        }
+    }
+    return max();
+}
+
+double LatencyDistribution::mean() const {
+    uint64_t total = 0;
+    double sum = 0.0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        if (buckets[i] != 0) {
+            total += buckets[i];
+            sum += buckets[i] * ((bucketLowerBound(i) + bucketUpperBound(i)) / 2.0);
+        }
+    }
+    return total > 0 ? sum / total / kNanosPerMilli : 0.0;
+}
+
+double LatencyDistribution::max() const {
+    for (size_t i = buckets.size(); i > 0; --i) {
+        if (buckets[i - 1] != 0) {
+            return bucketUpperBound(i - 1) / kNanosPerMilli;
+        }
+    }
+    return 0.0;
+}
+
+void LatencyDistribution::merge(const LatencyDistribution& other) {
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        buckets[i] += other.buckets[i];
+    }
+}
+
+LatencyRecorder::Shard::~Shard() {
+    for (auto& cell : cells) {
+        delete cell.load(std::memory_order_relaxed);
+    }
+}
+
+LatencyDistribution LatencyRecorder::distribution(LatencyKind kind, std::optional<Priority> priority,
+                                                  std::optional<TaskType> type) const {
+    LatencyDistribution result;
+    shards_.forEach([&](const Shard& shard) {
+        for (size_t p = 0; p < kPriorityCount; ++p) {
+            if (priority && static_cast<size_t>(*priority) != p) {
+                continue;
+            }
+            for (size_t t = 0; t < kTaskTypeCount; ++t) {
+                if (type && static_cast<size_t>(*type) != t) {
+                    continue;
+                }
+                const Cell* cell = shard.cells[p * kTaskTypeCount + t].load(std::memory_order_acquire);
+                if (!cell) {
+                    continue;
+                }
+                const auto& buckets = cell->buckets[static_cast<size_t>(kind)];
+                for (size_t i = 0; i < LatencyDistribution::kBucketCount; ++i) {
+                    result.buckets[i] += buckets[i].load(std::memory_order_relaxed);
+                }
+            }
+        }
+    });
+    return result;
+}
+
+} // namespace YB
@@ -0,0 +1,12 @@
+#include "../include/ParallelAlgorithms.h"
+
+namespace YB {
+
+ThreadPool& defaultParallelPool() {
+    // 调用线程也参与计算，辅助线程比硬件线程少一个
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) > 1
+                               ? std::thread::hardware_concurrency() - 1 : 1);
+    return pool;
+}
+
+} // namespace YB
@@ -3,7 +3,8 @@
 
 namespace YB {
 
-PriorityQueue::PriorityQueue() : stopped_(false) {
+template<typename Order>
+TaskQueue<Order>::TaskQueue() : stopped_(false) {
     // 初始化优先级计数
     priorityCount_[Priority::CRITICAL] = 0;
     priorityCount_[Priority::HIGH] = 0;
@@ -12,11 +13,13 @@ PriorityQueue::PriorityQueue() : stopped_(false) {
     priorityCount_[Priority::BACKGROUND] = 0;
 }
 
-PriorityQueue::~PriorityQueue() {
+template<typename Order>
+TaskQueue<Order>::~TaskQueue() {
     stop();
 }
 
-void PriorityQueue::push(std::shared_ptr<Task> task) {
+template<typename Order>
+void TaskQueue<Order>::push(std::shared_ptr<Task> task) {
     if (!task) {
         throw std::invalid_argument("Cannot push null task to queue");
     }
@@ -29,10 +32,43 @@ void PriorityQueue::push(std::shared_ptr<Task> task) {
     
     queue_.push(task);
     updatePriorityCount(task->priority, 1);
-    notEmpty_.notify_one();
+    notifyOneLocked();
 }
 
-std::shared_ptr<Task> PriorityQueue::pop() {
+template<typename Order>
+void TaskQueue<Order>::pushBatch(const std::vector<std::shared_ptr<Task>>& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    for (const auto& task : tasks) {
+        if (!task) {
+            throw std::invalid_argument("Cannot push null task to queue");
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (stopped_) {
+        throw std::runtime_error("Cannot push to stopped queue");
+    }
+    
+    for (const auto& task : tasks) {
+        queue_.push(task);
+        updatePriorityCount(task->priority, 1);
+    }
+    
+    for (size_t i = 0; i < tasks.size() && !waiters_.empty(); ++i) {
+        notifyOneLocked();
+    }
+    if (tasks.size() == 1) {
+        notEmpty_.notify_one();
+    } else {
+        notEmpty_.notify_all();
+    }
+}
+
+template<typename Order>
+std::shared_ptr<Task> TaskQueue<Order>::pop() {
     std::unique_lock<std::mutex> lock(mutex_);
     
     notEmpty_.wait(lock, [this] {
@@ -50,7 +86,58 @@ std::shared_ptr<Task> PriorityQueue::pop() {
     return task;
 }
 
-std::shared_ptr<Task> PriorityQueue::tryPop() {
+template<typename Order>
+std::shared_ptr<Task> TaskQueue<Order>::pop(uint64_t wakeEpoch) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    notEmpty_.wait(lock, [this, wakeEpoch] {
+        return stopped_ || !queue_.empty() || wakeEpoch_ != wakeEpoch;
+    });
+    
+    // 停止或被唤醒但队列为空
+    if (queue_.empty()) {
+        return nullptr;
+    }
+    
+    auto task = queue_.top();
+    queue_.pop();
+    updatePriorityCount(task->priority, -1);
+    
+    return task;
+}
+
+template<typename Order>
+std::shared_ptr<Task> TaskQueue<Order>::pop(uint64_t wakeEpoch, Waiter& waiter) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    auto ready = [this, wakeEpoch, &waiter] {
+        return stopped_ || !queue_.empty() || wakeEpoch_ != wakeEpoch || waiter.signaled;
+    };
+    if (!ready()) {
+        waiter.waiting = true;
+        waiters_.push_back(&waiter);
+        waiter.condition.wait(lock, ready);
+        if (waiter.waiting) {
+            waiter.waiting = false;
+            waiters_.erase(std::find(waiters_.begin(), waiters_.end(), &waiter));
+        }
+    }
+    waiter.signaled = false;
+    
+    // 停止或被唤醒但队列为空
+    if (queue_.empty()) {
+        return nullptr;
+    }
+    
+    auto task = queue_.top();
+    queue_.pop();
+    updatePriorityCount(task->priority, -1);
+    
+    return task;
+}
+
+template<typename Order>
+std::shared_ptr<Task> TaskQueue<Order>::tryPop() {
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (queue_.empty()) {
@@ -64,16 +151,23 @@ std::shared_ptr<Task> PriorityQueue::tryPop() {
     return task;
 }
 
-std::shared_ptr<Task> PriorityQueue::popWithTimeout(std::chrono::milliseconds timeout) {
+template<typename Order>
+std::shared_ptr<Task> TaskQueue<Order>::popWithTimeout(std::chrono::milliseconds timeout) {
+    return popWithTimeout(timeout, wakeEpoch());
+}
+
+template<typename Order>
+std::shared_ptr<Task> TaskQueue<Order>::popWithTimeout(std::chrono::milliseconds timeout, uint64_t wakeEpoch) {
     std::unique_lock<std::mutex> lock(mutex_);
     
-    if (!notEmpty_.wait_for(lock, timeout, [this] {
-        return stopped_ || !queue_.empty();
+    if (!notEmpty_.wait_for(lock, timeout, [this, wakeEpoch] {
+        return stopped_ || !queue_.empty() || wakeEpoch_ != wakeEpoch;
     })) {
         return nullptr; // 超时
     }
     
-    if (stopped_ && queue_.empty()) {
+    // 停止或被唤醒但队列为空
+    if (queue_.empty()) {
         return nullptr;
     }
     
@@ -84,22 +178,23 @@ std::shared_ptr<Task> PriorityQueue::popWithTimeout(std::chrono::milliseconds ti
     return task;
 }
 
-bool PriorityQueue::empty() const {
+template<typename Order>
+bool TaskQueue<Order>::empty() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return queue_.empty();
 }
 
-size_t PriorityQueue::size() const {
+template<typename Order>
+size_t TaskQueue<Order>::size() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return queue_.size();
 }
 
-void PriorityQueue::clear() {
+template<typename Order>
+void TaskQueue<Order>::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    while (!queue_.empty()) {
-        queue_.pop();
-    }
+    queue_.assign({});
     
     // 重置优先级计数
     for (auto& pair : priorityCount_) {
@@ -107,32 +202,99 @@ void PriorityQueue::clear() {
     }
 }
 
-void PriorityQueue::stop() {
+template<typename Order>
+void TaskQueue<Order>::stop() {
     {
         std::lock_guard<std::mutex> lock(mutex_);
         stopped_ = true;
+        notifyAllLocked();
     }
     notEmpty_.notify_all();
 }
 
-void PriorityQueue::resume() {
+template<typename Order>
+void TaskQueue<Order>::wakeAll() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeEpoch_++;
+        notifyAllLocked();
+    }
+    notEmpty_.notify_all();
+}
+
+template<typename Order>
+void TaskQueue<Order>::wakeOne() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeEpoch_++;
+        notifyOneLocked();
+    }
+}
+
+template<typename Order>
+void TaskQueue<Order>::wake(Waiter& waiter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    waiter.signaled = true;
+    if (waiter.waiting) {
+        waiter.waiting = false;
+        waiters_.erase(std::find(waiters_.begin(), waiters_.end(), &waiter));
+        waiter.condition.notify_one();
+    }
+}
+
+template<typename Order>
+void TaskQueue<Order>::notifyOneLocked() {
+    // 调用方持有mutex_；优先唤醒最近开始等待的等待者，没有时唤醒在notEmpty_上等待的线程
+    if (waiters_.empty()) {
+        notEmpty_.notify_one();
+        return;
+    }
+    Waiter* waiter = waiters_.back();
+    waiters_.pop_back();
+    waiter->waiting = false;
+    waiter->signaled = true;
+    waiter->condition.notify_one();
+}
+
+template<typename Order>
+void TaskQueue<Order>::notifyAllLocked() {
+    // 调用方持有mutex_
+    for (Waiter* waiter : waiters_) {
+        waiter->waiting = false;
+        waiter->signaled = true;
+        waiter->condition.notify_one();
+    }
+    waiters_.clear();
+}
+
+template<typename Order>
+uint64_t TaskQueue<Order>::wakeEpoch() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wakeEpoch_;
+}
+
+template<typename Order>
+void TaskQueue<Order>::resume() {
     std::lock_guard<std::mutex> lock(mutex_);
     stopped_ = false;
 }
 
-bool PriorityQueue::isStopped() const {
+template<typename Order>
+bool TaskQueue<Order>::isStopped() const {
     return stopped_.load();
 }
 
-std::map<Priority, size_t> PriorityQueue::getPriorityDistribution() const {
+template<typename Order>
+std::map<Priority, size_t> TaskQueue<Order>::getPriorityDistribution() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return priorityCount_;
 }
 
-bool PriorityQueue::removeTask(TaskID taskId) {
+template<typename Order>
+bool TaskQueue<Order>::removeTask(TaskID taskId) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    // 由于std::priority_queue不支持直接删除元素，需要重建队列
+    // 堆不支持直接删除元素，需要重建队列
     std::vector<std::shared_ptr<Task>> temp;
     bool found = false;
     
@@ -149,14 +311,44 @@ bool PriorityQueue::removeTask(TaskID taskId) {
     }
     
     // 重建队列
-    for (const auto& task : temp) {
-        queue_.push(task);
-    }
+    queue_.assign(std::move(temp));
     
     return found;
 }
 
-std::vector<TaskID> PriorityQueue::getAllTaskIds() const {
+template<typename Order>
+std::vector<std::shared_ptr<Task>> TaskQueue<Order>::removeTasks(const std::unordered_set<TaskID>& taskIds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    std::vector<std::shared_ptr<Task>> removed;
+    if (taskIds.empty()) {
+        return removed;
+    }
+    
+    // 与removeTask相同，取出全部元素后重建队列，但整组只遍历一次
+    std::vector<std::shared_ptr<Task>> temp;
+    temp.reserve(queue_.size());
+    
+    while (!queue_.empty()) {
+        auto task = queue_.top();
+        queue_.pop();
+        
+        if (taskIds.count(task->id)) {
+            updatePriorityCount(task->priority, -1);
+            removed.push_back(task);
+        } else {
+            temp.push_back(task);
+        }
+    }
+    
+    // 重建队列
+    queue_.assign(std::move(temp));
+    
+    return removed;
+}
+
+template<typename Order>
+std::vector<TaskID> TaskQueue<Order>::getAllTaskIds() const {
     std::lock_guard<std::mutex> lock(mutex_);
     std::vector<TaskID> ids;
     
@@ -171,11 +363,15 @@ std::vector<TaskID> PriorityQueue::getAllTaskIds() const {
     return ids;
 }
 
-void PriorityQueue::updatePriorityCount(Priority priority, int delta) {
+template<typename Order>
+void TaskQueue<Order>::updatePriorityCount(Priority priority, int delta) {
     priorityCount_[priority] += delta;
     if (priorityCount_[priority] < 0) {
         priorityCount_[priority] = 0;
     }
 }
 
-} // namespace YB
\ No newline at end of file
+template class TaskQueue<HeapOrder>;
+template class TaskQueue<FifoOrder>;
+
+} // namespace YB
@@ -0,0 +1,137 @@
+#include "../include/ResultRing.h"
+#include <algorithm>
+#include <mutex>
+
+namespace YB {
+
+ResultRing::ResultRing(size_t capacity)
+    : slots_(std::make_unique<Slot[]>(capacityFor(capacity))),
+      capacity_(capacityFor(capacity)),
+      mask_(capacity_ - 1) {
+}
+
+size_t ResultRing::capacityFor(size_t requested) {
+    size_t capacity = 1;
+    while (capacity < requested) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+std::shared_ptr<const TaskResult> ResultRing::load(uint64_t sequence, bool* overwritten) const {
+    const Slot& slot = slots_[sequence & mask_];
+    std::shared_ptr<const TaskResult> result;
+
+    // 序号不符时不加锁，写入方追上覆盖的槽位直接跳过
+    uint64_t stamp = slot.sequence.load(std::memory_order_acquire);
+    if (stamp == sequence + 1) {
+        std::lock_guard<SpinLock> lock(slot.lock);
+        stamp = slot.sequence.load(std::memory_order_relaxed);
+        if (stamp == sequence + 1) {
+            result = slot.result;
+        }
+    }
+
+    if (!result && overwritten) {
+        *overwritten = stamp != 0;
+    }
+    return result;
+}
+
+std::shared_ptr<const void> ResultRing::push(TaskResult result) {
+    uint64_t sequence = head_.load(std::memory_order_relaxed);
+    TaskID id = result.taskId;
+    auto entry = std::make_shared<const TaskResult>(std::move(result));
+
+    // 先放入槽位再发布序号，读到head的读取方一定能看到该结果；被覆盖的结果交给调用方销毁
+    Slot& slot = slots_[sequence & mask_];
+    {
+        std::lock_guard<SpinLock> lock(slot.lock);
+        entry.swap(slot.result);
+        slot.id.store(id, std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_release);
+    }
+
+    head_.store(sequence + 1, std::memory_order_release);
+    return entry;
+}
+
+size_t ResultRing::read(ResultCursor& cursor, const std::function<void(const TaskResult&)>& callback,
+                        size_t maxResults) const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t sequence = std::max(cursor.next, floor_.load(std::memory_order_acquire));
+
+    // 落后超过一圈：最早的结果已被覆盖
+    if (head - sequence > capacity_) {
+        cursor.missed += head - capacity_ - sequence;
+        sequence = head - capacity_;
+    }
+
+    size_t count = 0;
+    for (; sequence < head && count < maxResults; ++sequence) {
+        bool overwritten = false;
+        auto result = load(sequence, &overwritten);
+        if (!result) {
+            if (overwritten) {
+                cursor.missed++;    // 读取期间被写入方追上覆盖
+            }
+            continue;               // 否则是读取期间被clear
+        }
+        callback(*result);
+        ++count;
+    }
+    cursor.next = sequence;
+    return count;
+}
+
+std::shared_ptr<const TaskResult> ResultRing::find(TaskID id) const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t floor = std::max<uint64_t>(floor_.load(std::memory_order_acquire),
+                                        head > capacity_ ? head - capacity_ : 0);
+    for (uint64_t sequence = head; sequence > floor; --sequence) {
+        if (slots_[(sequence - 1) & mask_].id.load(std::memory_order_acquire) != id) {
+            continue;
+        }
+        auto result = load(sequence - 1);
+        if (result && result->taskId == id) {
+            return result;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<TaskResult> ResultRing::snapshot() const {
+    std::vector<TaskResult> results;
+    ResultCursor cursor;
+    read(cursor, [&results](const TaskResult& result) { results.push_back(result); }, capacity_);
+    return results;
+}
+
+std::vector<std::shared_ptr<const void>> ResultRing::clear() {
+    std::vector<std::shared_ptr<const void>> dropped;
+    for (size_t i = 0; i < capacity_; ++i) {
+        Slot& slot = slots_[i];
+        std::shared_ptr<const TaskResult> result;
+        {
+            std::lock_guard<SpinLock> lock(slot.lock);
+            result.swap(slot.result);
+            slot.id.store(0, std::memory_order_relaxed);
+            slot.sequence.store(0, std::memory_order_release);
+        }
+        if (result) {
+            dropped.push_back(std::move(result));
+        }
+    }
+    floor_.store(head_.load(std::memory_order_relaxed), std::memory_order_release);
+    return dropped;
+}
+
+uint64_t ResultRing::head() const {
+    return head_.load(std::memory_order_acquire);
+}
+
+size_t ResultRing::capacity() const {
+    return capacity_;
+}
+
+} // namespace YB
@@ -0,0 +1,186 @@
+#include "../include/SharedExecutor.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+
+namespace YB {
+
+SharedExecutor::SharedExecutor(size_t maxThreads)
+    : maxThreads_(std::max<size_t>(1, maxThreads)),
+      sources_(std::make_shared<const std::vector<std::shared_ptr<Source>>>()),
+      sourcesVersion_(0), nextSourceId_(1), notifyGeneration_(0), idleWorkers_(0),
+      cursor_(0), stop_(false), tasksExecuted_(0) {
+
+    threadPool_ = std::make_unique<ThreadPool>(maxThreads_);
+
+    // 任务阻塞时由补偿线程接替运行执行器循环
+    threadPool_->setCompensationTask([this] { workerLoop(); });
+
+    for (size_t i = 0; i < maxThreads_; ++i) {
+        threadPool_->enqueue([this] { workerLoop(); });
+    }
+}
+
+SharedExecutor::~SharedExecutor() {
+    stop();
+    threadPool_.reset();
+}
+
+std::shared_ptr<SharedExecutor> SharedExecutor::processDefault() {
+    static std::shared_ptr<SharedExecutor> instance = std::make_shared<SharedExecutor>();
+    return instance;
+}
+
+SharedExecutor::SourceId SharedExecutor::attach(const std::string& name, std::function<bool()> runOne) {
+    auto source = std::make_shared<Source>();
+    source->name = name;
+    source->runOne = std::move(runOne);
+
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        source->id = nextSourceId_++;
+
+        auto sources = std::make_shared<std::vector<std::shared_ptr<Source>>>(*sources_);
+        sources->push_back(source);
+        sources_ = sources;
+        sourcesVersion_++;
+    }
+
+    // 新来源可能已有排队任务
+    notify();
+    return source->id;
+}
+
+void SharedExecutor::detach(SourceId id) {
+    std::unique_lock<std::mutex> lock(sourcesMutex_);
+
+    auto sources = std::make_shared<std::vector<std::shared_ptr<Source>>>(*sources_);
+    auto it = std::find_if(sources->begin(), sources->end(),
+        [id](const std::shared_ptr<Source>& source) { return source->id == id; });
+    if (it == sources->end()) {
+        return;
+    }
+
+    std::shared_ptr<Source> source = *it;
+    source->detached = true;
+    sources->erase(it);
+    sources_ = sources;
+    sourcesVersion_++;
+
+    // 等待正在执行该来源任务的工作线程返回
+    detachCondition_.wait(lock, [&source] { return source->activeRuns == 0; });
+}
+
+void SharedExecutor::notify() {
+    notifyGeneration_++;
+
+    bool hasIdle;
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        hasIdle = idleWorkers_ > 0;
+    }
+
+    if (hasIdle) {
+        idleCondition_.notify_one();
+    }
+}
+
+ExecutorMetrics SharedExecutor::getMetrics() const {
+    ExecutorMetrics metrics;
+    metrics.maxThreads = maxThreads_;
+    metrics.poolThreads = threadPool_->getPoolSize() + threadPool_->getCompensationThreads();
+    metrics.processPoolThreads = ThreadPool::getProcessThreadCount();
+    metrics.hardwareConcurrency = std::max(1u, std::thread::hardware_concurrency());
+    metrics.oversubscription = static_cast<double>(metrics.processPoolThreads) / metrics.hardwareConcurrency;
+    metrics.tasksExecuted = tasksExecuted_.load();
+
+    std::shared_ptr<const std::vector<std::shared_ptr<Source>>> sources;
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        sources = sources_;
+    }
+
+    metrics.attachedSources = sources->size();
+    for (const auto& source : *sources) {
+        metrics.tasksPerSource.emplace_back(source->name, source->tasksExecuted.load());
+    }
+
+    return metrics;
+}
+
+ThreadPool& SharedExecutor::getThreadPool() {
+    return *threadPool_;
+}
+
+void SharedExecutor::stop() {
+    stop_ = true;
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        notifyGeneration_++;
+    }
+    idleCondition_.notify_all();
+
+    if (threadPool_) {
+        threadPool_->stop();
+    }
+}
+
+void SharedExecutor::workerLoop() {
+    std::shared_ptr<const std::vector<std::shared_ptr<Source>>> sources;
+    uint64_t version = 0;
+    bool haveSnapshot = false;
+
+    while (!stop_ && !ThreadPool::currentThreadShouldRetire()) {
+        uint64_t generation = notifyGeneration_.load();
+
+        // 来源列表变化时刷新本地快照
+        if (!haveSnapshot || version != sourcesVersion_) {
+            std::lock_guard<std::mutex> lock(sourcesMutex_);
+            sources = sources_;
+            version = sourcesVersion_;
+            haveSnapshot = true;
+        }
+
+        if (runOneTask(*sources)) {
+            continue;
+        }
+
+        // 没有任务时等待通知；定时醒来以便补偿线程及时退役
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        idleWorkers_++;
+        idleCondition_.wait_for(lock, std::chrono::milliseconds(100), [this, generation, version] {
+            return stop_ || notifyGeneration_ != generation || sourcesVersion_ != version;
+        });
+        idleWorkers_--;
+    }
+}
+
+bool SharedExecutor::runOneTask(const std::vector<std::shared_ptr<Source>>& sources) {
+    size_t count = sources.size();
+    if (count == 0) {
+        return false;
+    }
+
+    // 轮转起点，使各调度器公平分享工作线程
+    size_t start = cursor_.fetch_add(1, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto& source = sources[(start + i) % count];
+
+        source->activeRuns++;
+        bool ran = !source->detached && source->runOne();
+        if (--source->activeRuns == 0 && source->detached) {
+            std::lock_guard<std::mutex> lock(sourcesMutex_);
+            detachCondition_.notify_all();
+        }
+
+        if (ran) {
+            source->tasksExecuted++;
+            tasksExecuted_++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace YB
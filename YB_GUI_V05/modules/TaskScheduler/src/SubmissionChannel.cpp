@@ -0,0 +1,35 @@
+#include "../include/SubmissionChannel.h"
+
+namespace YB {
+
+SubmissionChannel::SubmissionChannel(TaskScheduler& scheduler, size_t capacity)
+    : scheduler_(scheduler), ring_(capacity) {
+    scheduler_.attachChannel(this);
+}
+
+SubmissionChannel::~SubmissionChannel() {
+    // 未取出的任务交给调度器后再解除注册
+    scheduler_.detachChannel(this);
+}
+
+TaskID SubmissionChannel::submit(TaskType type, Priority priority, std::function<TaskResult()> function) {
+    return submit(std::make_shared<Task>(0, type, priority, std::move(function)));
+}
+
+TaskID SubmissionChannel::submit(std::shared_ptr<Task> task) {
+    return scheduler_.submitToChannel(*this, std::move(task));
+}
+
+size_t SubmissionChannel::pending() const {
+    return ring_.size();
+}
+
+bool SubmissionChannel::tryPush(std::shared_ptr<Task>& task) {
+    return ring_.tryPush(task);
+}
+
+void SubmissionChannel::drainTo(std::vector<std::shared_ptr<Task>>& out) {
+    ring_.drainTo(out);
+}
+
+} // namespace YB
@@ -0,0 +1,358 @@
+#include "../include/TaskGraph.h"
+
+namespace YB {
+
+TaskGraph::TaskGraph(TaskScheduler& scheduler) : scheduler_(scheduler) {
+}
+
+TaskGraph::~TaskGraph() {
+    // 节点任务引用了本对象，等待仍在进行的run结束
+    std::lock_guard<std::mutex> lock(runMutex_);
+}
+
+TaskGraph::NodeID TaskGraph::addNode(NodeFunction function, Priority priority) {
+    Node node;
+    node.function = std::move(function);
+    return addTaskNode(std::move(node), priority);
+}
+
+TaskGraph::NodeID TaskGraph::addValueNode(ValueFunction function, Priority priority) {
+    Node node;
+    node.valueFunction = std::move(function);
+    return addTaskNode(std::move(node), priority);
+}
+
+TaskGraph::NodeID TaskGraph::addTaskNode(Node node, Priority priority) {
+    NodeID index = nodes_.size();
+
+    node.task = std::make_shared<Task>(0, TaskType::USER_DEFINED, priority, [this, index] {
+        runNode(index);
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    node.task->detached = true;
+
+    // 关闭时仍在队列中的节点被通知取消，其后继随之跳过
+    node.task->onComplete = [this, index](const TaskResult&) {
+        recordError("Task graph node cancelled");
+        finishNode(index, false);
+    };
+
+    nodes_.push_back(std::move(node));
+    prepared_ = false;
+    return index;
+}
+
+bool TaskGraph::addEdge(NodeID from, NodeID to) {
+    if (from >= nodes_.size() || to >= nodes_.size() || from == to) {
+        return false;
+    }
+
+    nodes_[from].successors.push_back(to);
+    nodes_[to].predecessors.push_back(from);
+    nodes_[to].valid = false;
+    prepared_ = false;
+    return true;
+}
+
+bool TaskGraph::prepare() {
+    if (prepared_) {
+        return true;
+    }
+
+    size_t count = nodes_.size();
+    successorOffset_.assign(count + 1, 0);
+    successorIndex_.clear();
+    indegree_.assign(count, 0);
+    for (NodeID i = 0; i < count; ++i) {
+        successorOffset_[i] = successorIndex_.size();
+        for (NodeID successor : nodes_[i].successors) {
+            successorIndex_.push_back(successor);
+            indegree_[successor]++;
+        }
+    }
+    successorOffset_[count] = successorIndex_.size();
+
+    roots_.clear();
+    for (NodeID i = 0; i < count; ++i) {
+        if (indegree_[i] == 0) {
+            roots_.push_back(i);
+        }
+    }
+
+    // 按拓扑顺序遍历一遍，遍历不到的节点在环上
+    std::vector<size_t> remaining = indegree_;
+    std::vector<NodeID> ready = roots_;
+    size_t visited = 0;
+    while (!ready.empty()) {
+        NodeID current = ready.back();
+        ready.pop_back();
+        visited++;
+        for (size_t edge = successorOffset_[current]; edge < successorOffset_[current + 1]; ++edge) {
+            if (--remaining[successorIndex_[edge]] == 0) {
+                ready.push_back(successorIndex_[edge]);
+            }
+        }
+    }
+    if (visited != count) {
+        recordError("Task graph has a cycle");
+        return false;
+    }
+
+    // 输出的地址在nodes_扩容后才稳定，每次重建
+    for (Node& node : nodes_) {
+        node.inputs.clear();
+        for (NodeID predecessor : node.predecessors) {
+            node.inputs.push_back(&nodes_[predecessor].output);
+        }
+    }
+
+    states_ = std::make_unique<NodeState[]>(count);
+    inRun_.assign(count, 0);
+    prepared_ = true;
+    return true;
+}
+
+bool TaskGraph::run(std::any params) {
+    std::lock_guard<std::mutex> runLock(runMutex_);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_.clear();
+    }
+    failed_ = false;
+
+    if (!prepare()) {
+        return false;
+    }
+    if (nodes_.empty()) {
+        return true;
+    }
+    if (!scheduler_.isRunning()) {
+        recordError("Scheduler is not running");
+        return false;
+    }
+
+    // 重置计数后放出入度为0的节点；增量模式下只涉及脏节点及其下游
+    const std::vector<NodeID>* roots = &roots_;
+    size_t runCount = nodes_.size();
+    if (incremental_) {
+        collectDirtyNodes();
+        roots = &runRoots_;
+        runCount = runNodes_.size();
+    } else {
+        for (NodeID i = 0; i < nodes_.size(); ++i) {
+            states_[i].remaining.store(indegree_[i], std::memory_order_relaxed);
+            states_[i].skipped.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    nodesRun_.store(0, std::memory_order_relaxed);
+    nodesSkipped_.store(0, std::memory_order_relaxed);
+    if (runCount == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.runs++;
+        stats_.nodesReused += nodes_.size();
+        stats_.lastRunNodesRun = 0;
+        stats_.lastRunNodesReused = nodes_.size();
+        return true;
+    }
+
+    params_ = std::move(params);
+    pending_.store(runCount, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = true;
+    }
+    for (NodeID root : *roots) {
+        nodes_[root].task->submitTime = std::chrono::steady_clock::now();
+        scheduler_.requeueTask(nodes_[root].task);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // 不在工作线程上时直接等待，在工作线程上等待时帮忙执行（节点可能排在本线程之后）
+        if (!scheduler_.canHelp()) {
+            finished_.wait(lock, [this] { return !running_; });
+        } else {
+            while (running_) {
+                lock.unlock();
+                bool helped = scheduler_.helpOneTask();
+                lock.lock();
+
+                if (!helped) {
+                    finished_.wait_for(lock, std::chrono::milliseconds(1), [this] { return !running_; });
+                }
+            }
+        }
+
+        size_t reused = nodes_.size() - runCount;
+        stats_.runs++;
+        stats_.nodesRun += nodesRun_.load();
+        stats_.nodesReused += reused;
+        stats_.nodesSkipped += nodesSkipped_.load();
+        stats_.lastRunNodesRun = nodesRun_.load();
+        stats_.lastRunNodesReused = reused;
+    }
+
+    params_ = std::any();
+    return !failed_;
+}
+
+std::string TaskGraph::lastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void TaskGraph::setIncremental(bool enabled) {
+    incremental_ = enabled;
+}
+
+void TaskGraph::setFingerprint(NodeID node, uint64_t fingerprint) {
+    if (node < nodes_.size()) {
+        nodes_[node].fingerprint = fingerprint;
+    }
+}
+
+void TaskGraph::invalidate(NodeID node) {
+    if (node < nodes_.size()) {
+        nodes_[node].valid = false;
+    }
+}
+
+const std::any& TaskGraph::output(NodeID node) const {
+    return nodes_.at(node).output;
+}
+
+TaskGraphStats TaskGraph::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void TaskGraph::collectDirtyNodes() {
+    // 脏节点：上次未成功执行、被invalidate或指纹改变；runNodes_兼作工作表，依次收集其全部下游
+    runNodes_.clear();
+    runRoots_.clear();
+    for (NodeID i = 0; i < nodes_.size(); ++i) {
+        const Node& node = nodes_[i];
+        if (!node.valid || node.fingerprint != node.executedFingerprint) {
+            inRun_[i] = 1;
+            runNodes_.push_back(i);
+        }
+    }
+    for (size_t next = 0; next < runNodes_.size(); ++next) {
+        NodeID current = runNodes_[next];
+        for (size_t edge = successorOffset_[current]; edge < successorOffset_[current + 1]; ++edge) {
+            NodeID successor = successorIndex_[edge];
+            if (!inRun_[successor]) {
+                inRun_[successor] = 1;
+                runNodes_.push_back(successor);
+            }
+        }
+    }
+
+    // 收集的节点对下游封闭，计数只算收集到的前驱，干净的前驱保留上次的输出
+    for (NodeID node : runNodes_) {
+        states_[node].remaining.store(0, std::memory_order_relaxed);
+        states_[node].skipped.store(false, std::memory_order_relaxed);
+    }
+    for (NodeID node : runNodes_) {
+        for (size_t edge = successorOffset_[node]; edge < successorOffset_[node + 1]; ++edge) {
+            states_[successorIndex_[edge]].remaining.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    for (NodeID node : runNodes_) {
+        inRun_[node] = 0;
+        if (states_[node].remaining.load(std::memory_order_relaxed) == 0) {
+            runRoots_.push_back(node);
+        }
+    }
+}
+
+void TaskGraph::runNode(NodeID index) {
+    while (index != kNoNode) {
+        Node& node = nodes_[index];
+        bool succeeded = true;
+        try {
+            if (node.valueFunction) {
+                node.output = node.valueFunction(params_, node.inputs);
+            } else {
+                node.function(params_);
+            }
+            node.executedFingerprint = node.fingerprint;
+            node.valid = true;
+        } catch (const std::exception& e) {
+            recordError(e.what());
+            succeeded = false;
+        } catch (...) {
+            recordError("Unknown exception occurred");
+            succeeded = false;
+        }
+        nodesRun_.fetch_add(1, std::memory_order_relaxed);
+
+        index = finishNode(index, succeeded);
+    }
+}
+
+TaskGraph::NodeID TaskGraph::finishNode(NodeID index, bool succeeded) {
+    // 暂停或关闭时不在本线程上接着执行，交给队列处理
+    bool continueHere = succeeded && scheduler_.isRunning() && !scheduler_.isPaused();
+    NodeID next = kNoNode;
+
+    // 被跳过的后继在这里逐个结束，不递归
+    std::vector<NodeID> skipped;
+    NodeID current = index;
+    bool currentSucceeded = succeeded;
+    while (true) {
+        if (!currentSucceeded) {
+            nodes_[current].valid = false;
+            if (current != index) {
+                nodesSkipped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        for (size_t edge = successorOffset_[current]; edge < successorOffset_[current + 1]; ++edge) {
+            NodeID successor = successorIndex_[edge];
+            NodeState& state = states_[successor];
+            if (!currentSucceeded) {
+                state.skipped.store(true);
+            }
+            if (state.remaining.fetch_sub(1) != 1) {
+                continue;
+            }
+
+            if (state.skipped.load()) {
+                skipped.push_back(successor);
+            } else if (next == kNoNode && continueHere) {
+                next = successor;
+            } else {
+                nodes_[successor].task->submitTime = std::chrono::steady_clock::now();
+                scheduler_.requeueTask(nodes_[successor].task);
+            }
+        }
+
+        // 最后一个节点结束：通知run返回，之后不能再访问本对象
+        if (pending_.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+            finished_.notify_all();
+            return kNoNode;
+        }
+
+        if (skipped.empty()) {
+            return next;
+        }
+        current = skipped.back();
+        skipped.pop_back();
+        currentSucceeded = false;
+    }
+}
+
+void TaskGraph::recordError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_.empty()) {
+        error_ = error;
+    }
+    failed_ = true;
+}
+
+} // namespace YB
@@ -0,0 +1,125 @@
+#include "../include/TaskGroup.h"
+
+namespace YB {
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler) : scheduler_(scheduler) {
+}
+
+TaskGroup::~TaskGroup() {
+    // 完成回调引用了本对象，必须等所有任务结束
+    wait();
+}
+
+TaskID TaskGroup::run(TaskType type, Priority priority, std::function<TaskResult()> function) {
+    return run(std::make_shared<Task>(0, type, priority, std::move(function)));
+}
+
+TaskID TaskGroup::run(std::shared_ptr<Task> task) {
+    if (!task) {
+        return 0;
+    }
+
+    task->onComplete = [this](const TaskResult& result) { onTaskComplete(result); };
+
+    // 先计入待完成数：CALLER_RUNS策略下任务会在submitTask内直接执行完
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stats_.submitted == 0) {
+            firstSubmit_ = std::chrono::steady_clock::now();
+        }
+        stats_.submitted++;
+        stats_.pending++;
+    }
+
+    TaskID taskId = scheduler_.submitTask(task);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (taskId == 0) {
+        stats_.submitted--;
+        stats_.pending--;
+        if (stats_.pending == 0) {
+            done_.notify_all();
+        }
+    } else {
+        members_.push_back(taskId);
+    }
+    return taskId;
+}
+
+void TaskGroup::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // 不在工作线程上时直接等待计数归零
+    if (!scheduler_.canHelp()) {
+        done_.wait(lock, [this] { return stats_.pending == 0; });
+        return;
+    }
+
+    // 在工作线程上等待时帮忙执行，避免组内任务排在自己后面而死锁
+    while (stats_.pending > 0) {
+        lock.unlock();
+        bool helped = scheduler_.helpOneTask();
+        lock.lock();
+
+        if (!helped) {
+            done_.wait_for(lock, std::chrono::milliseconds(1), [this] { return stats_.pending == 0; });
+        }
+    }
+}
+
+bool TaskGroup::waitFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return done_.wait_for(lock, timeout, [this] { return stats_.pending == 0; });
+}
+
+size_t TaskGroup::cancelAll() {
+    std::vector<TaskID> members;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        members = members_;
+    }
+
+    // 被取消的任务通过完成回调计数
+    return scheduler_.cancelTasks(members);
+}
+
+TaskGroupStats TaskGroup::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    TaskGroupStats stats = stats_;
+    if (stats.submitted > 0) {
+        auto end = stats.pending > 0 ? std::chrono::steady_clock::now() : lastCompletion_;
+        stats.wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - firstSubmit_);
+
+        auto seconds = std::chrono::duration<double>(end - firstSubmit_).count();
+        size_t finished = stats.completed + stats.failed + stats.cancelled;
+        if (seconds > 0) {
+            stats.throughput = finished / seconds;
+        }
+    }
+    return stats;
+}
+
+void TaskGroup::onTaskComplete(const TaskResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    switch (result.status) {
+        case ResultStatus::SUCCESS:
+            stats_.completed++;
+            break;
+        case ResultStatus::CANCELLED:
+            stats_.cancelled++;
+            break;
+        default:
+            stats_.failed++;
+            break;
+    }
+    stats_.totalExecutionTime += result.executionTime;
+    lastCompletion_ = std::chrono::steady_clock::now();
+
+    if (--stats_.pending == 0) {
+        done_.notify_all();
+    }
+}
+
+} // namespace YB
@@ -1,13 +1,185 @@
 #include "../include/TaskScheduler.h"
 #include "../include/ThreadPool.h"
 #include "../include/PriorityQueue.h"
+#include "../include/TaskTable.h"
+#include "../include/ResultRing.h"
+#include "../include/LatencyHistogram.h"
+#include "../include/MetricCounters.h"
+#include "../include/DeadlineHeap.h"
+#include "../include/ThreadPriority.h"
+#include "../include/Fiber.h"
+#include "../include/SharedExecutor.h"
+#include "../include/SubmissionChannel.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <unordered_set>
 
 namespace YB {
 
+namespace {
+// 当前线程正在执行的任务优先级
+thread_local Priority tlsTaskPriority = Priority::NORMAL;
+
+// 当前线程正在执行哪个调度器的任务，以及等待中嵌套帮忙执行的层数
+thread_local const void* tlsCurrentScheduler = nullptr;
+thread_local size_t tlsHelpDepth = 0;
+
+// 当前线程正在执行的任务（供currentTaskTimedOut查询）
+thread_local const Task* tlsCurrentTask = nullptr;
+
+// 当前线程是哪个调度器的第几个常驻工作线程（对应其亲和队列）
+thread_local const void* tlsAffinityScheduler = nullptr;
+thread_local size_t tlsAffinitySlot = 0;
+
+// 合并提交的槽位数（位图为64位），以及各生产者线程首选的槽位
+constexpr size_t kSubmitSlots = 64;
+std::atomic<size_t> nextProducerSlot{0};
+thread_local size_t tlsProducerSlot = nextProducerSlot.fetch_add(1) % kSubmitSlots;
+constexpr int kCombinerSpins = 16;
+
+// 当前线程最近使用过的提交通道，直接提交前先取出其中的任务以保持顺序
+thread_local const SubmissionChannel* tlsProducerChannel = nullptr;
+
+// 帮忙执行的最大嵌套层数，防止等待链过长时栈溢出
+constexpr size_t kMaxHelpDepth = 256;
+
+constexpr size_t kTaskTypeCount = static_cast<size_t>(TaskType::USER_DEFINED) + 1;
+
+// 没有到期任务时超时线程最长的等待时间，期间也回收超过保留时长的记录
+constexpr std::chrono::milliseconds kTimeoutIdleWait(100);
+
+const char* const kQueueTimeoutMessage = "Task queue timeout";
+const char* const kExecutionTimeoutMessage = "Task execution timeout";
+
+TaskResult timeoutResult(TaskID taskId, const char* message) {
+    TaskResult result(taskId, ResultStatus::TIMEOUT);
+    result.errorMessage = message;
+    result.completionTime = std::chrono::steady_clock::now();
+    return result;
+}
+}
+
+TaskPriorityScope::TaskPriorityScope(Priority priority) : previous_(tlsTaskPriority) {
+    tlsTaskPriority = priority;
+}
+
+TaskPriorityScope::~TaskPriorityScope() {
+    tlsTaskPriority = previous_;
+}
+
+Priority currentTaskPriority() {
+    return tlsTaskPriority;
+}
+
+namespace {
+// 任务执行期间的线程局部状态（优先级、所属调度器、当前任务），析构时恢复进入前的值。
+// 纤程任务挂起时把这些值交还给载体线程，在另一个载体线程上恢复后重新写入；
+// 嵌套执行的任务（例如纤程内在调用线程上执行的任务）按层次逐层保存和恢复
+class TaskContextScope : public FiberLocalState {
+public:
+    TaskContextScope(const void* scheduler, const Task* task)
+        : inner_{task->priority, scheduler, task}, outer_(current()) {
+        install(inner_);
+        previous_ = FiberRuntime::exchangeLocalState(this);
+    }
+
+    ~TaskContextScope() override {
+        FiberRuntime::exchangeLocalState(previous_);
+        install(outer_);
+    }
+
+    void save() override {
+        inner_ = current();
+        install(outer_);
+        if (previous_) {
+            previous_->save();
+        }
+    }
+
+    void restore() override {
+        if (previous_) {
+            previous_->restore();
+        }
+        outer_ = current();
+        install(inner_);
+    }
+
+private:
+    struct Values {
+        Priority priority;
+        const void* scheduler;
+        const Task* task;
+    };
+
+    // 纤程可能在另一个载体线程上恢复，禁止编译器跨任务函数调用缓存线程局部变量地址
+    __attribute__((noinline)) static Values current() {
+        asm volatile("");
+        return Values{tlsTaskPriority, tlsCurrentScheduler, tlsCurrentTask};
+    }
+
+    __attribute__((noinline)) static void install(const Values& values) {
+        asm volatile("");
+        tlsTaskPriority = values.priority;
+        tlsCurrentScheduler = values.scheduler;
+        tlsCurrentTask = values.task;
+    }
+
+    Values inner_;
+    Values outer_;
+    FiberLocalState* previous_ = nullptr;
+};
+}
+
+// gang任务的集结与执行状态（受gangMutex_保护）
+struct GangState {
+    std::shared_ptr<Task> task;
+    size_t parts = 0;
+    std::function<void(size_t, size_t)> function;
+    size_t joined = 0;        // 已加入的线程数（含发起者）
+    size_t finished = 0;      // 已结束的部分数
+    bool started = false;
+    bool aborted = false;
+    std::string error;        // 第一个失败部分的错误信息
+};
+
+// 某个线程上各TaskType的工作线程上下文，只由该线程读写
+struct WorkerContextSlots {
+    struct Slot {
+        std::unique_ptr<WorkerContext> context;
+        uint64_t generation = 0;   // 创建时工厂的版本号
+        bool inUse = false;        // 正在被该线程上的任务使用
+    };
+    Slot slots[kTaskTypeCount];
+};
+
+// 常驻工作线程的软亲和队列
+template<typename Queue>
+struct AffinitySlot {
+    Queue queue;
+    QueueWaiter waiter;                // 该线程在全局队列上等待时使用，可以被单独唤醒
+    std::atomic<bool> idle{false};     // 该线程正阻塞在全局队列上等待
+    std::atomic<bool> retired{true};   // 没有工作循环负责，任务改入全局队列
+};
+
+// 合并提交：生产者把任务发布到自己的槽位并在位图中置位，
+// 拿到合并锁的线程一次性登记和入队所有已发布的任务，其余生产者等待完成标志
+struct alignas(64) SubmitSlot {
+    std::atomic<bool> owned{false};   // 被某个生产者占用
+    std::atomic<bool> done{false};    // 合并者已处理完该请求
+    std::shared_ptr<Task> task;
+    std::exception_ptr error;
+};
+
+struct SubmitCombiner {
+    std::mutex mutex;                              // 合并锁
+    alignas(64) std::atomic<uint64_t> pending{0};  // 已发布待处理的槽位位图
+    SubmitSlot slots[kSubmitSlots];
+    std::vector<std::shared_ptr<Task>> batch;      // 以下由合并者复用
+    std::vector<size_t> batchSlots;
+};
+
 // 工具函数实现
 std::string priorityToString(Priority priority) {
     switch (priority) {
@@ -52,30 +224,50 @@ Priority stringToPriority(const std::string& str) {
     return Priority::NORMAL; // 默认值
 }
 
-// TaskScheduler 构造函数和析构函数
-TaskScheduler::TaskScheduler() 
-    : running_(false), paused_(false), nextTaskId_(1) {
+// BasicScheduler 构造函数和析构函数
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::BasicScheduler() 
+    : running_(false), paused_(false), nextTaskId_(1),
+      osPriorityMapping_(false), realtimeScheduling_(false),
+      rejectionPolicy_(RejectionPolicy::UNBOUNDED), maxQueueSize_(0),
+      taskTable_(std::make_unique<TaskTable>()),
+      completedTasks_(std::make_unique<ResultPolicy>(SchedulerConfig().completedResultCapacity)),
+      latencies_(std::make_unique<LatencyRecorder>()),
+      counters_(std::make_unique<MetricsPolicy>()),
+      deadlines_(std::make_unique<DeadlineHeap>()),
+      submitCombiner_(std::make_unique<SubmitCombiner>()) {
     config_ = SchedulerConfig();
     startTime_ = std::chrono::steady_clock::now();
     currentMetrics_ = PerformanceMetrics();
     currentMetrics_.lastUpdateTime = startTime_;
 }
 
-TaskScheduler::TaskScheduler(const SchedulerConfig& config) 
-    : config_(config), running_(false), paused_(false), nextTaskId_(1) {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::BasicScheduler(const SchedulerConfig& config) 
+    : config_(config), running_(false), paused_(false), nextTaskId_(1),
+      osPriorityMapping_(false), realtimeScheduling_(false),
+      rejectionPolicy_(RejectionPolicy::UNBOUNDED), maxQueueSize_(0),
+      taskTable_(std::make_unique<TaskTable>()),
+      completedTasks_(std::make_unique<ResultPolicy>(SchedulerConfig().completedResultCapacity)),
+      latencies_(std::make_unique<LatencyRecorder>()),
+      counters_(std::make_unique<MetricsPolicy>()),
+      deadlines_(std::make_unique<DeadlineHeap>()),
+      submitCombiner_(std::make_unique<SubmitCombiner>()) {
     startTime_ = std::chrono::steady_clock::now();
     currentMetrics_ = PerformanceMetrics();
     currentMetrics_.lastUpdateTime = startTime_;
 }
 
-TaskScheduler::~TaskScheduler() {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::~BasicScheduler() {
     if (running_) {
         shutdown();
     }
 }
 
 // 初始化和生命周期管理
-bool TaskScheduler::initialize(const SchedulerConfig& config) {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::initialize(const SchedulerConfig& config) {
     std::lock_guard<std::mutex> lock(configMutex_);
     
     if (running_) {
@@ -83,6 +275,24 @@ bool TaskScheduler::initialize(const SchedulerConfig& config) {
     }
     
     config_ = config;
+    osPriorityMapping_ = config_.enableOsPriorityMapping;
+    realtimeScheduling_ = config_.allowRealtimeScheduling;
+    rejectionPolicy_ = config_.rejectionPolicy;
+    maxQueueSize_ = config_.maxQueueSize;
+    affinityStealThreshold_ = config_.affinityStealThreshold;
+    defaultTimeout_ = config_.defaultTimeout;
+    combineSubmissions_ = config_.combineSubmissions;
+    collectMetrics_ = config_.collectMetrics;
+    {
+        std::lock_guard<LockPolicy> statusLock(statusMutex_);
+        taskTable_->setRetention(config_.maxFinishedTaskRecords, config_.finishedTaskRetention);
+        
+        // 容量改变时重建结果环（尚无工作线程写入结果）
+        if (completedTasks_->capacity() != ResultPolicy::capacityFor(config_.completedResultCapacity)) {
+            completedTasks_ = std::make_unique<ResultPolicy>(config_.completedResultCapacity);
+            drainCursor_ = ResultCursor();
+        }
+    }
     
     try {
         // 创建日志目录
@@ -90,30 +300,67 @@ bool TaskScheduler::initialize(const SchedulerConfig& config) {
         std::string mkdirCmd = "mkdir -p " + logDir;
         system(mkdirCmd.c_str());
         
-        // 初始化线程池
-        threadPool_ = std::make_unique<ThreadPool>(config_.minThreads);
-        
         // 初始化优先级队列
-        taskQueue_ = std::make_unique<PriorityQueue>();
+        taskQueue_ = std::make_unique<QueuePolicy>();
+        staleQueueEntries_ = 0;
+        
+        if (config_.sharedExecutor) {
+            // 挂接到共享执行器，不创建自己的工作线程
+            executor_ = config_.sharedExecutor;
+            affinitySlots_.clear();
+        } else {
+            // 初始化线程池
+            threadPool_ = std::make_unique<ThreadPool>(config_.minThreads + config_.fiberCarriers);
+            
+            // 任务阻塞时由补偿线程接替运行工作循环
+            threadPool_->setMaxCompensationThreads(config_.maxCompensationThreads);
+            threadPool_->setCompensationTask([this] { workerThread(kNoAffinitySlot, true); });
+            threadPool_->setRetireNotifier([this] { wakeWorkers(); });
+            
+            // 纤程载体线程占用线程池中额外的fiberCarriers个线程
+            if (config_.fiberCarriers > 0) {
+                FiberConfig fiberConfig;
+                fiberConfig.stackSize = config_.fiberStackSize;
+                fiberRuntime_ = std::make_unique<FiberRuntime>(*threadPool_, config_.fiberCarriers, fiberConfig);
+            }
+        }
         
         // 标记为运行状态
         running_ = true;
         paused_ = false;
         
         // 初始化性能指标
-        currentMetrics_ = PerformanceMetrics();
-        currentMetrics_.lastUpdateTime = std::chrono::steady_clock::now();
-        currentMetrics_.currentActiveThreads = config_.minThreads;
+        {
+            std::lock_guard<std::mutex> resultsLock(resultsMutex_);
+            counters_->reset();
+            maxGangWaitMicros_ = 0;
+            currentMetrics_ = PerformanceMetrics();
+            currentMetrics_.lastUpdateTime = std::chrono::steady_clock::now();
+            currentMetrics_.currentActiveThreads = config_.minThreads;
+        }
         
         // 启动工作线程
-        for (size_t i = 0; i < config_.minThreads; ++i) {
-            threadPool_->enqueue([this] { workerThread(); });
+        if (executor_) {
+            std::ostringstream name;
+            name << "TaskScheduler@" << static_cast<const void*>(this);
+            executorSourceId_ = executor_->attach(name.str(), [this] { return runNextTask(); });
+        } else {
+            // 每个常驻工作线程一个亲和队列，补偿线程和后来增加的线程只窃取
+            affinitySlots_.clear();
+            for (size_t i = 0; i < config_.minThreads; ++i) {
+                affinitySlots_.push_back(std::make_unique<AffinitySlot<QueuePolicy>>());
+            }
+            slotWorkers_ = 0;
+            extraWorkers_ = 0;
+            targetWorkers_ = config_.minThreads;
+            startWorkers(config_.minThreads);
         }
         
         // 启动监控线程
         monitorThread_ = std::thread([this] { monitorThread(); });
         
         // 启动超时检查线程
+        deadlines_->clear();
         timeoutThread_ = std::thread([this] { timeoutCheckThread(); });
         
         return true;
@@ -123,22 +370,47 @@ bool TaskScheduler::initialize(const SchedulerConfig& config) {
     }
 }
 
-void TaskScheduler::shutdown() {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::shutdown() {
     if (!running_) {
         return;
     }
     
-    // 先标记停止
+    // 先标记停止，唤醒空闲和暂停中的工作线程
     running_ = false;
+    wakeWorkers();
+    
+    // 唤醒仍在集结的gang
+    {
+        std::lock_guard<std::mutex> lock(gangMutex_);
+    }
+    gangCondition_.notify_all();
+    
+    // 从共享执行器解除挂接（等待正在执行的任务结束）
+    if (executor_) {
+        executor_->detach(executorSourceId_);
+        executor_.reset();
+    }
     
     // 等待一小段时间让工作线程退出
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
     
+    // 通道中尚未取出的任务进入队列，随后与排队任务一起通知取消
+    if (taskQueue_) {
+        drainChannels(true);
+    }
+    
     // 停止队列（唤醒所有等待的线程）
     if (taskQueue_) {
         taskQueue_->stop();
     }
     
+    // 停止纤程运行时（仍在等待的纤程被释放）
+    if (fiberRuntime_) {
+        fiberRuntime_->shutdown();
+        fiberRuntime_.reset();
+    }
+    
     // 停止线程池
     if (threadPool_) {
         threadPool_->stop();
@@ -150,187 +422,1438 @@ void TaskScheduler::shutdown() {
     }
     
     // 等待超时检查线程结束
+    deadlines_->stop();
     if (timeoutThread_.joinable()) {
         timeoutThread_.join();
     }
     
-    // 清理资源
+    // 调用线程和共享执行器线程上创建的上下文随调度器关闭一起销毁
+    {
+        std::unordered_map<std::thread::id, std::shared_ptr<WorkerContextSlots>> remaining;
+        {
+            std::lock_guard<std::mutex> lock(contextMutex_);
+            remaining.swap(workerContexts_);
+        }
+    }
+    
+    // 仍在排队的任务不会再执行，通知其完成回调（如TaskGroup）
+    if (taskQueue_) {
+        std::vector<std::shared_ptr<Task>> abandoned;
+        while (auto task = taskQueue_->tryPop()) {
+            if (task->detached || claimTask(task)) {
+                abandoned.push_back(task);
+            }
+        }
+        for (auto& slot : affinitySlots_) {
+            while (auto task = slot->queue.tryPop()) {
+                if (task->detached || claimTask(task)) {
+                    abandoned.push_back(task);
+                }
+            }
+        }
+        
+        // 仍在等待依赖的任务不在任何队列中
+        {
+            std::lock_guard<LockPolicy> lock(statusMutex_);
+            taskTable_->forEach([&](TaskID taskId, TaskStatus status, const std::shared_ptr<Task>& task) {
+                if (task && task->remainingDependencies > 0 && status == TaskStatus::PENDING) {
+                    taskTable_->setStatus(taskId, TaskStatus::CANCELLED);
+                    abandoned.push_back(task);
+                }
+            });
+        }
+        notifyCancelled(abandoned);
+    }
+    
+    // 清理资源（丢弃的结果在锁外销毁）
+    std::vector<std::shared_ptr<const void>> dropped;
+    {
+        std::lock_guard<LockPolicy> statusLock(statusMutex_);
+        taskTable_->clear();
+        dropped = completedTasks_->clear();
+    }
+    deadlines_->clear();
+    taskFinished_.notify_all();
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::isRunning() const {
+    return running_;
+}
+
+// 任务管理
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::generateTaskId() {
+    // 分配记录槽位，ID中含槽位号，不需要状态锁
+    return taskTable_->allocate(nextTaskId_.fetch_add(1));
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::registerTask(std::shared_ptr<Task> task, bool queued) {
+    // 生成任务ID；记录表已满时不登记，提交方返回0
+    task->id = generateTaskId();
+    if (task->id == 0) {
+        return false;
+    }
+    
+    // 记录任务状态
+    {
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        // 不入队的任务直接由调用线程执行，视为已被认领
+        taskTable_->attach(task->id, task, queued ? TaskStatus::PENDING : TaskStatus::RUNNING);
+        if (queued) {
+            armQueueDeadline(task);
+        }
+    }
+    
+    countMetric(Metric::TASKS_SUBMITTED);
+    return true;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitTask(std::shared_ptr<Task> task) {
+    if (!running_ || !task) {
+        return 0; // 无效的任务ID
+    }
+    
+    if (paused_) {
+        return 0; // 系统暂停中
+    }
+    
+    // 有依赖的任务先挂到前驱上，释放时才入队
+    if (!task->dependencies.empty()) {
+        return submitDependentTask(task);
+    }
+    
+    // 队列已满时按拒绝策略处理
+    RejectionPolicy policy = rejectionPolicy_;
+    if (policy != RejectionPolicy::UNBOUNDED && queuedTaskCount() >= maxQueueSize_) {
+        if (policy == RejectionPolicy::REJECT) {
+            countMetric(Metric::TASKS_REJECTED);
+            return 0;
+        }
+        
+        // CALLER_RUNS：提交线程自己执行，执行期间不再产生新任务
+        if (!registerTask(task, false)) {
+            return 0;
+        }
+        runInline(task);
+        return task->id;
+    }
+    
+    // 本线程经提交通道提交过的任务排在前面
+    if (tlsProducerChannel) {
+        drainChannels(true);
+    }
+    
+    // 并发提交时由一个合并者批量登记和入队，槽位用尽时直接登记
+    if (combineSubmissions_ && submitCombined(task)) {
+        return task->id;
+    }
+    
+    if (!registerTask(task, true)) {
+        return 0;
+    }
+    try {
+        enqueueTask(task);
+    } catch (...) {
+        cancelUnqueued({task});
+        throw;
+    }
+    return task->id;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::enqueueTask(const std::shared_ptr<Task>& task) {
+    // 将任务加入队列，带亲和键的任务进入首选工作线程的亲和队列
+    if (task->affinityKey != 0 && !affinitySlots_.empty()) {
+        pushAffinityTask(task);
+        return;
+    }
+    taskQueue_->push(task);
+    
+    if (executor_) {
+        executor_->notify();
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitDependentTask(const std::shared_ptr<Task>& task) {
+    // 前驱可能还在提交通道中
+    drainChannels(true);
+    
+    task->id = generateTaskId();
+    if (task->id == 0) {
+        return 0;
+    }
+    if (task->dataflow) {
+        task->inputs.assign(task->dependencies.size(), std::any());
+    }
+    
+    // 登记期间多持有一个计数，前驱在登记途中结束也不会提前释放本任务
+    task->remainingDependencies.store(1);
+    bool dependencyFailed = false;
+    {
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        taskTable_->attach(task->id, task, TaskStatus::PENDING);
+        armQueueDeadline(task);
+        
+        for (size_t i = 0; i < task->dependencies.size(); ++i) {
+            TaskID dependency = task->dependencies[i];
+            auto status = taskTable_->status(dependency);
+            if (!status) {
+                // 记录已被回收的前驱早已结束，视为已完成；数据流任务取不到其结果，与不存在的ID一样按依赖失败处理
+                if (!task->dataflow && taskTable_->reclaimed(dependency, nextTaskId_)) {
+                    continue;
+                }
+                dependencyFailed = true;
+                break;
+            }
+            if (*status == TaskStatus::COMPLETED) {
+                if (task->dataflow) {
+                    // 结果已移交或已被覆盖时无法提供输入，不能以空输入执行
+                    auto completed = completedTasks_->find(dependency);
+                    if (!completed || completed->forwarded) {
+                        dependencyFailed = true;
+                        break;
+                    }
+                    task->inputs[i] = completed->result;
+                }
+                continue;
+            }
+            if (*status != TaskStatus::PENDING && *status != TaskStatus::RUNNING) {
+                dependencyFailed = true;
+                break;
+            }
+            
+            // 前驱结束时在同一把锁下取走后继列表，挂上之后必然会收到通知
+            if (auto predecessor = taskTable_->task(dependency)) {
+                task->remainingDependencies.fetch_add(1);
+                predecessor->successors.push_back(task);
+            }
+        }
+        
+        if (dependencyFailed) {
+            taskTable_->setStatus(task->id, TaskStatus::CANCELLED);
+            taskTable_->release(task->id);
+            taskFinished_.notify_all();
+        }
+    }
+    
+    countMetric(Metric::TASKS_SUBMITTED);
+    
+    if (dependencyFailed) {
+        notifyCancelled({task});
+    } else if (task->remainingDependencies.fetch_sub(1) == 1) {
+        requeueTask(task);
+    }
+    return task->id;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::releaseSuccessors(std::vector<std::shared_ptr<Task>>& successors, bool succeeded) {
+    if (succeeded) {
+        // 最后一个前驱完成时入队（队列已停止时通知取消）
+        for (const auto& successor : successors) {
+            if (successor->remainingDependencies.fetch_sub(1) == 1) {
+                requeueTask(successor);
+            }
+        }
+        return;
+    }
+    
+    // 前驱未成功：逐层取消所有仍在等待的后继，不递归以免长依赖链栈溢出
+    std::vector<std::shared_ptr<Task>> cancelled;
+    {
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        while (!successors.empty()) {
+            auto successor = std::move(successors.back());
+            successors.pop_back();
+            
+            if (taskTable_->status(successor->id) != TaskStatus::PENDING) {
+                continue;
+            }
+            taskTable_->setStatus(successor->id, TaskStatus::CANCELLED);
+            taskTable_->release(successor->id);
+            
+            for (auto& next : successor->successors) {
+                successors.push_back(std::move(next));
+            }
+            successor->successors.clear();
+            cancelled.push_back(std::move(successor));
+        }
+        
+        if (!cancelled.empty()) {
+            taskFinished_.notify_all();
+        }
+    }
+    
+    notifyCancelled(cancelled);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitCombined(const std::shared_ptr<Task>& task) {
+    auto& combiner = *submitCombiner_;
+    
+    // 占用一个空闲槽位，优先本线程固定的槽位（多于64个并发生产者时可能都被占用）
+    SubmitSlot* slot = nullptr;
+    size_t index = 0;
+    for (size_t i = 0; i < 4 && !slot; ++i) {
+        index = (tlsProducerSlot + i) % kSubmitSlots;
+        bool expected = false;
+        if (combiner.slots[index].owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            slot = &combiner.slots[index];
+        }
+    }
+    if (!slot) {
+        return false;
+    }
+    
+    // 发布请求：ID由生产者分配，登记和入队交给合并者；记录表已满时交回直接提交的路径拒绝
+    task->id = generateTaskId();
+    if (task->id == 0) {
+        slot->owned.store(false, std::memory_order_release);
+        return false;
+    }
+    slot->task = task;
+    slot->done.store(false, std::memory_order_relaxed);
+    combiner.pending.fetch_or(uint64_t(1) << index, std::memory_order_release);
+    
+    // 没有合并者时自己成为合并者，否则等待合并者处理；
+    // 短暂自旋后阻塞在合并锁上，合并者被抢占时其他生产者不空转
+    for (int spins = 0; !slot->done.load(std::memory_order_acquire); ++spins) {
+        if (spins < kCombinerSpins) {
+            if (!combiner.mutex.try_lock()) {
+                std::this_thread::yield();
+                continue;
+            }
+        } else {
+            combiner.mutex.lock();
+        }
+        if (!slot->done.load(std::memory_order_acquire)) {
+            combineSubmissions(combiner);
+        }
+        combiner.mutex.unlock();
+    }
+    
+    std::exception_ptr error = std::move(slot->error);
+    slot->error = nullptr;
+    slot->owned.store(false, std::memory_order_release);
+    
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return true;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::combineSubmissions(SubmitCombiner& combiner) {
+    // 调用方已持有合并锁；最多合并几轮，避免一个生产者长时间替其他线程工作
+    for (int round = 0; round < 4; ++round) {
+        uint64_t mask = combiner.pending.exchange(0, std::memory_order_acquire);
+        if (mask == 0) {
+            return;
+        }
+        
+        combiner.batch.clear();
+        combiner.batchSlots.clear();
+        while (mask) {
+            size_t index = static_cast<size_t>(__builtin_ctzll(mask));
+            mask &= mask - 1;
+            combiner.batch.push_back(std::move(combiner.slots[index].task));
+            combiner.batchSlots.push_back(index);
+        }
+        
+        std::exception_ptr error;
+        try {
+            enqueueBatch(combiner.batch);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        combiner.batch.clear();
+        
+        for (size_t index : combiner.batchSlots) {
+            combiner.slots[index].error = error;
+            combiner.slots[index].done.store(true, std::memory_order_release);
+        }
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::attachChannel(SubmissionChannel* channel) {
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        channels_.push_back(channel);
+        channelCount_ = channels_.size();
+    }
+    
+    // 持有锁期间工作线程跳过的取出由本线程补上
+    if (drainRequested_.exchange(false) && running_) {
+        drainChannels(true);
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::detachChannel(SubmissionChannel* channel) {
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        
+        // 剩余任务照常入队；调度器已停止时不再入队
+        std::vector<std::shared_ptr<Task>> remaining;
+        channel->drainTo(remaining);
+        if (!remaining.empty() && running_) {
+            enqueueBatch(remaining);
+        }
+        
+        channels_.erase(std::remove(channels_.begin(), channels_.end(), channel), channels_.end());
+        channelCount_ = channels_.size();
+        if (tlsProducerChannel == channel) {
+            tlsProducerChannel = nullptr;
+        }
+    }
+    
+    // 持有锁期间工作线程跳过的取出由本线程补上（其他通道中的任务）
+    if (drainRequested_.exchange(false) && running_) {
+        drainChannels(true);
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitToChannel(SubmissionChannel& channel, std::shared_ptr<Task> task) {
+    if (!running_ || paused_ || !task) {
+        return 0;
+    }
+    
+    // 有依赖的任务需要登记时查看前驱状态，取出通道中已有的任务后直接提交
+    if (!task->dependencies.empty()) {
+        tlsProducerChannel = &channel;
+        return submitTask(std::move(task));
+    }
+    
+    // 生产者只分配ID并写入缓冲区，登记和入队由取出的线程完成（分配槽位的CAS可能重试）
+    TaskID taskId = generateTaskId();
+    if (taskId == 0) {
+        return 0;
+    }
+    task->id = taskId;
+    tlsProducerChannel = &channel;
+    
+    if (!channel.tryPush(task)) {
+        // 缓冲区已满：先取出已提交的任务，再在当前线程上直接入队，保持顺序
+        channel.overflows_++;
+        drainChannels(true);
+        std::vector<std::shared_ptr<Task>> batch{std::move(task)};
+        enqueueBatch(batch);
+        return taskId;
+    }
+    
+    // 工作线程都在等待时唤醒一个来取出；否则由忙碌的线程在下一轮循环取出。
+    // 写入缓冲区不加锁，唤醒则要获取全局队列（或共享执行器）的锁，条件变量没有无锁的唤醒
+    if (idleWorkers_ > 0) {
+        taskQueue_->wakeOne();
+    }
+    if (executor_) {
+        executor_->notify();
+    }
+    return taskId;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::drainChannels(bool wait) {
+    if (channelCount_ == 0) {
+        return false;
+    }
+    
+    bool drained = false;
+    do {
+        // 不等待时锁被占用（其他线程正在取出或注册通道）则不阻塞：留下请求，
+        // 持有者释放锁后再取一次，持有者读取之后才写入通道的任务不会滞留到下一次唤醒
+        std::unique_lock<std::mutex> lock(channelsMutex_, std::defer_lock);
+        if (wait) {
+            lock.lock();
+        } else if (!lock.try_lock()) {
+            drainRequested_ = true;
+            if (!lock.try_lock()) {
+                return drained;
+            }
+        }
+        drainRequested_ = false;
+        
+        channelBatch_.clear();
+        for (auto* channel : channels_) {
+            channel->drainTo(channelBatch_);
+        }
+        if (!channelBatch_.empty()) {
+            enqueueBatch(channelBatch_);
+            channelBatch_.clear();
+            drained = true;
+        }
+    } while (drainRequested_.exchange(false));
+    return drained;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::cancelUnqueued(const std::vector<std::shared_ptr<Task>>& tasks) {
+    std::vector<std::shared_ptr<Task>> cancelled;
     {
-        std::lock_guard<std::mutex> statusLock(statusMutex_);
-        taskStatuses_.clear();
-        activeTasks_.clear();
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        for (const auto& task : tasks) {
+            if (taskTable_->status(task->id) == TaskStatus::PENDING) {
+                taskTable_->setStatus(task->id, TaskStatus::CANCELLED);
+                taskTable_->release(task->id);
+                cancelled.push_back(task);
+            }
+        }
+        taskFinished_.notify_all();
     }
+    notifyCancelled(cancelled);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::enqueueBatch(std::vector<std::shared_ptr<Task>>& batch) {
+    // 整批只获取一次状态锁
+    {
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        for (const auto& task : batch) {
+            taskTable_->attach(task->id, task, TaskStatus::PENDING);
+            armQueueDeadline(task);
+        }
+    }
+    
+    countMetric(Metric::TASKS_SUBMITTED, batch.size());
+    countMetric(Metric::SUBMIT_BATCHES);
+    
+    // 带亲和键的任务进入各自的亲和队列，其余一次入队。
+    // 入队失败（关闭过程中队列已停止）时未入队的任务按取消处理，否则等待它们的线程永远等不到结果
+    size_t kept = batch.size();     // batch[0, kept)是尚未入队的普通任务
+    size_t next = batch.size();     // batch[next, end)是还没有分派的任务
+    try {
+        if (!affinitySlots_.empty()) {
+            kept = 0;
+            for (next = 0; next < batch.size(); ++next) {
+                if (batch[next]->affinityKey == 0) {
+                    if (kept != next) {
+                        batch[kept] = std::move(batch[next]);
+                    }
+                    kept++;
+                } else {
+                    pushAffinityTask(batch[next]);
+                }
+            }
+            batch.resize(kept);
+            next = kept;
+        }
+        taskQueue_->pushBatch(batch);
+    } catch (...) {
+        std::vector<std::shared_ptr<Task>> unqueued(batch.begin(), batch.begin() + kept);
+        unqueued.insert(unqueued.end(), batch.begin() + next, batch.end());
+        cancelUnqueued(unqueued);
+        throw;
+    }
+    
+    if (executor_) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            executor_->notify();
+        }
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskResult BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitAndWait(TaskType type, Priority priority, std::function<TaskResult()> function) {
+    if (!running_ || paused_) {
+        TaskResult result(0, ResultStatus::CANCELLED);
+        result.errorMessage = "Scheduler is not accepting tasks";
+        return result;
+    }
+    
+    // 调用方本来就要阻塞等待，直接在调用线程上执行，不经过队列
+    auto task = std::make_shared<Task>(0, type, priority, std::move(function));
+    if (!registerTask(task, false)) {
+        TaskResult result(0, ResultStatus::FAILURE);
+        result.errorMessage = "Task table is full";
+        return result;
+    }
+    return runInline(task);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskResult BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::waitForTask(TaskID taskId, std::chrono::milliseconds timeout) {
+    auto deadline = timeout == std::chrono::milliseconds::max()
+        ? std::chrono::steady_clock::time_point::max()
+        : std::chrono::steady_clock::now() + timeout;
+    
+    std::unordered_map<TaskID, TaskResult> inlineResults;
+    if (!awaitTasks({taskId}, deadline, inlineResults)) {
+        TaskResult result(taskId, ResultStatus::TIMEOUT);
+        result.errorMessage = "Wait timeout";
+        return result;
+    }
+    
+    auto it = inlineResults.find(taskId);
+    return it != inlineResults.end() ? it->second : lookupResult(taskId);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+std::vector<TaskResult> BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::waitForTasks(const std::vector<TaskID>& taskIds) {
+    std::unordered_map<TaskID, TaskResult> inlineResults;
+    awaitTasks(taskIds, std::chrono::steady_clock::time_point::max(), inlineResults);
+    
+    std::vector<TaskResult> results;
+    results.reserve(taskIds.size());
+    for (TaskID taskId : taskIds) {
+        auto it = inlineResults.find(taskId);
+        results.push_back(it != inlineResults.end() ? it->second : lookupResult(taskId));
+    }
+    return results;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::awaitTasks(const std::vector<TaskID>& taskIds,
+                               std::chrono::steady_clock::time_point deadline,
+                               std::unordered_map<TaskID, TaskResult>& inlineResults) {
+    // 被等待的任务可能还在提交通道中
+    drainChannels(true);
+    
+    // 在本调度器的任务中等待时，除了被等待的任务还帮忙执行其他排队任务，
+    // 否则工作线程全部阻塞在等待上，递归分治深度超过线程数即死锁
+    bool helping = canHelp();
+    
+    // 被等待的任务全部进入终态（调用方已持有statusMutex_）
+    auto allFinished = [this, &taskIds] {
+        for (TaskID taskId : taskIds) {
+            auto status = taskTable_->status(taskId);
+            if (status == TaskStatus::PENDING || status == TaskStatus::RUNNING) {
+                return false;
+            }
+        }
+        return true;
+    };
+    
+    while (true) {
+        std::shared_ptr<Task> claimed;
+        
+        {
+            std::unique_lock<LockPolicy> lock(statusMutex_);
+            
+            // 优先认领仍在队列中的被等待任务，队列中的旧条目由工作线程出队时跳过
+            // 纤程任务可能依赖其他纤程放行，仍交给载体线程执行
+            if (!paused_) {
+                for (TaskID taskId : taskIds) {
+                    if (taskTable_->status(taskId) != TaskStatus::PENDING) {
+                        continue;
+                    }
+                    // 仍在等待依赖的任务由最后一个前驱释放
+                    auto task = taskTable_->task(taskId);
+                    if (task && !(task->runOnFiber && fiberRuntime_) && task->remainingDependencies == 0) {
+                        taskTable_->setStatus(taskId, TaskStatus::RUNNING);
+                        task->staleQueueEntry = true;
+                        staleQueueEntries_++;
+                        claimed = std::move(task);
+                        break;
+                    }
+                }
+            }
+            
+            if (!claimed) {
+                if (allFinished()) {
+                    return true;
+                }
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+                
+                // 不帮忙时只等待被等待的任务结束
+                if (!helping) {
+                    if (deadline == std::chrono::steady_clock::time_point::max()) {
+                        taskFinished_.wait(lock, allFinished);
+                    } else {
+                        taskFinished_.wait_until(lock, deadline, allFinished);
+                    }
+                    continue;
+                }
+            }
+        }
+        
+        if (claimed) {
+            inlineResults[claimed->id] = runInline(claimed);
+            continue;
+        }
+        
+        // 被等待的任务都在其他线程上运行：帮忙执行一个其他排队任务
+        if (helpOneTask()) {
+            continue;
+        }
+        
+        // 没有可帮忙的任务，短暂等待后重试（新任务入队不会通知taskFinished_）
+        std::unique_lock<LockPolicy> lock(statusMutex_);
+        taskFinished_.wait_until(lock, std::min(std::chrono::steady_clock::now() + std::chrono::milliseconds(1),
+                                                deadline), allFinished);
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::canHelp() const {
+    // 只在本调度器的任务中帮忙，纤程栈较小，不在纤程中帮忙
+    return tlsCurrentScheduler == this && !FiberRuntime::inFiber() && tlsHelpDepth < kMaxHelpDepth;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::helpOneTask() {
+    if (!canHelp() || paused_) {
+        return false;
+    }
+    
+    // 等待中的线程同样可以加入正在集结的gang
+    if (joinGang()) {
+        return true;
+    }
+    
+    auto task = nextAffinityTask(ownAffinitySlot());
+    if (!task) {
+        task = taskQueue_->tryPop();
+    }
+    if (!task) {
+        return false;
+    }
+    
+    Priority waiting = currentTaskPriority();
+    tlsHelpDepth++;
+    executeTask(task);
+    tlsHelpDepth--;
+    
+    // 嵌套任务可能改变了线程调度类别，恢复为等待方任务的类别
+    if (osPriorityMapping_) {
+        applyThreadPriority(waiting, realtimeScheduling_);
+    }
+    return true;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskResult BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::lookupResult(TaskID taskId) {
+    // 从已完成列表中查找结果（从最新的开始）
+    if (auto completed = completedTasks_->find(taskId)) {
+        return *completed;
+    }
+    
+    // 结果已被清理，只能根据状态构造
+    TaskStatus status = getTaskStatus(taskId);
+    TaskResult result(taskId, status == TaskStatus::COMPLETED ? ResultStatus::SUCCESS :
+                              status == TaskStatus::TIMEOUT ? ResultStatus::TIMEOUT :
+                              status == TaskStatus::FAILED ? ResultStatus::FAILURE : ResultStatus::CANCELLED);
+    return result;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::claimTask(const std::shared_ptr<Task>& task, bool* deferred) {
+    std::lock_guard<LockPolicy> lock(statusMutex_);
+    
+    // 已被取消、排队超时或已在等待方线程上执行的任务不再执行；后两者的旧条目已出队，不再从排队任务数中扣除
+    if (taskTable_->status(task->id) != TaskStatus::PENDING) {
+        if (task->staleQueueEntry) {
+            task->staleQueueEntry = false;
+            staleQueueEntries_--;
+        }
+        return false;
+    }
+    
+    // 工作线程分派（deferred非空）时，暂停期间不认领，由调用方放回队列
+    if (deferred && paused_) {
+        *deferred = true;
+        return false;
+    }
+    
+    taskTable_->setStatus(task->id, TaskStatus::RUNNING);
+    return true;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitTask(TaskType type, Priority priority, std::function<TaskResult()> function) {
+    auto task = std::make_shared<Task>(0, type, priority, std::move(function));
+    return submitTask(task);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitAffinityTask(TaskType type, Priority priority, uint64_t affinityKey,
+                                         std::function<TaskResult()> function) {
+    auto task = std::make_shared<Task>(0, type, priority, std::move(function));
+    task->affinityKey = affinityKey;
+    return submitTask(task);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+size_t BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::queuedTaskCount() const {
+    size_t count = taskQueue_ ? taskQueue_->size() : 0;
+    for (const auto& slot : affinitySlots_) {
+        count += slot->queue.size();
+    }
+    
+    // 已在等待方线程上执行或排队超时的任务仍留有旧条目（结束排队在条目入队前时可能暂时多扣）
+    size_t stale = staleQueueEntries_;
+    return count > stale ? count - stale : 0;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+size_t BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::affinitySlotFor(uint64_t affinityKey) const {
+    // 先打散键值，连续的键（如分区编号）也能均匀分布
+    uint64_t hash = affinityKey * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>((hash >> 32) % affinitySlots_.size());
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+size_t BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::ownAffinitySlot() const {
+    return tlsAffinityScheduler == this ? tlsAffinitySlot : kNoAffinitySlot;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+QueuePolicy& BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::queueFor(const Task& task) {
+    if (task.affinityKey != 0 && !affinitySlots_.empty()) {
+        return affinitySlots_[affinitySlotFor(task.affinityKey)]->queue;
+    }
+    return *taskQueue_;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::pushAffinityTask(const std::shared_ptr<Task>& task) {
+    auto& slot = *affinitySlots_[affinitySlotFor(task->affinityKey)];
+    if (slot.retired) {
+        taskQueue_->push(task);
+        return;
+    }
+    slot.queue.push(task);
+    
+    // 与退役的工作循环并发时，双方至少有一方会把任务转入全局队列
+    if (slot.retired) {
+        moveAffinityTasks(slot);
+        return;
+    }
+    
+    // 首选线程空闲时只唤醒它（各线程在全局队列上用各自的条件变量等待），
+    // 首选线程忙且积压超过阈值时唤醒一个空闲线程来窃取
+    if (slot.idle) {
+        taskQueue_->wake(slot.waiter);
+    } else if (slot.queue.size() > affinityStealThreshold_) {
+        taskQueue_->wakeOne();
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+std::shared_ptr<Task> BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::nextAffinityTask(size_t ownSlot) {
+    if (affinitySlots_.empty() || paused_) {
+        return nullptr;
+    }
+    
+    // 优先执行自己亲和队列中的任务
+    if (ownSlot != kNoAffinitySlot) {
+        if (auto task = affinitySlots_[ownSlot]->queue.tryPop()) {
+            return task;
+        }
+    }
+    
+    // 全局队列有任务时不窃取
+    if (!taskQueue_->empty()) {
+        return nullptr;
+    }
+    
+    // 自己无事可做时，从积压最多且超过阈值的亲和队列窃取
+    size_t threshold = affinityStealThreshold_;
+    AffinitySlot<QueuePolicy>* victim = nullptr;
+    size_t longest = threshold;
+    for (auto& slot : affinitySlots_) {
+        size_t size = slot->queue.size();
+        if (size > longest) {
+            longest = size;
+            victim = slot.get();
+        }
+    }
+    if (!victim) {
+        return nullptr;
+    }
+    
+    auto task = victim->queue.tryPop();
+    if (task) {
+        countMetric(Metric::AFFINITY_STEALS);
+    }
+    return task;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitTask(TaskType type, Priority priority, std::function<TaskResult()> function,
+                               std::chrono::milliseconds timeout, std::chrono::milliseconds queueTimeout) {
+    auto task = std::make_shared<Task>(0, type, priority, std::move(function));
+    task->timeout = timeout;
+    task->queueTimeout = queueTimeout;
+    return submitTask(task);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitTask(TaskType type, Priority priority, std::function<TaskResult()> function,
+                               const std::vector<TaskID>& dependencies) {
+    auto task = std::make_shared<Task>(0, type, priority, std::move(function));
+    task->dependencies = dependencies;
+    return submitTask(task);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitFiberTask(TaskType type, Priority priority, std::function<TaskResult()> function) {
+    auto task = std::make_shared<Task>(0, type, priority, std::move(function));
+    task->runOnFiber = true;
+    return submitTask(task);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitGangTask(TaskType type, Priority priority, size_t parts,
+                                     std::function<void(size_t, size_t)> function) {
+    // 超过线程数的gang永远无法集结
+    if (!running_ || !function || parts == 0 || parts > gangCapacity()) {
+        return 0;
+    }
+    
+    // gang作为普通任务排队，取到它的工作线程成为发起者，再集结其余parts-1个线程
+    auto gang = std::make_shared<GangState>();
+    gang->parts = parts;
+    gang->function = std::move(function);
+    
+    auto task = std::make_shared<Task>(0, type, priority, [this, gang] { return runGang(gang); });
+    gang->task = task;
+    return submitTask(task);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+size_t BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::gangCapacity() const {
+    if (executor_) {
+        return executor_->getMetrics().maxThreads;
+    }
+    if (!threadPool_) {
+        return 0;
+    }
+    
+    // 纤程载体线程不运行工作循环
+    return targetWorkers_;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskResult BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::runGang(std::shared_ptr<GangState> gang) {
+    {
+        std::unique_lock<std::mutex> lock(gangMutex_);
+        
+        // 已有gang在集结：先作为成员加入它，不能占着线程空等，否则两个gang互相等待
+        while (assemblingGang_ && running_) {
+            if (assemblingGang_->joined < assemblingGang_->parts) {
+                lock.unlock();
+                joinGang();
+                lock.lock();
+            } else {
+                gangCondition_.wait(lock);
+            }
+        }
+        
+        if (!running_) {
+            throw std::runtime_error("Scheduler stopped before gang was assembled");
+        }
+        // 提交后线程池已缩减到不足parts个工作线程
+        if (gang->parts > gangCapacity()) {
+            throw std::runtime_error("Worker pool shrank below gang size before gang was assembled");
+        }
+        
+        gang->joined = 1;
+        assemblingGang_ = gang;
+        gangAssembling_ = true;
+    }
+    
+    // 唤醒空闲的工作线程来加入
+    wakeWorkers();
+    if (executor_) {
+        for (size_t i = 1; i < gang->parts; ++i) {
+            executor_->notify();
+        }
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(gangMutex_);
+        gangCondition_.wait(lock, [this, &gang] {
+            return gang->joined == gang->parts || !running_ || gang->parts > gangCapacity();
+        });
+        
+        assemblingGang_.reset();
+        gangAssembling_ = false;
+        
+        if (gang->joined < gang->parts) {
+            gang->aborted = true;
+            gangCondition_.notify_all();
+            throw std::runtime_error(running_ ? "Worker pool shrank below gang size before gang was assembled"
+                                              : "Scheduler stopped before gang was assembled");
+        }
+        
+        gang->started = true;
+        gangCondition_.notify_all();
+    }
+    
+    // 集结等待时间：从提交到全部线程就位
+    uint64_t waitMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - gang->task->submitTime).count());
+    countMetric(Metric::GANGS_RUN);
+    countMetric(Metric::GANG_WAIT_MICROS, waitMicros);
+    uint64_t maxWait = maxGangWaitMicros_.load(std::memory_order_relaxed);
+    while (waitMicros > maxWait &&
+           !maxGangWaitMicros_.compare_exchange_weak(maxWait, waitMicros, std::memory_order_relaxed)) {
+    }
+    
+    runGangPart(*gang, 0);
+    
+    std::unique_lock<std::mutex> lock(gangMutex_);
+    if (!gang->error.empty()) {
+        throw std::runtime_error(gang->error);
+    }
+    return TaskResult(0, ResultStatus::SUCCESS);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::joinGang() {
+    if (!gangAssembling_) {
+        return false;
+    }
+    
+    std::shared_ptr<GangState> gang;
+    size_t part;
+    {
+        std::unique_lock<std::mutex> lock(gangMutex_);
+        gang = assemblingGang_;
+        if (!gang || gang->joined >= gang->parts) {
+            return false;
+        }
+        
+        part = gang->joined++;
+        gangCondition_.notify_all();
+        gangCondition_.wait(lock, [&gang] { return gang->started || gang->aborted; });
+        if (gang->aborted) {
+            return true;
+        }
+    }
+    
+    TaskPriorityScope priorityScope(gang->task->priority);
+    if (osPriorityMapping_) {
+        applyThreadPriority(gang->task->priority, realtimeScheduling_);
+    }
+    
+    runGangPart(*gang, part);
+    
+    if (osPriorityMapping_ && static_cast<int>(gang->task->priority) > static_cast<int>(Priority::NORMAL)) {
+        resetThreadPriority();
+    }
+    return true;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::runGangPart(GangState& gang, size_t part) {
+    std::string error;
+    try {
+        gang.function(part, gang.parts);
+    } catch (const std::exception& e) {
+        error = e.what();
+    } catch (...) {
+        error = "Unknown exception occurred";
+    }
+    
+    // 所有部分结束后一起释放线程
+    std::unique_lock<std::mutex> lock(gangMutex_);
+    if (!error.empty() && gang.error.empty()) {
+        gang.error = "Gang part " + std::to_string(part) + ": " + error;
+    }
+    gang.finished++;
+    gangCondition_.notify_all();
+    gangCondition_.wait(lock, [&gang] { return gang.finished == gang.parts; });
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::setWorkerContextFactory(TaskType type, WorkerContextFactory factory) {
+    std::lock_guard<std::mutex> lock(contextMutex_);
+    contextFactories_.resize(kTaskTypeCount);
+    
+    auto& entry = contextFactories_[static_cast<size_t>(type)];
+    entry.first = std::move(factory);
+    entry.second++;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitContextTask(TaskType type, Priority priority,
+                                        std::function<TaskResult(WorkerContext&)> function) {
+    auto task = std::make_shared<Task>(0, type, priority, [this, type, function = std::move(function)] {
+        return runWithWorkerContext(type, function);
+    });
+    return submitTask(task);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskID BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::submitDataflowTask(TaskType type, Priority priority,
+                                         std::function<TaskResult(std::vector<std::any>& inputs)> function,
+                                         const std::vector<TaskID>& dependencies) {
+    auto task = std::make_shared<Task>(0, type, priority, nullptr);
+    // 任务对象持有函数，捕获裸指针不形成循环引用
+    task->function = [owner = task.get(), function = std::move(function)] {
+        return function(owner->inputs);
+    };
+    task->dependencies = dependencies;
+    task->dataflow = true;
+    return submitTask(task);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskResult BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::runWithWorkerContext(TaskType type,
+                                               const std::function<TaskResult(WorkerContext&)>& function) {
+    size_t index = static_cast<size_t>(type);
+    std::shared_ptr<WorkerContextSlots> slots;
+    WorkerContextFactory factory;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(contextMutex_);
+        if (index >= contextFactories_.size() || !contextFactories_[index].first) {
+            throw std::runtime_error("No worker context factory registered for " + taskTypeToString(type));
+        }
+        
+        auto& entry = workerContexts_[std::this_thread::get_id()];
+        if (!entry) {
+            entry = std::make_shared<WorkerContextSlots>();
+        }
+        slots = entry;
+        
+        // 只有需要创建时才复制工厂
+        generation = contextFactories_[index].second;
+        const auto& slot = slots->slots[index];
+        if (slot.inUse || !slot.context || slot.generation != generation) {
+            factory = contextFactories_[index].first;
+        }
+    }
+    
+    // 工厂在锁外调用，加载模型等耗时操作不阻塞其他线程
+    auto create = [this, &factory, type] {
+        std::unique_ptr<WorkerContext> context = factory();
+        if (!context) {
+            throw std::runtime_error("Worker context factory returned null for " + taskTypeToString(type));
+        }
+        countMetric(Metric::WORKER_CONTEXTS_CREATED);
+        return context;
+    };
+    
+    auto& slot = slots->slots[index];
+    if (slot.inUse) {
+        // 外层同类任务仍在使用本线程的上下文
+        std::unique_ptr<WorkerContext> temporary = create();
+        return function(*temporary);
+    }
+    
+    if (!slot.context || slot.generation != generation) {
+        slot.context.reset();  // 先释放旧上下文，避免同时占用两份资源
+        slot.context = create();
+        slot.generation = generation;
+    }
+    
+    struct InUseGuard {
+        WorkerContextSlots::Slot& slot;
+        explicit InUseGuard(WorkerContextSlots::Slot& s) : slot(s) { slot.inUse = true; }
+        ~InUseGuard() { slot.inUse = false; }
+    } guard(slot);
+    
+    return function(*slot.context);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::releaseWorkerContexts() {
+    std::shared_ptr<WorkerContextSlots> slots;
+    {
+        std::lock_guard<std::mutex> lock(contextMutex_);
+        auto it = workerContexts_.find(std::this_thread::get_id());
+        if (it == workerContexts_.end()) {
+            return;
+        }
+        slots = std::move(it->second);
+        workerContexts_.erase(it);
+    }
+    
+    // 在创建它们的线程上销毁，线程相关的资源由同一线程释放
+    slots.reset();
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::cancelTask(TaskID taskId) {
+    std::shared_ptr<Task> cancelled;
+    drainChannels(true);
+    
+    {
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        
+        auto status = taskTable_->status(taskId);
+        if (!status) {
+            return false; // 任务不存在
+        }
+        
+        // 只能取消处于PENDING状态的任务
+        if (*status != TaskStatus::PENDING) {
+            return false;
+        }
+        
+        // 尝试从队列中移除任务（带亲和键的任务在对应的亲和队列中，亲和队列退役后转入全局队列）；
+        // 仍在等待依赖的任务不在队列中，释放时因状态已变而被跳过
+        auto task = taskTable_->task(taskId);
+        bool waiting = task && task->remainingDependencies > 0;
+        QueuePolicy& queue = task ? queueFor(*task) : *taskQueue_;
+        if (!waiting && !queue.removeTask(taskId) &&
+            (&queue == taskQueue_.get() || !taskQueue_->removeTask(taskId))) {
+            return false;
+        }
+        
+        taskTable_->setStatus(taskId, TaskStatus::CANCELLED);
+        if (task) {
+            cancelled = std::move(task);
+            taskTable_->release(taskId);
+        }
+        taskFinished_.notify_all();
+    }
+    
+    if (cancelled) {
+        notifyCancelled({cancelled});
+    }
+    return true;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+size_t BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::cancelTasks(const std::vector<TaskID>& taskIds) {
+    std::vector<std::shared_ptr<Task>> cancelled;
+    drainChannels(true);
     
     {
-        std::lock_guard<std::mutex> resultsLock(resultsMutex_);
-        completedTasks_.clear();
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        
+        std::unordered_set<TaskID> pending;
+        for (TaskID taskId : taskIds) {
+            if (taskTable_->status(taskId) == TaskStatus::PENDING) {
+                pending.insert(taskId);
+            }
+        }
+        
+        // 已出队但尚未被认领的任务不在队列中，继续正常执行
+        cancelled = taskQueue_->removeTasks(pending);
+        for (auto& slot : affinitySlots_) {
+            if (cancelled.size() == pending.size()) {
+                break;
+            }
+            auto removed = slot->queue.removeTasks(pending);
+            cancelled.insert(cancelled.end(), removed.begin(), removed.end());
+        }
+        
+        // 仍在等待依赖的任务
+        if (cancelled.size() < pending.size()) {
+            for (const auto& task : cancelled) {
+                pending.erase(task->id);
+            }
+            for (TaskID taskId : pending) {
+                auto task = taskTable_->task(taskId);
+                if (task && task->remainingDependencies > 0) {
+                    cancelled.push_back(std::move(task));
+                }
+            }
+        }
+        for (const auto& task : cancelled) {
+            taskTable_->setStatus(task->id, TaskStatus::CANCELLED);
+            taskTable_->release(task->id);
+        }
+        
+        if (!cancelled.empty()) {
+            taskFinished_.notify_all();
+        }
     }
+    
+    notifyCancelled(cancelled);
+    return cancelled.size();
 }
 
-bool TaskScheduler::isRunning() const {
-    return running_;
-}
-
-// 任务管理
-TaskID TaskScheduler::generateTaskId() {
-    return nextTaskId_.fetch_add(1);
-}
-
-TaskID TaskScheduler::submitTask(std::shared_ptr<Task> task) {
-    if (!running_ || !task) {
-        return 0; // 无效的任务ID
-    }
-    
-    if (paused_) {
-        return 0; // 系统暂停中
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::notifyCancelled(const std::vector<std::shared_ptr<Task>>& tasks, ResultStatus status) {
+    // 不再执行的任务撤销排队时限
+    for (const auto& task : tasks) {
+        if (task->queueTimeout != std::chrono::milliseconds::max()) {
+            deadlines_->disarm(*task);
+        }
     }
     
-    // 生成任务ID
-    task->id = generateTaskId();
-    
-    // 检查依赖（在里程碑2中，暂时忽略依赖检查）
-    // if (!task->dependencies.empty() && !checkDependencies(task->dependencies)) {
-    //     return 0; // 依赖未满足
-    // }
-    
-    // 记录任务状态
+    // 被取消（或排队超时）任务的后继随之取消
+    std::vector<std::shared_ptr<Task>> successors;
     {
-        std::lock_guard<std::mutex> lock(statusMutex_);
-        taskStatuses_[task->id] = TaskStatus::PENDING;
-        activeTasks_[task->id] = task;
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        for (const auto& task : tasks) {
+            for (auto& successor : task->successors) {
+                successors.push_back(std::move(successor));
+            }
+            task->successors.clear();
+        }
     }
-    
-    // 更新性能指标
-    {
-        std::lock_guard<std::mutex> lock(resultsMutex_);
-        currentMetrics_.totalTasksSubmitted++;
-        currentMetrics_.currentQueueSize = taskQueue_->size() + 1;
+    if (!successors.empty()) {
+        releaseSuccessors(successors, false);
     }
     
-    // 将任务加入队列
-    taskQueue_->push(task);
-    
-    return task->id;
+    // 在锁外调用完成回调
+    for (const auto& task : tasks) {
+        if (task->onComplete) {
+            TaskResult result = status == ResultStatus::TIMEOUT
+                ? timeoutResult(task->id, kQueueTimeoutMessage)
+                : TaskResult(task->id, status);
+            result.completionTime = std::chrono::steady_clock::now();
+            task->onComplete(result);
+        }
+    }
 }
 
-TaskID TaskScheduler::submitTask(TaskType type, Priority priority, std::function<TaskResult()> function) {
-    auto task = std::make_shared<Task>(0, type, priority, std::move(function));
-    return submitTask(task);
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskStatus BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::getTaskStatus(TaskID taskId) {
+    // 无锁查询：提交通道中尚未取出的任务已分配ID和PENDING记录，不需要先取出通道；
+    // 任务不存在或记录已被回收，返回CANCELLED
+    return taskTable_->status(taskId).value_or(TaskStatus::CANCELLED);
 }
 
-TaskID TaskScheduler::submitTask(TaskType type, Priority priority, std::function<TaskResult()> function,
-                               std::chrono::milliseconds timeout) {
-    auto task = std::make_shared<Task>(0, type, priority, std::move(function));
-    task->timeout = timeout;
-    return submitTask(task);
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::hasTaskRecord(TaskID taskId) const {
+    return taskTable_->status(taskId).has_value();
 }
 
-TaskID TaskScheduler::submitTask(TaskType type, Priority priority, std::function<TaskResult()> function,
-                               const std::vector<TaskID>& dependencies) {
-    auto task = std::make_shared<Task>(0, type, priority, std::move(function));
-    task->dependencies = dependencies;
-    return submitTask(task);
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+std::vector<TaskResult> BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::getCompletedTasks() {
+    return completedTasks_->snapshot();
 }
 
-bool TaskScheduler::cancelTask(TaskID taskId) {
-    std::lock_guard<std::mutex> lock(statusMutex_);
-    
-    auto statusIt = taskStatuses_.find(taskId);
-    if (statusIt == taskStatuses_.end()) {
-        return false; // 任务不存在
-    }
-    
-    // 只能取消处于PENDING状态的任务
-    if (statusIt->second == TaskStatus::PENDING) {
-        // 尝试从队列中移除任务
-        if (taskQueue_->removeTask(taskId)) {
-            statusIt->second = TaskStatus::CANCELLED;
-            activeTasks_.erase(taskId);
-            return true;
-        }
-    }
-    
-    return false;
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::clearCompletedTasks() {
+    // 丢弃的结果在释放状态锁后销毁
+    std::vector<std::shared_ptr<const void>> dropped;
+    std::lock_guard<LockPolicy> lock(statusMutex_);
+    dropped = completedTasks_->clear();
 }
 
-TaskStatus TaskScheduler::getTaskStatus(TaskID taskId) {
-    std::lock_guard<std::mutex> lock(statusMutex_);
-    
-    auto it = taskStatuses_.find(taskId);
-    if (it != taskStatuses_.end()) {
-        return it->second;
-    }
-    
-    return TaskStatus::CANCELLED; // 任务不存在，返回CANCELLED
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+ResultCursor BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::completedTasksCursor() const {
+    ResultCursor cursor;
+    cursor.next = completedTasks_->head();
+    return cursor;
 }
 
-std::vector<TaskResult> TaskScheduler::getCompletedTasks() {
-    std::lock_guard<std::mutex> lock(resultsMutex_);
-    return completedTasks_;
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+size_t BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::readCompletedTasks(ResultCursor& cursor, const std::function<void(const TaskResult&)>& callback,
+                                         size_t maxResults) const {
+    return completedTasks_->read(cursor, callback, maxResults);
 }
 
-void TaskScheduler::clearCompletedTasks() {
-    std::lock_guard<std::mutex> lock(resultsMutex_);
-    completedTasks_.clear();
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+size_t BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::drainCompletedTasks(const std::function<void(const TaskResult&)>& callback, size_t maxResults) {
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    return completedTasks_->read(drainCursor_, callback, maxResults);
 }
 
 // 配置和控制
-void TaskScheduler::updateConfig(const SchedulerConfig& config) {
-    std::lock_guard<std::mutex> lock(configMutex_);
-    config_ = config;
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::updateConfig(const SchedulerConfig& config) {
+    {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        // 纤程载体线程数只在初始化时生效，线程池大小按它计算
+        size_t fiberCarriers = config_.fiberCarriers;
+        config_ = config;
+        config_.fiberCarriers = fiberCarriers;
+        osPriorityMapping_ = config_.enableOsPriorityMapping;
+        realtimeScheduling_ = config_.allowRealtimeScheduling;
+        rejectionPolicy_ = config_.rejectionPolicy;
+        maxQueueSize_ = config_.maxQueueSize;
+        affinityStealThreshold_ = config_.affinityStealThreshold;
+        defaultTimeout_ = config_.defaultTimeout;
+        combineSubmissions_ = config_.combineSubmissions;
+        collectMetrics_ = config_.collectMetrics;
+    }
     
-    // 调整线程池大小
-    if (threadPool_ && config_.minThreads != threadPool_->getPoolSize()) {
-        threadPool_->resize(config_.minThreads);
+    // 按工作循环调整线程数，不在配置锁下等待多余的循环退出
+    if (threadPool_ && config.minThreads != targetWorkers_) {
+        adjustThreadPoolSize(config.minThreads);
     }
 }
 
-SchedulerConfig TaskScheduler::getConfig() const {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+SchedulerConfig BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::getConfig() const {
     std::lock_guard<std::mutex> lock(configMutex_);
     return config_;
 }
 
-void TaskScheduler::pauseScheduling() {
-    paused_ = true;
-    if (taskQueue_) {
-        taskQueue_->stop();
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::pauseScheduling() {
+    // 与claimTask在同一把锁下切换：返回后不会再有任务被认领
+    {
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        paused_ = true;
     }
+    wakeWorkers();
 }
 
-void TaskScheduler::resumeScheduling() {
-    paused_ = false;
-    if (taskQueue_) {
-        taskQueue_->resume();
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::resumeScheduling() {
+    {
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        paused_ = false;
+    }
+    wakeWorkers();
+    if (executor_) {
+        executor_->notify();
     }
 }
 
-bool TaskScheduler::isPaused() const {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::isPaused() const {
     return paused_;
 }
 
 // 监控和统计
-PerformanceMetrics TaskScheduler::getPerformanceMetrics() {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+PerformanceMetrics BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::getPerformanceMetrics() {
+    // 按statusMutex_、resultsMutex_的顺序加锁
+    size_t retainedRecords = 0;
+    {
+        std::lock_guard<LockPolicy> statusLock(statusMutex_);
+        retainedRecords = taskTable_->retained();
+    }
+    
+    // 直方图不需要加锁，在锁外合并
+    double averageWaitTime = latencies_->distribution(LatencyKind::QUEUE_WAIT, std::nullopt, std::nullopt).mean();
+    
     std::lock_guard<std::mutex> lock(resultsMutex_);
+    currentMetrics_.taskRecordSlots = taskTable_->capacity();
+    currentMetrics_.retainedTaskRecords = retainedRecords;
+    currentMetrics_.averageWaitTime = averageWaitTime;
     
     // 更新实时指标
     if (threadPool_) {
         currentMetrics_.currentActiveThreads = threadPool_->getActiveThreads();
     }
     if (taskQueue_) {
-        currentMetrics_.currentQueueSize = taskQueue_->size();
+        currentMetrics_.currentQueueSize = queuedTaskCount();
     }
     
-    currentMetrics_.lastUpdateTime = std::chrono::steady_clock::now();
+    updateMetricsLocked();
     return currentMetrics_;
 }
 
-QueueStatus TaskScheduler::getQueueStatus() {
-    std::lock_guard<std::mutex> lock(statusMutex_);
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+LatencyDistribution BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::getLatencyDistribution(LatencyKind kind, std::optional<Priority> priority,
+                                                         std::optional<TaskType> type) const {
+    return latencies_->distribution(kind, priority, type);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+double BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::getLatencyPercentile(LatencyKind kind, double percent, std::optional<Priority> priority,
+                                           std::optional<TaskType> type) const {
+    return latencies_->distribution(kind, priority, type).percentile(percent);
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+QueueStatus BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::getQueueStatus() {
+    std::lock_guard<LockPolicy> lock(statusMutex_);
     
     QueueStatus status;
     
     // 统计各种状态的任务数量
-    for (const auto& [taskId, taskStatus] : taskStatuses_) {
+    taskTable_->forEach([&status](TaskID, TaskStatus taskStatus, const std::shared_ptr<Task>&) {
         switch (taskStatus) {
             case TaskStatus::PENDING:
                 status.pendingTasks++;
@@ -344,7 +1867,7 @@ QueueStatus TaskScheduler::getQueueStatus() {
             default:
                 break;
         }
-    }
+    });
     
     // 从优先级队列获取优先级分布
     if (taskQueue_) {
@@ -354,7 +1877,8 @@ QueueStatus TaskScheduler::getQueueStatus() {
     return status;
 }
 
-std::vector<std::string> TaskScheduler::getSystemLogs() {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+std::vector<std::string> BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::getSystemLogs() {
     std::vector<std::string> logs;
     
     logs.push_back("TaskScheduler Status Report");
@@ -379,7 +1903,8 @@ std::vector<std::string> TaskScheduler::getSystemLogs() {
     return logs;
 }
 
-void TaskScheduler::exportMetrics(const std::string& filePath) {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::exportMetrics(const std::string& filePath) {
     auto metrics = getPerformanceMetrics();
     
     std::ofstream file(filePath);
@@ -389,52 +1914,112 @@ void TaskScheduler::exportMetrics(const std::string& filePath) {
         file << "Total Tasks Submitted: " << metrics.totalTasksSubmitted << "\n";
         file << "Total Tasks Completed: " << metrics.totalTasksCompleted << "\n";
         file << "Total Tasks Failed: " << metrics.totalTasksFailed << "\n";
+        file << "Total Tasks Run Inline: " << metrics.totalTasksRunInline << "\n";
+        file << "Total Tasks Rejected: " << metrics.totalTasksRejected << "\n";
+        file << "Total Tasks Timed Out: " << metrics.totalTasksTimedOut << "\n";
         file << "Average Execution Time: " << metrics.averageExecutionTime << " ms\n";
         file << "Average Wait Time: " << metrics.averageWaitTime << " ms\n";
+        LatencyDistribution wait = getLatencyDistribution(LatencyKind::QUEUE_WAIT);
+        LatencyDistribution endToEnd = getLatencyDistribution(LatencyKind::END_TO_END);
+        file << "Queue Wait p50/p99/p99.9: " << wait.percentile(50) << " / " << wait.percentile(99) << " / "
+             << wait.percentile(99.9) << " ms\n";
+        file << "End-to-End p50/p99/p99.9: " << endToEnd.percentile(50) << " / " << endToEnd.percentile(99) << " / "
+             << endToEnd.percentile(99.9) << " ms\n";
         file << "Current Active Threads: " << metrics.currentActiveThreads << "\n";
         file << "Current Queue Size: " << metrics.currentQueueSize << "\n";
+        file << "Affinity Tasks: " << metrics.totalAffinityTasks << "\n";
+        file << "Affinity Hit Rate: " << metrics.affinityHitRate * 100 << " %\n";
+        file << "Affinity Steals: " << metrics.totalAffinitySteals << "\n";
         file.close();
     }
 }
 
 // 高级功能
-void TaskScheduler::setLoadBalancingStrategy(LoadBalancingStrategy strategy) {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::setLoadBalancingStrategy(LoadBalancingStrategy strategy) {
     std::lock_guard<std::mutex> lock(configMutex_);
     config_.strategy = strategy;
 }
 
-void TaskScheduler::adjustThreadPoolSize(size_t newSize) {
-    if (threadPool_ && newSize > 0 && newSize <= config_.maxThreads) {
-        size_t currentSize = threadPool_->getPoolSize();
-        
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::adjustThreadPoolSize(size_t newSize) {
+    size_t maxThreads = 0;
+    size_t fiberCarriers = 0;
+    {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        maxThreads = config_.maxThreads;
+        fiberCarriers = config_.fiberCarriers;
+    }
+    if (!threadPool_ || !running_ || newSize == 0 || newSize > maxThreads) {
+        return;
+    }
+    
+    bool shrinking = false;
+    {
+        std::lock_guard<std::mutex> resizeLock(resizeMutex_);
+        size_t currentSize = targetWorkers_.exchange(newSize);
         if (newSize > currentSize) {
-            // 增加工作线程
-            for (size_t i = currentSize; i < newSize; ++i) {
-                threadPool_->enqueue([this] { workerThread(); });
-            }
+            // 增加工作线程，每个线程运行一个工作循环
+            threadPool_->resize(newSize + fiberCarriers);
+            startWorkers(newSize - currentSize);
+        } else if (newSize < currentSize) {
+            // 多余的工作循环在当前任务结束后退出，线程池随后回收空闲的线程（这里不等待）
+            wakeWorkers();
+            threadPool_->resize(newSize + fiberCarriers, false);
+            shrinking = true;
         }
-        
-        threadPool_->resize(newSize);
-        
-        std::lock_guard<std::mutex> lock(resultsMutex_);
-        currentMetrics_.currentActiveThreads = newSize;
     }
+    
+    // 正在集结的gang超过缩减后的线程数时不再等待，发起者以失败结束
+    if (shrinking) {
+        {
+            std::lock_guard<std::mutex> lock(gangMutex_);
+        }
+        gangCondition_.notify_all();
+    }
+    
+    // 锁外等待多余的线程退出；在本线程池的线程上（如任务中）调用时不等待，要退出的可能正是调用方自己
+    if (shrinking && ThreadPool::current() != threadPool_.get()) {
+        threadPool_->waitForRemovals();
+    }
+    
+    std::lock_guard<std::mutex> lock(resultsMutex_);
+    currentMetrics_.currentActiveThreads = newSize;
 }
 
-void TaskScheduler::flushLogs() {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::flushLogs() {
     // 强制刷新日志（在后续里程碑中实现完整的日志系统）
 }
 
 // 内部方法的实现
-void TaskScheduler::processTask(std::shared_ptr<Task> task) {
-    if (!task) return;
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskResult BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::processTask(std::shared_ptr<Task> task, bool callerThread) {
+    if (!task) return TaskResult(0, ResultStatus::FAILURE);
+    
+    // 切换到与任务优先级对应的OS调度类别，权限不足时保持默认
+    // 在调用线程上执行时不改变调用方线程的调度类别；载体线程由多个纤程共享，
+    // 纤程任务还可能在另一个载体线程上恢复，同样不改变载体线程的调度类别
+    bool mapPriority = osPriorityMapping_ && !callerThread && !FiberRuntime::inFiber();
+    if (mapPriority) {
+        applyThreadPriority(task->priority, realtimeScheduling_);
+    }
+    
+    // 任务内发起的并行算法等据此继承优先级，调用waitForTask/waitForTasks时据此帮忙执行其他任务，
+    // currentTaskTimedOut据此查询本任务
+    TaskContextScope contextScope(this, task.get());
     
     auto startTime = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point endTime;
     
-    // 更新任务状态为运行中
-    {
-        std::lock_guard<std::mutex> lock(statusMutex_);
-        taskStatuses_[task->id] = TaskStatus::RUNNING;
+    // 开始执行：排队时限换成执行时限，结束时撤销；不限时的任务不经过超时堆
+    std::chrono::milliseconds timeout = task->timeout != std::chrono::milliseconds::max()
+        ? task->timeout : defaultTimeout_.load(std::memory_order_relaxed);
+    bool timed = timeout != std::chrono::milliseconds::max();
+    if (timed) {
+        deadlines_->arm(task, DeadlineHeap::Kind::EXECUTION, startTime + timeout);
+    } else if (task->queueTimeout != std::chrono::milliseconds::max()) {
+        deadlines_->disarm(*task);
     }
     
     TaskResult result;
@@ -450,73 +2035,193 @@ void TaskScheduler::processTask(std::shared_ptr<Task> task) {
         }
         
         // 计算执行时间
-        auto endTime = std::chrono::steady_clock::now();
+        endTime = std::chrono::steady_clock::now();
         result.executionTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
         result.completionTime = endTime;
         
-        // 处理任务完成
-        handleTaskCompletion(result);
+        // 处理任务完成；已执行超时的任务保留超时结果
+        if (!handleTaskCompletion(result, *task)) {
+            TaskResult timedOut = timeoutResult(task->id, kExecutionTimeoutMessage);
+            timedOut.executionTime = result.executionTime;
+            result = std::move(timedOut);
+        }
         
     } catch (const std::exception& e) {
         // 处理任务失败
-        handleTaskFailure(task->id, e.what());
+        endTime = std::chrono::steady_clock::now();
+        result = handleTaskFailure(task->id, e.what());
     } catch (...) {
         // 处理未知异常
-        handleTaskFailure(task->id, "Unknown exception occurred");
+        endTime = std::chrono::steady_clock::now();
+        result = handleTaskFailure(task->id, "Unknown exception occurred");
+    }
+    
+    if (timed) {
+        deadlines_->disarm(*task);
+    }
+    
+    // 延迟直方图：复用上面的时间戳，不加锁
+    if constexpr (MetricsPolicy::kEnabled) {
+        if (collectMetrics_.load(std::memory_order_relaxed)) {
+            latencies_->record(task->priority, task->type, task->submitTime, startTime, endTime);
+        }
     }
     
-    // 从活跃任务中移除
+    // 从活跃任务中移除，同时取走后继：之后登记的依赖任务会看到本任务的终态
+    std::vector<std::shared_ptr<Task>> successors;
+    bool succeeded = false;
     {
-        std::lock_guard<std::mutex> lock(statusMutex_);
-        activeTasks_.erase(task->id);
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        if (!task->successors.empty()) {
+            successors.swap(task->successors);
+            succeeded = taskTable_->status(task->id) == TaskStatus::COMPLETED;
+        }
+        taskTable_->release(task->id);
+    }
+    
+    // 数据流后继：结果放入dependencies中对应位置的输入槽，最后一个槽直接移入
+    if (succeeded) {
+        std::any* last = nullptr;
+        for (const auto& successor : successors) {
+            if (!successor->dataflow) {
+                continue;
+            }
+            for (size_t i = 0; i < successor->dependencies.size(); ++i) {
+                if (successor->dependencies[i] == task->id) {
+                    if (last) {
+                        *last = result.result;
+                    }
+                    last = &successor->inputs[i];
+                }
+            }
+        }
+        if (last) {
+            *last = std::move(result.result);
+            result.result.reset();
+        }
+    }
+    
+    // 先释放后继再通知完成，等待本任务的一方随后即可看到后继已入队
+    if (!successors.empty()) {
+        releaseSuccessors(successors, succeeded);
+    }
+    
+    if (task->onComplete) {
+        task->onComplete(result);
+    }
+    
+    // 降级的线程在空闲等待前恢复，否则被CPU密集负载饿死后无法及时接手高优先级任务
+    if (mapPriority && static_cast<int>(task->priority) > static_cast<int>(Priority::NORMAL)) {
+        resetThreadPriority();
     }
+    
+    return result;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskResult BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::runInline(std::shared_ptr<Task> task) {
+    countMetric(Metric::TASKS_RUN_INLINE);
+    return processTask(task, true);
 }
 
-void TaskScheduler::updateMetrics() {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::updateMetrics() {
     // 更新性能指标
     std::lock_guard<std::mutex> lock(resultsMutex_);
+    updateMetricsLocked();
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::updateMetricsLocked() {
+    // 调用方已持有resultsMutex_；合并各线程的计数分片
+    typename MetricsPolicy::Values counts = counters_->snapshot();
+    auto count = [&counts](Metric metric) { return static_cast<size_t>(counts[static_cast<size_t>(metric)]); };
+    
+    currentMetrics_.totalTasksSubmitted = count(Metric::TASKS_SUBMITTED);
+    currentMetrics_.totalTasksCompleted = count(Metric::TASKS_COMPLETED);
+    currentMetrics_.totalTasksFailed = count(Metric::TASKS_FAILED);
+    currentMetrics_.totalTasksRunInline = count(Metric::TASKS_RUN_INLINE);
+    currentMetrics_.totalTasksRejected = count(Metric::TASKS_REJECTED);
+    currentMetrics_.totalTasksTimedOut = count(Metric::TASKS_TIMED_OUT);
+    currentMetrics_.totalSubmitBatches = count(Metric::SUBMIT_BATCHES);
+    currentMetrics_.totalWorkerContextsCreated = count(Metric::WORKER_CONTEXTS_CREATED);
+    currentMetrics_.totalAffinityTasks = count(Metric::AFFINITY_TASKS);
+    currentMetrics_.affinityLocalHits = count(Metric::AFFINITY_LOCAL_HITS);
+    currentMetrics_.totalAffinitySteals = count(Metric::AFFINITY_STEALS);
+    currentMetrics_.affinityHitRate = currentMetrics_.totalAffinityTasks > 0
+        ? static_cast<double>(currentMetrics_.affinityLocalHits) / currentMetrics_.totalAffinityTasks
+        : 0.0;
     
-    // 计算平均执行时间
+    // 平均执行时间（累计值，不遍历结果环）
     if (currentMetrics_.totalTasksCompleted > 0) {
-        double totalExecTime = 0;
-        for (const auto& result : completedTasks_) {
-            totalExecTime += result.executionTime.count();
-        }
-        currentMetrics_.averageExecutionTime = totalExecTime / currentMetrics_.totalTasksCompleted;
+        currentMetrics_.averageExecutionTime =
+            static_cast<double>(count(Metric::EXECUTION_MILLIS)) / currentMetrics_.totalTasksCompleted;
     }
     
-    // 计算平均等待时间（简化版本）
-    // 在完整实现中，需要记录任务从提交到开始执行的时间
+    currentMetrics_.totalGangsRun = count(Metric::GANGS_RUN);
+    if (currentMetrics_.totalGangsRun > 0) {
+        currentMetrics_.averageGangWaitTime =
+            count(Metric::GANG_WAIT_MICROS) / 1000.0 / currentMetrics_.totalGangsRun;
+    }
+    currentMetrics_.maxGangWaitTime = maxGangWaitMicros_.load(std::memory_order_relaxed) / 1000.0;
     
     currentMetrics_.lastUpdateTime = std::chrono::steady_clock::now();
 }
 
-void TaskScheduler::handleTaskCompletion(const TaskResult& result) {
-    std::lock_guard<std::mutex> statusLock(statusMutex_);
-    std::lock_guard<std::mutex> resultsLock(resultsMutex_);
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::countMetric(Metric metric, uint64_t value) {
+    if constexpr (MetricsPolicy::kEnabled) {
+        if (collectMetrics_.load(std::memory_order_relaxed)) {
+            counters_->add(metric, value);
+        }
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::handleTaskCompletion(const TaskResult& result, const Task& task) {
+    std::shared_ptr<const void> evicted;    // 被覆盖的结果在释放状态锁后销毁
+    std::lock_guard<LockPolicy> statusLock(statusMutex_);
     
-    // 更新任务状态
-    taskStatuses_[result.taskId] = TaskStatus::COMPLETED;
+    // 执行超时时超时线程已记录结果
+    if (taskTable_->status(result.taskId) == TaskStatus::TIMEOUT) {
+        return false;
+    }
     
-    // 保存结果
-    completedTasks_.push_back(result);
+    // 更新任务状态
+    taskTable_->setStatus(result.taskId, TaskStatus::COMPLETED);
     
-    // 限制完成任务列表的大小
-    if (completedTasks_.size() > 1000) {
-        completedTasks_.erase(completedTasks_.begin());
+    // 保存结果；结果值将交给数据流后继时只保存状态，完成列表不延长大块数据的生命周期
+    bool forwarded = std::any_of(task.successors.begin(), task.successors.end(),
+                                 [](const std::shared_ptr<Task>& successor) { return successor->dataflow; });
+    if (forwarded) {
+        TaskResult record(result.taskId, result.status);
+        record.executionTime = result.executionTime;
+        record.completionTime = result.completionTime;
+        record.forwarded = true;
+        evicted = completedTasks_->push(std::move(record));
+    } else {
+        evicted = completedTasks_->push(result);
     }
     
     // 更新指标
-    currentMetrics_.totalTasksCompleted++;
-    updateMetrics();
+    countMetric(Metric::TASKS_COMPLETED);
+    countMetric(Metric::EXECUTION_MILLIS, static_cast<uint64_t>(result.executionTime.count()));
+    
+    taskFinished_.notify_all();
+    return true;
 }
 
-void TaskScheduler::handleTaskFailure(TaskID taskId, const std::string& error) {
-    std::lock_guard<std::mutex> statusLock(statusMutex_);
-    std::lock_guard<std::mutex> resultsLock(resultsMutex_);
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+TaskResult BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::handleTaskFailure(TaskID taskId, const std::string& error) {
+    std::shared_ptr<const void> evicted;    // 被覆盖的结果在释放状态锁后销毁
+    std::lock_guard<LockPolicy> statusLock(statusMutex_);
+    
+    if (taskTable_->status(taskId) == TaskStatus::TIMEOUT) {
+        return timeoutResult(taskId, kExecutionTimeoutMessage);
+    }
     
     // 更新任务状态
-    taskStatuses_[taskId] = TaskStatus::FAILED;
+    taskTable_->setStatus(taskId, TaskStatus::FAILED);
     
     // 创建失败结果
     TaskResult result;
@@ -525,37 +2230,254 @@ void TaskScheduler::handleTaskFailure(TaskID taskId, const std::string& error) {
     result.errorMessage = error;
     result.completionTime = std::chrono::steady_clock::now();
     
-    completedTasks_.push_back(result);
+    evicted = completedTasks_->push(result);
     
     // 更新指标
-    currentMetrics_.totalTasksFailed++;
+    countMetric(Metric::TASKS_FAILED);
+    
+    taskFinished_.notify_all();
+    return result;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::workerThread(size_t affinitySlot, bool compensation) {
+    QueueWaiter ownWaiter;
+    QueueWaiter* waiter = &ownWaiter;
+    AffinitySlot<QueuePolicy>* slot = nullptr;
+    if (affinitySlot != kNoAffinitySlot) {
+        slot = affinitySlots_[affinitySlot].get();
+        waiter = &slot->waiter;
+        tlsAffinityScheduler = this;
+        tlsAffinitySlot = affinitySlot;
+    }
+    
+    // 补偿线程在阻塞结束后退出循环，其他循环在目标线程数减少时退出
+    while (running_) {
+        if (compensation ? ThreadPool::currentThreadShouldRetire() : retireSurplusWorker(affinitySlot)) {
+            break;
+        }
+        
+        // 有gang在集结时优先加入（暂停前已开始集结的gang照常完成）
+        if (joinGang()) {
+            continue;
+        }
+        
+        // 先取唤醒序号并标记空闲，再取出提交通道和检查亲和队列：
+        // 之后写入通道或提交到本线程亲和队列的任务必然唤醒本线程
+        uint64_t wakeEpoch = taskQueue_->wakeEpoch();
+        if (paused_) {
+            waitWhilePaused(wakeEpoch);
+            continue;
+        }
+        idleWorkers_++;
+        if (slot) {
+            slot->idle = true;
+        }
+        drainChannels(false);
+        auto task = nextAffinityTask(affinitySlot);
+        
+        // 阻塞到有任务入队或被唤醒，没有定时轮询
+        if (!task) {
+            task = taskQueue_->pop(wakeEpoch, *waiter);
+        }
+        idleWorkers_--;
+        if (slot) {
+            slot->idle = false;
+        }
+        
+        if (task) {
+            executeTask(task);
+        }
+    }
+    
+    if (slot) {
+        tlsAffinityScheduler = nullptr;
+    }
+    
+    // 归还线程前销毁本线程的工作线程上下文并恢复默认调度类别
+    releaseWorkerContexts();
+    if (osPriorityMapping_) {
+        resetThreadPriority();
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::startWorkers(size_t count) {
+    std::vector<size_t> slots;
+    {
+        // 先接管退役的亲和队列
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        for (size_t i = 0; i < affinitySlots_.size() && slots.size() < count; ++i) {
+            if (affinitySlots_[i]->retired) {
+                affinitySlots_[i]->retired = false;
+                slots.push_back(i);
+            }
+        }
+        slotWorkers_ += slots.size();
+        extraWorkers_ += count - slots.size();
+    }
+    
+    for (size_t slot : slots) {
+        threadPool_->enqueue([this, slot] { workerThread(slot); });
+    }
+    for (size_t i = slots.size(); i < count; ++i) {
+        threadPool_->enqueue([this] { workerThread(); });
+    }
 }
 
-bool TaskScheduler::checkDependencies(const std::vector<TaskID>& dependencies) {
-    std::lock_guard<std::mutex> lock(statusMutex_);
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::retireSurplusWorker(size_t affinitySlot) {
+    if (slotWorkers_ + extraWorkers_ <= targetWorkers_) {
+        return false;
+    }
     
-    for (TaskID depId : dependencies) {
-        auto it = taskStatuses_.find(depId);
-        if (it == taskStatuses_.end() || it->second != TaskStatus::COMPLETED) {
+    bool surplus = false;
+    {
+        // 不带亲和队列的循环先退出
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        if (slotWorkers_ + extraWorkers_ <= targetWorkers_) {
+            return false;
+        }
+        if (affinitySlot == kNoAffinitySlot) {
+            extraWorkers_--;
+        } else if (extraWorkers_ > 0) {
             return false;
+        } else {
+            slotWorkers_--;
+            affinitySlots_[affinitySlot]->retired = true;
         }
+        surplus = slotWorkers_ + extraWorkers_ > targetWorkers_;
+    }
+    
+    // 退役亲和队列中剩余的任务由其他线程执行
+    if (affinitySlot != kNoAffinitySlot) {
+        moveAffinityTasks(*affinitySlots_[affinitySlot]);
     }
     
+    // 仍有多余的循环时唤醒它们：之前因不带亲和队列的循环未退出而没有退役的循环可能已在等待
+    if (surplus) {
+        wakeWorkers();
+    }
     return true;
 }
 
-void TaskScheduler::workerThread() {
-    while (running_) {
-        // 从队列中获取任务
-        auto task = taskQueue_->popWithTimeout(std::chrono::milliseconds(100));
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::moveAffinityTasks(AffinitySlot<QueuePolicy>& slot) {
+    while (auto task = slot.queue.tryPop()) {
+        taskQueue_->push(task);
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::waitWhilePaused(uint64_t wakeEpoch) {
+    std::unique_lock<std::mutex> lock(pauseMutex_);
+    resumed_.wait(lock, [this, wakeEpoch] {
+        return !paused_ || !running_ || taskQueue_->wakeEpoch() != wakeEpoch;
+    });
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::wakeWorkers() {
+    if (!taskQueue_) {
+        return;
+    }
+    
+    // 唤醒阻塞在队列上和暂停等待中的工作线程，使其重新检查状态
+    taskQueue_->wakeAll();
+    {
+        std::lock_guard<std::mutex> lock(pauseMutex_);
+    }
+    resumed_.notify_all();
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::requeueTask(const std::shared_ptr<Task>& task) {
+    try {
+        enqueueTask(task);
+    } catch (const std::exception&) {
+        // 关闭过程中队列已停止：与其他排队任务一样通知取消
+        if (task->detached || claimTask(task)) {
+            notifyCancelled({task});
+        }
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::runNextTask() {
+    // 暂停时不出队，任务留在队列中
+    if (!running_ || paused_) {
+        return false;
+    }
+    
+    if (joinGang()) {
+        return true;
+    }
+    
+    drainChannels(false);
+    auto task = taskQueue_->tryPop();
+    if (!task) {
+        return false;
+    }
+    
+    executeTask(task);
+    return true;
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::executeTask(std::shared_ptr<Task> task) {
+    // 不登记状态的任务：不经过认领和结果记录，暂停期间放回队列
+    if (task->detached) {
+        if (paused_) {
+            requeueTask(task);
+            return;
+        }
         
-        if (task && !paused_) {
-            processTask(task);
+        TaskPriorityScope priorityScope(task->priority);
+        const void* previousScheduler = tlsCurrentScheduler;
+        tlsCurrentScheduler = this;
+        task->function();
+        tlsCurrentScheduler = previousScheduler;
+        return;
+    }
+    
+    // 状态由PENDING改为RUNNING，与waitForTask的认领互斥；暂停后才认领的任务放回队列，不会丢失
+    bool deferred = false;
+    if (!claimTask(task, &deferred)) {
+        if (deferred) {
+            requeueTask(task);
+        }
+        return;
+    }
+    
+    // 局部性统计：带亲和键的任务是否在其首选工作线程上执行
+    if (task->affinityKey != 0 && !affinitySlots_.empty()) {
+        countMetric(Metric::AFFINITY_TASKS);
+        if (ownAffinitySlot() == affinitySlotFor(task->affinityKey)) {
+            countMetric(Metric::AFFINITY_LOCAL_HITS);
+        }
+    }
+    
+    if (task->runOnFiber && fiberRuntime_) {
+        try {
+            fiberRuntime_->spawn([this, task] { processTask(task); });
+        } catch (const std::exception& e) {
+            handleTaskFailure(task->id, std::string("Fiber spawn failed: ") + e.what());
+            
+            std::vector<std::shared_ptr<Task>> successors;
+            {
+                std::lock_guard<LockPolicy> lock(statusMutex_);
+                successors.swap(task->successors);
+                taskTable_->release(task->id);
+            }
+            releaseSuccessors(successors, false);
         }
+    } else {
+        processTask(task);
     }
 }
 
-void TaskScheduler::monitorThread() {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::monitorThread() {
     while (running_) {
         // 定期更新性能指标
         updateMetrics();
@@ -564,7 +2486,7 @@ void TaskScheduler::monitorThread() {
         if (config_.enableLoadBalancing && threadPool_ && taskQueue_) {
             size_t queueSize = taskQueue_->size();
             // size_t activeThreads = threadPool_->getActiveThreads();
-            size_t poolSize = threadPool_->getPoolSize();
+            size_t poolSize = targetWorkers_;
             
             // 如果队列太长且有空闲容量，增加线程
             if (queueSize > poolSize * 2 && poolSize < config_.maxThreads) {
@@ -583,36 +2505,90 @@ void TaskScheduler::monitorThread() {
     }
 }
 
-void TaskScheduler::timeoutCheckThread() {
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::timeoutCheckThread() {
     while (running_) {
-        {
-            std::lock_guard<std::mutex> lock(statusMutex_);
-            
-            auto now = std::chrono::steady_clock::now();
-            
-            // 检查所有运行中的任务
-            for (auto& [taskId, status] : taskStatuses_) {
-                if (status == TaskStatus::RUNNING) {
-                    auto taskIt = activeTasks_.find(taskId);
-                    if (taskIt != activeTasks_.end()) {
-                        auto& task = taskIt->second;
-                        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            now - task->submitTime
-                        );
-                        
-                        // 检查是否超时
-                        if (elapsed > task->timeout) {
-                            handleTaskFailure(taskId, "Task timeout");
-                            status = TaskStatus::TIMEOUT;
-                        }
-                    }
-                }
+        // 睡眠到最早的截止时间（最长kTimeoutIdleWait），只取出到期的任务，不遍历任务表
+        auto expired = deadlines_->waitExpired(std::chrono::steady_clock::now() + kTimeoutIdleWait);
+        if (!expired.empty()) {
+            std::vector<std::shared_ptr<Task>> queued;
+            std::vector<std::shared_ptr<Task>> running;
+            for (auto& entry : expired) {
+                auto& tasks = entry.kind == DeadlineHeap::Kind::QUEUE_WAIT ? queued : running;
+                tasks.push_back(std::move(entry.task));
+            }
+            expireTasks(queued, running);
+        }
+        
+        // 没有任务结束时，超过保留时长的记录在这里回收
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        taskTable_->reclaimExpired();
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::armQueueDeadline(const std::shared_ptr<Task>& task) {
+    // 调用方持有statusMutex_，先于任何认领，开始执行时换上的执行时限不会被覆盖
+    if (task->queueTimeout != std::chrono::milliseconds::max()) {
+        deadlines_->arm(task, DeadlineHeap::Kind::QUEUE_WAIT, task->submitTime + task->queueTimeout);
+    }
+}
+
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+void BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::expireTasks(const std::vector<std::shared_ptr<Task>>& queued,
+                                const std::vector<std::shared_ptr<Task>>& running) {
+    std::vector<std::shared_ptr<Task>> timedOut;
+    std::vector<std::shared_ptr<const void>> evicted;
+    {
+        std::lock_guard<LockPolicy> lock(statusMutex_);
+        
+        // 排队超时：状态改为TIMEOUT后不会再被认领；到期前已开始执行或已结束的任务不受影响。
+        // 队列中的条目不在这里移除（移除要重建整个堆），与等待方认领的任务一样留作旧条目，
+        // 出队时跳过，在此之前不计入排队任务数；仍在等待依赖的任务不在任何队列中
+        for (const auto& task : queued) {
+            if (taskTable_->status(task->id) != TaskStatus::PENDING) {
+                continue;
+            }
+            if (task->remainingDependencies == 0) {
+                task->staleQueueEntry = true;
+                staleQueueEntries_++;
             }
+            taskTable_->setStatus(task->id, TaskStatus::TIMEOUT);
+            evicted.push_back(completedTasks_->push(timeoutResult(task->id, kQueueTimeoutMessage)));
+            taskTable_->release(task->id);
+            countMetric(Metric::TASKS_TIMED_OUT);
+            timedOut.push_back(task);
         }
         
-        // 休眠100ms
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // 执行超时：任务无法中止，先交出超时结果，等待方不再等它结束；任务结束时不再记录结果
+        for (const auto& task : running) {
+            if (taskTable_->status(task->id) != TaskStatus::RUNNING) {
+                continue;
+            }
+            task->expired.store(true, std::memory_order_relaxed);
+            taskTable_->setStatus(task->id, TaskStatus::TIMEOUT);
+            evicted.push_back(completedTasks_->push(timeoutResult(task->id, kExecutionTimeoutMessage)));
+            countMetric(Metric::TASKS_TIMED_OUT);
+        }
+        
+        taskFinished_.notify_all();
+    }
+    
+    // 排队超时的任务与取消的任务一样在锁外通知，后继随之取消
+    if (!timedOut.empty()) {
+        notifyCancelled(timedOut, ResultStatus::TIMEOUT);
     }
 }
 
-} // namespace YB
\ No newline at end of file
+template<typename QueuePolicy, typename LockPolicy, typename ResultPolicy, typename MetricsPolicy>
+bool BasicScheduler<QueuePolicy, LockPolicy, ResultPolicy, MetricsPolicy>::currentTaskTimedOut() {
+    return tlsCurrentTask && tlsCurrentTask->expired.load(std::memory_order_relaxed);
+}
+
+// 提供的策略组合，其他组合须在此添加（见TaskScheduler.h中BasicScheduler的说明）
+template class BasicScheduler<PriorityQueue, std::mutex, ResultRing, MetricCounters>;
+template class BasicScheduler<PriorityQueue, std::mutex, ResultRing, NoMetrics>;
+template class BasicScheduler<PriorityQueue, SpinLock, ResultRing, MetricCounters>;
+template class BasicScheduler<FifoQueue, SpinLock, NoResults, NoMetrics>;
+
+} // namespace YB
@@ -0,0 +1,223 @@
+#include "../include/TaskTable.h"
+#include <new>
+
+namespace YB {
+
+namespace {
+
+bool isFinal(TaskStatus status) {
+    return status != TaskStatus::PENDING && status != TaskStatus::RUNNING;
+}
+
+} // namespace
+
+TaskTable::TaskTable() : segments_(std::make_unique<std::atomic<Segment*>[]>(kMaxSlots / kSegmentSize)) {
+    for (size_t i = 0; i < kMaxSlots / kSegmentSize; ++i) {
+        segments_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+TaskTable::~TaskTable() {
+    for (size_t i = 0; i < kMaxSlots / kSegmentSize; ++i) {
+        delete segments_[i].load(std::memory_order_relaxed);
+    }
+}
+
+void TaskTable::setRetention(size_t maxFinished, std::chrono::milliseconds maxAge) {
+    maxFinished_ = maxFinished;
+    maxAge_ = maxAge;
+    trim(std::chrono::steady_clock::now());
+}
+
+TaskTable::Slot& TaskTable::slotAt(size_t index) const {
+    return segments_[index >> kSegmentBits].load(std::memory_order_acquire)->slots[index & (kSegmentSize - 1)];
+}
+
+TaskID TaskTable::allocate(uint64_t sequence) {
+    // 优先复用空闲槽位（无锁栈，版本号防止ABA），没有时取一个新槽位
+    size_t index = 0;
+    uint64_t head = freeHead_.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t top = static_cast<uint32_t>(head);
+        if (top == 0) {
+            index = nextFresh_.fetch_add(1);
+            if (index >= kMaxSlots) {
+                return 0;
+            }
+
+            // 段不存在时分配，并发分配同一段时落选方释放自己的
+            auto& segment = segments_[index >> kSegmentBits];
+            if (!segment.load(std::memory_order_acquire)) {
+                Segment* created = new (std::nothrow) Segment();
+                if (!created) {
+                    return 0;
+                }
+                Segment* expected = nullptr;
+                if (!segment.compare_exchange_strong(expected, created, std::memory_order_acq_rel)) {
+                    delete created;
+                }
+            }
+            break;
+        }
+
+        uint32_t next = slotAt(top - 1).nextFree.load(std::memory_order_relaxed);
+        uint64_t replacement = (((head >> 32) + 1) << 32) | next;
+        if (freeHead_.compare_exchange_weak(head, replacement, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            index = top - 1;
+            break;
+        }
+    }
+
+    // 序号回绕到0时跳过，保证ID不为0
+    uint64_t generation = sequence & ((uint64_t(1) << (64 - kSlotBits)) - 1);
+    if (generation == 0) {
+        generation = 1;
+    }
+    TaskID id = (generation << kSlotBits) | index;
+
+    Slot& slot = slotAt(index);
+    slot.status.store(TaskStatus::PENDING, std::memory_order_relaxed);
+    slot.id.store(id, std::memory_order_release);
+    return id;
+}
+
+std::optional<TaskStatus> TaskTable::status(TaskID id) const {
+    if (id == 0) {
+        return std::nullopt;
+    }
+    Segment* segment = segments_[(id & kSlotMask) >> kSegmentBits].load(std::memory_order_acquire);
+    if (!segment) {
+        return std::nullopt;
+    }
+
+    // 读状态前后都确认槽位仍属于该ID，槽位在两次读之间被复用时不会读到新任务的状态
+    const Slot& slot = segment->slots[id & (kSegmentSize - 1)];
+    if (slot.id.load(std::memory_order_acquire) != id) {
+        return std::nullopt;
+    }
+    TaskStatus status = slot.status.load(std::memory_order_acquire);
+    if (slot.id.load(std::memory_order_acquire) != id) {
+        return std::nullopt;
+    }
+    return status;
+}
+
+bool TaskTable::reclaimed(TaskID id, uint64_t nextSequence) const {
+    uint64_t generation = id >> kSlotBits;
+    if (generation == 0 || generation >= nextSequence ||
+        (id & kSlotMask) >= nextFresh_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    return !status(id);
+}
+
+TaskTable::Slot* TaskTable::find(TaskID id) const {
+    if (id == 0) {
+        return nullptr;
+    }
+    Segment* segment = segments_[(id & kSlotMask) >> kSegmentBits].load(std::memory_order_acquire);
+    if (!segment) {
+        return nullptr;
+    }
+    Slot& slot = segment->slots[id & (kSegmentSize - 1)];
+    return slot.id.load(std::memory_order_acquire) == id ? &slot : nullptr;
+}
+
+void TaskTable::attach(TaskID id, std::shared_ptr<Task> task, TaskStatus status) {
+    Slot* slot = find(id);
+    if (!slot) {
+        return;
+    }
+    slot->task = std::move(task);
+    slot->status.store(status, std::memory_order_release);
+}
+
+bool TaskTable::setStatus(TaskID id, TaskStatus status) {
+    Slot* slot = find(id);
+    if (!slot) {
+        return false;
+    }
+    slot->status.store(status, std::memory_order_release);
+    if (!slot->task && isFinal(status)) {
+        retire(*slot, id);
+    }
+    return true;
+}
+
+std::shared_ptr<Task> TaskTable::task(TaskID id) const {
+    Slot* slot = find(id);
+    return slot ? slot->task : nullptr;
+}
+
+void TaskTable::release(TaskID id) {
+    Slot* slot = find(id);
+    if (!slot) {
+        return;
+    }
+    slot->task.reset();
+    if (isFinal(slot->status.load(std::memory_order_relaxed))) {
+        retire(*slot, id);
+    }
+}
+
+void TaskTable::reclaimExpired() {
+    trim(std::chrono::steady_clock::now());
+}
+
+void TaskTable::retire(Slot& slot, TaskID id) {
+    if (slot.retired) {
+        return;
+    }
+    slot.retired = true;
+
+    auto now = std::chrono::steady_clock::now();
+    finished_.push_back({id, now});
+    trim(now);
+}
+
+void TaskTable::trim(std::chrono::steady_clock::time_point now) {
+    while (!finished_.empty() &&
+           (finished_.size() > maxFinished_ || now - finished_.front().time > maxAge_)) {
+        TaskID id = finished_.front().id;
+        finished_.pop_front();
+        if (Slot* slot = find(id)) {
+            free(*slot, id & kSlotMask);
+        }
+    }
+}
+
+void TaskTable::free(Slot& slot, size_t index) {
+    slot.id.store(0, std::memory_order_release);
+    slot.task.reset();
+    slot.retired = false;
+
+    uint64_t head = freeHead_.load(std::memory_order_relaxed);
+    do {
+        slot.nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    } while (!freeHead_.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | (index + 1),
+                                              std::memory_order_release, std::memory_order_relaxed));
+}
+
+void TaskTable::clear() {
+    size_t count = std::min(nextFresh_.load(std::memory_order_acquire), kMaxSlots);
+    for (size_t index = 0; index < count; ++index) {
+        if (!segments_[index >> kSegmentBits].load(std::memory_order_acquire)) {
+            continue;
+        }
+        Slot& slot = slotAt(index);
+        if (slot.id.load(std::memory_order_relaxed) != 0) {
+            free(slot, index);
+        }
+    }
+    finished_.clear();
+}
+
+size_t TaskTable::capacity() const {
+    return std::min(nextFresh_.load(std::memory_order_relaxed), kMaxSlots);
+}
+
+size_t TaskTable::retained() const {
+    return finished_.size();
+}
+
+} // namespace YB
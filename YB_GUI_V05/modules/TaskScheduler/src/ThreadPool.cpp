@@ -4,8 +4,31 @@
 
 namespace YB {
 
+namespace {
+// 当前线程所属的线程池及其角色
+thread_local ThreadPool* tlsCurrentPool = nullptr;
+thread_local bool tlsCompensationThread = false;
+thread_local size_t tlsBlockingDepth = 0;
+
+// 本补偿线程已认领退役（补偿数已减一），回到线程池循环后直接驻留
+thread_local bool tlsRetireClaimed = false;
+
+// 退役的补偿线程在此时间内可被再次唤醒，避免频繁创建线程
+constexpr auto kCompensationKeepAlive = std::chrono::milliseconds(100);
+
+// 进程内存活的线程池线程数
+std::atomic<size_t> processThreadCount{0};
+
+struct ProcessThreadCounter {
+    ProcessThreadCounter() { processThreadCount++; }
+    ~ProcessThreadCounter() { processThreadCount--; }
+};
+}
+
 ThreadPool::ThreadPool(size_t numThreads) 
-    : stop_(false), activeThreads_(0), threadsToRemove_(0), poolSize_(numThreads) {
+    : stop_(false), activeThreads_(0), threadsToRemove_(0), poolSize_(numThreads),
+      maxCompensationThreads_(numThreads), parkedCompensationThreads_(0), compensationWakeups_(0),
+      blockedThreads_(0), compensationThreads_(0), totalCompensations_(0) {
     
     if (numThreads == 0) {
         throw std::invalid_argument("ThreadPool size must be greater than 0");
@@ -23,9 +46,24 @@ ThreadPool::~ThreadPool() {
             worker.join();
         }
     }
+    
+    // 停止后不会再创建补偿线程，可以安全地取出并等待
+    std::vector<std::thread> compensationWorkers;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        compensationWorkers.swap(compensationWorkers_);
+    }
+    for (auto& worker : compensationWorkers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
 }
 
-void ThreadPool::workerThread() {
+void ThreadPool::workerThread(bool compensation) {
+    tlsCurrentPool = this;
+    tlsCompensationThread = compensation;
+    
     while (true) {
         std::function<void()> task;
         
@@ -33,12 +71,40 @@ void ThreadPool::workerThread() {
             std::unique_lock<std::mutex> lock(queueMutex_);
             
             // 等待任务或停止信号
-            condition_.wait(lock, [this] {
-                return stop_ || !tasks_.empty() || threadsToRemove_ > 0;
+            condition_.wait(lock, [this, compensation] {
+                return stop_ || !tasks_.empty() || threadsToRemove_ > 0 ||
+                       (compensation && (tlsRetireClaimed || compensationThreads_ > blockedThreads_));
             });
             
+            // 阻塞已结束的补偿线程先驻留一段时间，期间可被新的阻塞区域唤醒；
+            // 每个退役的线程只把补偿数减一次，已在补偿任务中认领的不再重复
+            if (compensation && !stop_ && (tlsRetireClaimed || compensationThreads_ > blockedThreads_)) {
+                if (!tlsRetireClaimed) {
+                    compensationThreads_--;
+                }
+                tlsRetireClaimed = false;
+                parkedCompensationThreads_++;
+                
+                bool woken = condition_.wait_for(lock, kCompensationKeepAlive, [this] {
+                    return stop_ || compensationWakeups_ > 0;
+                });
+                
+                if (woken && compensationWakeups_ > 0) {
+                    // 唤醒方已代为更新驻留数和补偿数
+                    compensationWakeups_--;
+                    auto compensationTask = compensationTask_;
+                    lock.unlock();
+                    runCompensationTask(compensationTask);
+                    continue;
+                }
+                
+                parkedCompensationThreads_--;
+                retiredCompensationIds_.push_back(std::this_thread::get_id());
+                return;
+            }
+            
             // 检查是否需要减少线程
-            if (threadsToRemove_ > 0 && tasks_.empty()) {
+            if (!compensation && threadsToRemove_ > 0 && tasks_.empty()) {
                 threadsToRemove_--;
                 poolSize_--;
                 resizeCondition_.notify_all();
@@ -47,6 +113,10 @@ void ThreadPool::workerThread() {
             
             // 检查是否停止
             if (stop_ && tasks_.empty()) {
+                if (compensation && !tlsRetireClaimed) {
+                    compensationThreads_--;
+                }
+                tlsRetireClaimed = false;
                 return;
             }
             
@@ -75,7 +145,10 @@ void ThreadPool::workerThread() {
 
 void ThreadPool::addThreads(size_t count) {
     for (size_t i = 0; i < count; ++i) {
-        workers_.emplace_back([this] { workerThread(); });
+        workers_.emplace_back([this] {
+            ProcessThreadCounter counter;
+            workerThread();
+        });
     }
 }
 
@@ -87,8 +160,9 @@ void ThreadPool::removeThreads(size_t count) {
     
     // 唤醒线程以便它们可以检查是否需要退出
     condition_.notify_all();
-    
-    // 等待线程退出
+}
+
+void ThreadPool::waitForRemovals() {
     std::unique_lock<std::mutex> lock(queueMutex_);
     resizeCondition_.wait(lock, [this] {
         return threadsToRemove_ == 0;
@@ -102,20 +176,36 @@ void ThreadPool::removeThreads(size_t count) {
     );
 }
 
-void ThreadPool::resize(size_t newSize) {
+void ThreadPool::resize(size_t newSize, bool wait) {
     if (newSize == 0) {
         throw std::invalid_argument("ThreadPool size must be greater than 0");
     }
     
-    size_t currentSize = poolSize_.load();
+    // 尚未退出的待移除线程不算在内；workers_的修改与waitForRemovals的清理互斥
+    size_t removed = 0;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        size_t currentSize = poolSize_ - threadsToRemove_;
+        if (newSize > currentSize) {
+            // 增加时先撤销尚未执行的移除，留下的空闲线程继续服务
+            size_t kept = std::min<size_t>(threadsToRemove_, newSize - currentSize);
+            if (kept > 0) {
+                threadsToRemove_ -= kept;
+                resizeCondition_.notify_all();
+            }
+            addThreads(newSize - currentSize - kept);
+            poolSize_ += newSize - currentSize - kept;
+        } else {
+            removed = currentSize - newSize;
+        }
+    }
     
-    if (newSize > currentSize) {
-        // 增加线程
-        addThreads(newSize - currentSize);
-        poolSize_ = newSize;
-    } else if (newSize < currentSize) {
-        // 减少线程
-        removeThreads(currentSize - newSize);
+    // 减少线程
+    if (removed > 0) {
+        removeThreads(removed);
+    }
+    if (wait) {
+        waitForRemovals();
     }
 }
 
@@ -144,4 +234,173 @@ bool ThreadPool::isStopped() const {
     return stop_.load();
 }
 
+void ThreadPool::setMaxCompensationThreads(size_t maxThreads) {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    maxCompensationThreads_ = maxThreads;
+}
+
+void ThreadPool::setCompensationTask(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    compensationTask_ = std::move(task);
+}
+
+void ThreadPool::setRetireNotifier(std::function<void()> notifier) {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    retireNotifier_ = std::move(notifier);
+}
+
+size_t ThreadPool::getBlockedThreads() const {
+    return blockedThreads_.load();
+}
+
+size_t ThreadPool::getCompensationThreads() const {
+    return compensationThreads_.load();
+}
+
+size_t ThreadPool::getTotalCompensations() const {
+    return totalCompensations_.load();
+}
+
+size_t ThreadPool::getProcessThreadCount() {
+    return processThreadCount.load();
+}
+
+ThreadPool* ThreadPool::current() {
+    return tlsCurrentPool;
+}
+
+bool ThreadPool::currentThreadShouldRetire() {
+    ThreadPool* pool = tlsCurrentPool;
+    if (!pool || !tlsCompensationThread) {
+        return false;
+    }
+    if (tlsRetireClaimed || pool->stop_) {
+        return true;
+    }
+    if (pool->compensationThreads_ <= pool->blockedThreads_) {
+        return false;
+    }
+    return pool->claimRetirement();
+}
+
+bool ThreadPool::claimRetirement() {
+    // 多个补偿线程同时看到同一份多余时只有一个退役，其余继续运行补偿任务
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    if (compensationThreads_ <= blockedThreads_) {
+        return false;
+    }
+    compensationThreads_--;
+    tlsRetireClaimed = true;
+    return true;
+}
+
+void ThreadPool::compensationThread() {
+    tlsCurrentPool = this;
+    tlsCompensationThread = true;
+    
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        task = compensationTask_;
+    }
+    
+    runCompensationTask(task);
+    workerThread(true);
+}
+
+void ThreadPool::runCompensationTask(const std::function<void()>& task) {
+    // 长期循环（例如调度器的工作循环）在阻塞结束后应自行返回
+    if (!task) {
+        return;
+    }
+    
+    try {
+        task();
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in compensation task: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unknown exception in compensation task" << std::endl;
+    }
+}
+
+void ThreadPool::beginBlocking() {
+    std::vector<std::thread> retired;
+    
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        blockedThreads_++;
+        
+        if (stop_ || compensationThreads_ >= blockedThreads_ ||
+            compensationThreads_ >= maxCompensationThreads_) {
+            return;
+        }
+        
+        compensationThreads_++;
+        totalCompensations_++;
+        
+        // 优先唤醒驻留中的补偿线程
+        if (parkedCompensationThreads_ > 0) {
+            parkedCompensationThreads_--;
+            compensationWakeups_++;
+            condition_.notify_all();
+            return;
+        }
+        
+        // 回收已退役的补偿线程对象
+        for (auto it = compensationWorkers_.begin(); it != compensationWorkers_.end();) {
+            auto idIt = std::find(retiredCompensationIds_.begin(), retiredCompensationIds_.end(), it->get_id());
+            if (idIt != retiredCompensationIds_.end()) {
+                retiredCompensationIds_.erase(idIt);
+                retired.push_back(std::move(*it));
+                it = compensationWorkers_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        
+        compensationWorkers_.emplace_back([this] {
+            ProcessThreadCounter counter;
+            compensationThread();
+        });
+    }
+    
+    for (auto& thread : retired) {
+        thread.join();
+    }
+}
+
+void ThreadPool::endBlocking() {
+    std::function<void()> notifier;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        blockedThreads_--;
+        if (compensationThreads_ > blockedThreads_) {
+            notifier = retireNotifier_;
+        }
+    }
+    
+    // 唤醒多余的补偿线程使其退役
+    condition_.notify_all();
+    if (notifier) {
+        notifier();
+    }
+}
+
+// BlockingScope 实现
+BlockingScope::BlockingScope() : pool_(nullptr) {
+    if (tlsBlockingDepth++ == 0) {
+        pool_ = ThreadPool::current();
+        if (pool_) {
+            pool_->beginBlocking();
+        }
+    }
+}
+
+BlockingScope::~BlockingScope() {
+    tlsBlockingDepth--;
+    if (pool_) {
+        pool_->endBlocking();
+    }
+}
+
 } // namespace YB
\ No newline at end of file
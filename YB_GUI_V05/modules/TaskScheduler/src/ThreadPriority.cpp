@@ -0,0 +1,181 @@
+#include "../include/ThreadPriority.h"
+#include <thread>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace YB {
+
+namespace {
+
+// 当前线程已设置的调度参数（避免重复系统调用）
+thread_local OsThreadPriority tlsCurrentPriority;
+thread_local bool tlsPriorityKnown = false;
+thread_local bool tlsPriorityTouched = false;
+
+// 进程启动时的nice值，所有映射均相对于它
+int baseNiceValue = 0;
+
+bool operator==(const OsThreadPriority& a, const OsThreadPriority& b) {
+    return a.schedClass == b.schedClass && a.niceValue == b.niceValue &&
+           a.realtimePriority == b.realtimePriority;
+}
+
+OsThreadPriority defaultPriority() {
+    OsThreadPriority priority;
+    priority.niceValue = baseNiceValue;
+    return priority;
+}
+
+OsThreadPriority nicePriority(int offset) {
+    OsThreadPriority priority;
+    priority.niceValue = std::clamp(baseNiceValue + offset, -20, 19);
+    return priority;
+}
+
+#ifdef __linux__
+bool setOsPriority(const OsThreadPriority& priority) {
+    sched_param param{};
+    int policy = SCHED_OTHER;
+
+    switch (priority.schedClass) {
+        case OsSchedulingClass::REALTIME_FIFO:
+            policy = SCHED_FIFO;
+            param.sched_priority = priority.realtimePriority;
+            break;
+        case OsSchedulingClass::IDLE:
+            policy = SCHED_IDLE;
+            break;
+        case OsSchedulingClass::NORMAL:
+            break;
+    }
+
+    if (pthread_setschedparam(pthread_self(), policy, &param) != 0) {
+        return false;
+    }
+
+    // nice值只对SCHED_OTHER有意义，Linux上setpriority按线程ID生效
+    if (policy == SCHED_OTHER) {
+        pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), priority.niceValue) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+OsPriorityCapabilities probeCapabilities() {
+    OsPriorityCapabilities caps;
+    caps.supported = true;
+    baseNiceValue = getpriority(PRIO_PROCESS, 0);
+
+    // 在临时线程中探测，失败不会影响调用线程
+    std::thread([&caps] {
+        caps.canRaise = setOsPriority(nicePriority(-5)) && setOsPriority(defaultPriority());
+
+        OsThreadPriority fifo;
+        fifo.schedClass = OsSchedulingClass::REALTIME_FIFO;
+        fifo.realtimePriority = 1;
+        caps.canUseFifo = setOsPriority(fifo) && setOsPriority(defaultPriority());
+    }).join();
+
+    // 无CAP_SYS_NICE且RLIMIT_NICE过小时，降级后无法恢复
+    std::thread([&caps] {
+        OsThreadPriority idle;
+        idle.schedClass = OsSchedulingClass::IDLE;
+        caps.canRestore = setOsPriority(idle) && setOsPriority(nicePriority(5)) &&
+                          setOsPriority(defaultPriority());
+    }).join();
+
+    return caps;
+}
+#else
+bool setOsPriority(const OsThreadPriority&) {
+    return false;
+}
+
+OsPriorityCapabilities probeCapabilities() {
+    return OsPriorityCapabilities();
+}
+#endif
+
+} // namespace
+
+const OsPriorityCapabilities& getOsPriorityCapabilities() {
+    static const OsPriorityCapabilities caps = probeCapabilities();
+    return caps;
+}
+
+OsThreadPriority mapPriorityToOs(Priority priority, bool allowRealtime) {
+    const auto& caps = getOsPriorityCapabilities();
+
+    switch (priority) {
+        case Priority::CRITICAL:
+            if (allowRealtime && caps.canUseFifo) {
+                OsThreadPriority fifo;
+                fifo.schedClass = OsSchedulingClass::REALTIME_FIFO;
+                fifo.realtimePriority = 10;
+                return fifo;
+            }
+            return caps.canRaise ? nicePriority(-10) : defaultPriority();
+        case Priority::HIGH:
+            return caps.canRaise ? nicePriority(-5) : defaultPriority();
+        case Priority::LOW:
+            return caps.canRestore ? nicePriority(5) : defaultPriority();
+        case Priority::BACKGROUND:
+            if (caps.canRestore) {
+                OsThreadPriority idle;
+                idle.schedClass = OsSchedulingClass::IDLE;
+                idle.niceValue = baseNiceValue;
+                return idle;
+            }
+            return defaultPriority();
+        case Priority::NORMAL:
+        default:
+            return defaultPriority();
+    }
+}
+
+bool applyThreadPriority(Priority priority, bool allowRealtime) {
+    if (!getOsPriorityCapabilities().supported) {
+        return false;
+    }
+
+    OsThreadPriority target = mapPriorityToOs(priority, allowRealtime);
+    if (tlsPriorityKnown && tlsCurrentPriority == target) {
+        return true;
+    }
+
+    tlsPriorityTouched = true;
+    if (!setOsPriority(target)) {
+        // 可能只设置了一半（策略成功、nice失败），下次重新设置
+        tlsPriorityKnown = false;
+        return false;
+    }
+
+    tlsCurrentPriority = target;
+    tlsPriorityKnown = true;
+    return true;
+}
+
+void resetThreadPriority() {
+    if (!tlsPriorityTouched || (tlsPriorityKnown && tlsCurrentPriority == defaultPriority())) {
+        return;
+    }
+
+    if (setOsPriority(defaultPriority())) {
+        tlsCurrentPriority = defaultPriority();
+        tlsPriorityKnown = true;
+    } else {
+        tlsPriorityKnown = false;
+    }
+}
+
+} // namespace YB
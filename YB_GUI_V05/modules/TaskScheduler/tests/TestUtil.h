@@ -0,0 +1,20 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include "../include/TaskScheduler.h"
+
+// 各测试共用的辅助函数
+
+// threads个工作线程的配置，关闭负载均衡，测试期间线程数不随负载变化
+inline YB::SchedulerConfig testConfig(size_t threads) {
+    YB::SchedulerConfig config;
+    config.minThreads = threads;
+    config.enableLoadBalancing = false;
+    return config;
+}
+
+inline YB::TaskResult success() {
+    return YB::TaskResult(0, YB::ResultStatus::SUCCESS);
+}
+
+#endif // TEST_UTIL_H
@@ -0,0 +1,365 @@
+#include "../include/TaskScheduler.h"
+#include "../include/TaskGroup.h"
+#include "../include/PriorityQueue.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <set>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+SchedulerConfig affinityConfig(size_t threads, size_t stealThreshold) {
+    SchedulerConfig config = testConfig(threads);
+    config.affinityStealThreshold = stealThreshold;
+    return config;
+}
+
+std::shared_ptr<Task> affinityTask(uint64_t key, std::function<TaskResult()> function) {
+    auto task = std::make_shared<Task>(0, TaskType::DATA_ANALYSIS, Priority::NORMAL, std::move(function));
+    task->affinityKey = key;
+    return task;
+}
+
+// 测试1：同一键的任务总在同一工作线程上执行
+bool testSameKeySameWorker() {
+    std::cout << "\n=== Test 1: Same key lands on the same worker ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(affinityConfig(4, 1000000)));
+
+    std::mutex mutex;
+    std::map<uint64_t, std::set<std::thread::id>> threadsByKey;
+    std::set<std::thread::id> allThreads;
+    {
+        TaskGroup group(scheduler);
+        for (int i = 0; i < 4000; ++i) {
+            uint64_t key = 1 + i % 16;
+            group.run(affinityTask(key, [&, key] {
+                std::lock_guard<std::mutex> lock(mutex);
+                threadsByKey[key].insert(std::this_thread::get_id());
+                allThreads.insert(std::this_thread::get_id());
+                return TaskResult(0, ResultStatus::SUCCESS);
+            }));
+        }
+        group.wait();
+        assert(group.getStats().completed == 4000);
+    }
+
+    for (const auto& [key, threads] : threadsByKey) {
+        assert(threads.size() == 1);
+    }
+
+    auto metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.totalAffinityTasks == 4000);
+    assert(metrics.affinityHitRate == 1.0);
+    assert(metrics.totalAffinitySteals == 0);
+    std::cout << "16 keys spread over " << allThreads.size() << " workers, hit rate "
+              << metrics.affinityHitRate * 100 << "%" << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Same key test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：积压超过阈值时空闲线程窃取，低于阈值时保持亲和
+bool testStealAboveThreshold() {
+    std::cout << "\n=== Test 2: Stealing only above the imbalance threshold ===" << std::endl;
+
+    auto run = [](size_t threshold, std::set<std::thread::id>& threads) {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(affinityConfig(4, threshold)));
+
+        std::mutex mutex;
+        auto start = std::chrono::steady_clock::now();
+        {
+            // 所有任务使用同一个键
+            TaskGroup group(scheduler);
+            for (int i = 0; i < 40; ++i) {
+                group.run(affinityTask(7, [&] {
+                    std::this_thread::sleep_for(2ms);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                    return TaskResult(0, ResultStatus::SUCCESS);
+                }));
+            }
+            group.wait();
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        auto metrics = scheduler.getPerformanceMetrics();
+        std::cout << "Threshold " << threshold << ": " << elapsed << " ms on " << threads.size()
+                  << " workers, steals " << metrics.totalAffinitySteals << ", hit rate "
+                  << metrics.affinityHitRate * 100 << "%" << std::endl;
+        scheduler.shutdown();
+        return metrics;
+    };
+
+    std::set<std::thread::id> strictThreads;
+    auto strict = run(1000000, strictThreads);
+    assert(strictThreads.size() == 1);
+    assert(strict.totalAffinitySteals == 0);
+
+    std::set<std::thread::id> stealingThreads;
+    auto stealing = run(2, stealingThreads);
+    assert(stealing.totalAffinitySteals > 0);
+    assert(stealingThreads.size() > 1);
+    assert(stealing.affinityHitRate < 1.0);
+
+    std::cout << "Steal threshold test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：亲和队列中的任务可取消，关闭时通知取消
+bool testCancelAndShutdown() {
+    std::cout << "\n=== Test 3: Cancel and shutdown with affinity queues ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(affinityConfig(1, 1000000)));
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> gate{false};
+    scheduler.submitTask(TaskType::USER_DEFINED, Priority::CRITICAL, [&] {
+        started = true;
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    std::atomic<int> ran{0};
+    auto work = [&ran] {
+        ran++;
+        return TaskResult(0, ResultStatus::SUCCESS);
+    };
+    TaskID single = scheduler.submitAffinityTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, 3, work);
+    std::vector<TaskID> batch;
+    for (int i = 0; i < 10; ++i) {
+        batch.push_back(scheduler.submitAffinityTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, 3, work));
+    }
+    assert(scheduler.getQueueStatus().pendingTasks == 11);
+    assert(scheduler.getPerformanceMetrics().currentQueueSize == 11);
+
+    assert(scheduler.cancelTask(single));
+    assert(scheduler.getTaskStatus(single) == TaskStatus::CANCELLED);
+    assert(scheduler.cancelTasks({batch[0], batch[1], batch[2]}) == 3);
+
+    std::atomic<int> abandoned{0};
+    {
+        TaskGroup group(scheduler);
+        for (int i = 0; i < 5; ++i) {
+            group.run(affinityTask(3, work));
+        }
+
+        std::thread releaser([&gate] {
+            std::this_thread::sleep_for(50ms);
+            gate = true;
+        });
+        scheduler.pauseScheduling();
+        scheduler.shutdown();
+        releaser.join();
+
+        assert(group.waitFor(1000ms));
+        abandoned = static_cast<int>(group.getStats().cancelled);
+    }
+    assert(ran == 0);
+    assert(abandoned == 5);
+
+    std::cout << "Cancel test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试4：亲和队列退役后转入全局队列的任务（退役前已排队和退役后提交的）仍可取消
+bool testCancelAfterSlotRetired() {
+    std::cout << "\n=== Test 4: Cancel tasks moved off a retired affinity queue ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(affinityConfig(2, 1000000)));
+
+    // 两个工作线程各被一个任务占住
+    std::atomic<int> started{0};
+    std::atomic<bool> gates[2] = {false, false};
+    for (auto& gate : gates) {
+        scheduler.submitTask(TaskType::USER_DEFINED, Priority::CRITICAL, [&started, &gate] {
+            started++;
+            while (!gate) {
+                std::this_thread::sleep_for(1ms);
+            }
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+    while (started < 2) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    std::atomic<int> ran{0};
+    auto work = [&ran] {
+        ran++;
+        return TaskResult(0, ResultStatus::SUCCESS);
+    };
+    std::vector<TaskID> ids;
+    for (uint64_t key = 1; key <= 32; ++key) {
+        ids.push_back(scheduler.submitAffinityTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, key, work));
+    }
+
+    // 缩为一个工作线程：先放行的线程退役，其亲和队列中的任务转入全局队列
+    std::thread shrinker([&scheduler] { scheduler.adjustThreadPoolSize(1); });
+    std::this_thread::sleep_for(50ms);
+    gates[0] = true;
+    shrinker.join();
+
+    // 退役队列对应的键之后直接进入全局队列
+    for (uint64_t key = 1; key <= 32; ++key) {
+        ids.push_back(scheduler.submitAffinityTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, key, work));
+    }
+    assert(scheduler.getPerformanceMetrics().currentQueueSize == ids.size());
+
+    for (TaskID id : ids) {
+        assert(scheduler.cancelTask(id));
+        assert(scheduler.getTaskStatus(id) == TaskStatus::CANCELLED);
+    }
+    assert(scheduler.getPerformanceMetrics().currentQueueSize == 0);
+
+    gates[1] = true;
+    scheduler.shutdown();
+    assert(ran == 0);
+
+    std::cout << ids.size() << " affinity tasks cancelled after a queue retired" << std::endl;
+    std::cout << "Retired queue cancel test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试5：唤醒空闲的首选线程时只唤醒它，其他在全局队列上等待的线程不被惊动
+bool testTargetedWake() {
+    std::cout << "\n=== Test 5: Waking one idle worker leaves the others asleep ===" << std::endl;
+
+    const int WAITERS = 4;
+    PriorityQueue queue;
+    std::vector<PriorityQueue::Waiter> waiters(WAITERS);
+    std::atomic<int> returned[WAITERS] = {};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < WAITERS; ++i) {
+        threads.emplace_back([&, i] {
+            uint64_t epoch = queue.wakeEpoch();
+            while (!queue.isStopped()) {
+                queue.pop(epoch, waiters[i]);
+                returned[i]++;
+                epoch = queue.wakeEpoch();
+            }
+        });
+    }
+    std::this_thread::sleep_for(50ms);
+
+    queue.wake(waiters[2]);
+    std::this_thread::sleep_for(50ms);
+    for (int i = 0; i < WAITERS; ++i) {
+        assert(returned[i] == (i == 2 ? 1 : 0));
+    }
+
+    // 唤醒早于进入等待时不丢失
+    PriorityQueue::Waiter early;
+    queue.wake(early);
+    assert(queue.pop(queue.wakeEpoch(), early) == nullptr);
+
+    queue.stop();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::cout << "Targeted wake test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试6：每个键有共享状态的工作负载，有无亲和键的对比
+bool benchmarkSharedKeyState(int numTasks, size_t numKeys, size_t stateKb) {
+    std::cout << "\n=== Test 6: Shared per-key state (" << numTasks << " tasks, " << numKeys << " keys x "
+              << stateKb << " KB) ===" << std::endl;
+
+    struct KeyState {
+        std::mutex mutex;
+        std::vector<uint64_t> data;
+    };
+    std::vector<KeyState> states(numKeys);
+    for (auto& state : states) {
+        state.data.assign(stateKb * 1024 / sizeof(uint64_t), 1);
+    }
+
+    auto run = [&](bool useAffinity) {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(affinityConfig(4, 4)));
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            TaskGroup group(scheduler);
+            for (int i = 0; i < numTasks; ++i) {
+                size_t key = static_cast<size_t>(i) % numKeys;
+                group.run(affinityTask(useAffinity ? key + 1 : 0, [&states, key] {
+                    // 读改写该键的整块状态（如同一图像、分区或模型的数据）
+                    auto& state = states[key];
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    uint64_t sum = 0;
+                    for (auto& value : state.data) {
+                        value = value * 3 + 1;
+                        sum += value;
+                    }
+                    TaskResult result(0, ResultStatus::SUCCESS);
+                    result.result = sum;
+                    return result;
+                }));
+            }
+            group.wait();
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        auto metrics = scheduler.getPerformanceMetrics();
+        std::cout << (useAffinity ? "Affinity key:    " : "No affinity:     ") << elapsed << " ms, "
+                  << numTasks * 1000.0 / elapsed << " tasks/s";
+        if (useAffinity) {
+            std::cout << ", hit rate " << metrics.affinityHitRate * 100 << "%, steals "
+                      << metrics.totalAffinitySteals;
+            assert(metrics.totalAffinityTasks == static_cast<size_t>(numTasks));
+        }
+        std::cout << std::endl;
+        scheduler.shutdown();
+    };
+
+    run(false);
+    run(true);
+
+    std::cout << "Shared key state benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_affinity [任务数] [键数] [每键状态KB]
+int main(int argc, char** argv) {
+    std::cout << "=== Affinity Routing Tests ===" << std::endl;
+
+    int numTasks = argc > 1 ? std::atoi(argv[1]) : 20000;
+    size_t numKeys = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+    size_t stateKb = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 128;
+
+    int passed = 0;
+    int total = 6;
+
+    if (testSameKeySameWorker()) passed++;
+    if (testStealAboveThreshold()) passed++;
+    if (testCancelAndShutdown()) passed++;
+    if (testCancelAfterSlotRetired()) passed++;
+    if (testTargetedWake()) passed++;
+    if (benchmarkSharedKeyState(numTasks, numKeys, stateKb)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+#include "../include/TaskScheduler.h"
+#include "../include/PriorityQueue.h"
+#include "../include/ResultRing.h"
+#include "../include/MetricCounters.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// TaskScheduler.cpp中显式实例化的组合
+using UncountedScheduler = BasicScheduler<PriorityQueue, std::mutex, ResultRing, NoMetrics>;
+using SpinScheduler = BasicScheduler<PriorityQueue, SpinLock, ResultRing, MetricCounters>;
+using FireAndForgetScheduler = BasicScheduler<FifoQueue, SpinLock, NoResults, NoMetrics>;
+
+static_assert(std::is_same_v<TaskScheduler, BasicScheduler<PriorityQueue, std::mutex, ResultRing, MetricCounters>>,
+              "TaskScheduler is the full-featured instantiation");
+
+// 占住唯一的工作线程，返回后由调用方置位gate放行
+template<typename Scheduler>
+void blockWorker(Scheduler& scheduler, std::atomic<bool>& gate) {
+    std::atomic<bool> started{false};
+    scheduler.submitTask(TaskType::USER_DEFINED, Priority::CRITICAL, [&started, &gate] {
+        started = true;
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return success();
+    });
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+// 不在调用线程上认领，等待工作线程按队列顺序执行完
+template<typename Scheduler>
+void waitUntilFinished(Scheduler& scheduler, TaskID id) {
+    while (scheduler.getTaskStatus(id) == TaskStatus::PENDING || scheduler.getTaskStatus(id) == TaskStatus::RUNNING) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+// 测试1：按优先级出队的组合与TaskScheduler的顺序、结果、异常和取消语义一致
+template<typename Scheduler>
+bool testPrioritySemantics(const char* name) {
+    std::cout << "\n=== Test 1: Priority semantics (" << name << ") ===" << std::endl;
+
+    Scheduler scheduler;
+    assert(scheduler.initialize(testConfig(1)));
+
+    std::atomic<bool> gate{false};
+    blockWorker(scheduler, gate);
+
+    std::mutex mutex;
+    std::vector<Priority> order;
+    std::vector<TaskID> ids;
+    for (Priority priority : {Priority::LOW, Priority::NORMAL, Priority::BACKGROUND, Priority::CRITICAL, Priority::HIGH}) {
+        ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, priority, [&mutex, &order, priority] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(priority);
+            TaskResult result = success();
+            result.result = static_cast<int>(priority);
+            return result;
+        }));
+    }
+    TaskID failing = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, []() -> TaskResult {
+        throw std::runtime_error("boom");
+    });
+    TaskID cancelled = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success);
+    auto handle = scheduler.submit(TaskType::USER_DEFINED, Priority::BACKGROUND, [] { return 42; });
+    assert(scheduler.getTaskStatus(cancelled) == TaskStatus::PENDING);
+    assert(scheduler.cancelTask(cancelled));
+    assert(scheduler.getTaskStatus(cancelled) == TaskStatus::CANCELLED);
+
+    gate = true;
+    waitUntilFinished(scheduler, handle.id());
+    assert((order == std::vector<Priority>{Priority::CRITICAL, Priority::HIGH, Priority::NORMAL, Priority::LOW,
+                                           Priority::BACKGROUND}));
+
+    auto results = scheduler.waitForTasks(ids);
+    for (size_t i = 0; i < results.size(); ++i) {
+        assert(results[i].status == ResultStatus::SUCCESS);
+        assert(results[i].taskId == ids[i]);
+    }
+    assert(std::any_cast<int>(results[0].result) == static_cast<int>(Priority::LOW));
+
+    auto failure = scheduler.waitForTask(failing);
+    assert(failure.status == ResultStatus::FAILURE);
+    assert(scheduler.getTaskStatus(failing) == TaskStatus::FAILED);
+    assert(handle.get() == 42);
+
+    scheduler.shutdown();
+    std::cout << "Priority semantics test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：FIFO队列忽略优先级；不保留结果时等待只返回状态，不统计时计数为0
+bool testFireAndForget() {
+    std::cout << "\n=== Test 2: FIFO, no results, no metrics ===" << std::endl;
+
+    FireAndForgetScheduler scheduler;
+    assert(scheduler.initialize(testConfig(1)));
+
+    std::atomic<bool> gate{false};
+    blockWorker(scheduler, gate);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::vector<TaskID> ids;
+    const Priority priorities[] = {Priority::BACKGROUND, Priority::CRITICAL, Priority::LOW, Priority::HIGH};
+    for (int i = 0; i < 100; ++i) {
+        ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, priorities[i % 4], [&mutex, &order, i] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+            TaskResult result = success();
+            result.result = i;
+            return result;
+        }));
+    }
+    TaskID failing = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, []() -> TaskResult {
+        throw std::runtime_error("ignored");
+    });
+
+    gate = true;
+    waitUntilFinished(scheduler, failing);
+    assert(order.size() == 100);
+    assert(std::is_sorted(order.begin(), order.end()));
+
+    TaskResult result = scheduler.waitForTask(ids[0]);
+    assert(result.status == ResultStatus::SUCCESS);
+    assert(!result.result.has_value());
+    assert(scheduler.waitForTask(failing).status == ResultStatus::FAILURE);
+    assert(scheduler.getCompletedTasks().empty());
+
+    auto handle = scheduler.submit(TaskType::USER_DEFINED, Priority::NORMAL, [] { return std::string("typed"); });
+    assert(handle.get() == "typed");
+
+    auto metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.totalTasksSubmitted == 0 && metrics.totalTasksCompleted == 0);
+    assert(scheduler.getLatencyDistribution(LatencyKind::END_TO_END).count() == 0);
+
+    scheduler.shutdown();
+    std::cout << "FIFO, no results, no metrics test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 提交numTasks个空任务并等待工作线程全部执行完，返回每秒任务数。
+// 不用waitForTasks：等待方会在调用线程上认领排队的任务，测到的不是工作线程的吞吐量
+template<typename Scheduler>
+double measure(size_t threads, int numTasks, std::atomic<int>& counter) {
+    Scheduler scheduler;
+    assert(scheduler.initialize(testConfig(threads)));
+
+    int target = counter + numTasks;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numTasks; ++i) {
+        TaskID id = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&counter] {
+            counter.fetch_add(1, std::memory_order_relaxed);
+            return success();
+        });
+        assert(id != 0);
+    }
+    while (counter < target) {
+        std::this_thread::sleep_for(100us);
+    }
+    double rate = numTasks / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    scheduler.shutdown();
+    return rate;
+}
+
+// 测试3：各策略组合与TaskScheduler的吞吐量对比（只输出，不断言耗时）
+bool benchmarkPolicies(int numTasks, size_t threads) {
+    std::cout << "\n=== Test 3: Policy combinations (" << numTasks << " tasks, " << threads
+              << " workers) ===" << std::endl;
+
+    std::atomic<int> counter{0};
+    double baseline = measure<TaskScheduler>(threads, numTasks, counter);
+    auto report = [baseline](const char* name, double rate) {
+        std::cout << name << static_cast<size_t>(rate) << " tasks/s (" << rate / baseline << "x)" << std::endl;
+    };
+    report("TaskScheduler (priority, mutex, results, metrics): ", baseline);
+    report("Priority, mutex, results, no metrics:             ", measure<UncountedScheduler>(threads, numTasks, counter));
+    report("Priority, spin lock, results, metrics:            ", measure<SpinScheduler>(threads, numTasks, counter));
+    report("FIFO, spin lock, no results, no metrics:          ", measure<FireAndForgetScheduler>(threads, numTasks, counter));
+    assert(counter == numTasks * 4);
+
+    std::cout << "Policy benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_basic_scheduler [任务数] [工作线程数]
+int main(int argc, char** argv) {
+    std::cout << "=== Basic Scheduler Policy Tests ===" << std::endl;
+
+    int numTasks = argc > 1 ? std::atoi(argv[1]) : 100000;
+    size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2;
+
+    int passed = 0;
+    int total = 5;
+
+    if (testPrioritySemantics<TaskScheduler>("TaskScheduler")) passed++;
+    if (testPrioritySemantics<UncountedScheduler>("no metrics")) passed++;
+    if (testPrioritySemantics<SpinScheduler>("spin lock")) passed++;
+    if (testFireAndForget()) passed++;
+    if (benchmarkPolicies(numTasks, threads)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
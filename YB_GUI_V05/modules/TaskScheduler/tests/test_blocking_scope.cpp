@@ -0,0 +1,273 @@
+#include "../include/TaskScheduler.h"
+#include "../include/ThreadPool.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <future>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 等待条件成立（最多等待timeout）
+template<typename Pred>
+bool waitUntil(Pred pred, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+// 测试1：线程池内等待子任务future不再死锁
+bool testNestedFutureWait() {
+    std::cout << "\n=== Test 1: Nested future wait with compensation ===" << std::endl;
+
+    ThreadPool pool(2);
+    pool.setMaxCompensationThreads(4);
+
+    // 两个外层任务占满线程池，各自等待一个排在其后的内层任务
+    std::vector<std::future<int>> outer;
+    for (int i = 0; i < 2; ++i) {
+        outer.emplace_back(pool.enqueue([&pool, i] {
+            auto inner = pool.enqueue([i] { return i + 1; });
+            BlockingScope blocking;
+            return inner.get() * 10;
+        }));
+    }
+
+    int sum = 0;
+    for (auto& f : outer) {
+        if (f.wait_for(5s) != std::future_status::ready) {
+            std::cerr << "Nested wait deadlocked" << std::endl;
+            return false;
+        }
+        sum += f.get();
+    }
+
+    assert(sum == 30);
+    assert(pool.getTotalCompensations() >= 1);
+
+    // 阻塞结束后补偿线程应退役
+    bool retired = waitUntil([&pool] { return pool.getCompensationThreads() == 0; }, 2000ms);
+    assert(retired);
+    assert(pool.getBlockedThreads() == 0);
+
+    std::cout << "Compensations: " << pool.getTotalCompensations() << std::endl;
+    std::cout << "Nested future wait test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：补偿线程数不超过硬上限
+bool testCompensationCap() {
+    std::cout << "\n=== Test 2: Compensation hard cap ===" << std::endl;
+
+    ThreadPool pool(2);
+    pool.setMaxCompensationThreads(1);
+
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    std::vector<std::future<void>> blocked;
+    for (int i = 0; i < 2; ++i) {
+        blocked.emplace_back(pool.enqueue([gate] {
+            BlockingScope blocking;
+            gate.wait();
+        }));
+    }
+
+    waitUntil([&pool] { return pool.getBlockedThreads() == 2; }, 2000ms);
+    assert(pool.getCompensationThreads() <= 1);
+
+    // 补偿线程仍能处理新任务
+    auto probe = pool.enqueue([] { return 42; });
+    assert(probe.wait_for(2s) == std::future_status::ready);
+    assert(probe.get() == 42);
+
+    release.set_value();
+    for (auto& f : blocked) {
+        f.get();
+    }
+
+    std::cout << "Compensation cap test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：调度器工作线程阻塞时由补偿线程继续调度
+bool testSchedulerCompensation() {
+    std::cout << "\n=== Test 3: TaskScheduler worker compensation ===" << std::endl;
+
+    SchedulerConfig config;
+    config.minThreads = 2;
+    config.maxCompensationThreads = 4;
+    config.enableLoadBalancing = false;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    std::atomic<int> finished{0};
+
+    // 两个任务阻塞等待第三个任务放行
+    for (int i = 0; i < 2; ++i) {
+        scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [gate, &finished] {
+            BlockingScope blocking;
+            gate.wait_for(5s);
+            finished++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+
+    std::this_thread::sleep_for(50ms);
+    scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&release] {
+        release.set_value();
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+
+    bool done = waitUntil([&finished] { return finished == 2; }, 3000ms);
+    scheduler.shutdown();
+
+    assert(done);
+    std::cout << "Scheduler compensation test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试5：一个阻塞区域结束时，同时看到多余的补偿线程中只有一个退役，其余继续运行补偿任务
+bool testPartialRetirement() {
+    std::cout << "\n=== Test 5: One compensation thread retires per finished scope ===" << std::endl;
+
+    ThreadPool pool(2);
+    pool.setMaxCompensationThreads(4);
+
+    // 补偿任务：收到检查信号后各判断一次是否退役，两个线程都判断完才行动
+    std::atomic<int> looping{0};
+    std::atomic<int> decided{0};
+    std::atomic<bool> check{false};
+    std::atomic<bool> quit{false};
+    pool.setCompensationTask([&] {
+        looping++;
+        bool decidedHere = false;
+        while (!quit) {
+            if (check && !decidedHere) {
+                decidedHere = true;
+                bool retire = ThreadPool::currentThreadShouldRetire();
+                decided++;
+                waitUntil([&] { return decided >= 2 || quit; }, 2000ms);
+                if (retire) {
+                    looping--;
+                    return;
+                }
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        looping--;
+    });
+
+    // 两个工作线程都进入阻塞区域，各补偿一个线程
+    std::promise<void> releaseFirst;
+    std::promise<void> releaseSecond;
+    std::shared_future<void> first = releaseFirst.get_future().share();
+    std::shared_future<void> second = releaseSecond.get_future().share();
+    std::vector<std::future<void>> blocked;
+    for (auto gate : {first, second}) {
+        blocked.emplace_back(pool.enqueue([gate] {
+            BlockingScope blocking;
+            gate.wait_for(5s);
+        }));
+    }
+    assert(waitUntil([&] { return looping == 2; }, 3000ms));
+
+    // 第一个阻塞结束后多出一个补偿线程
+    releaseFirst.set_value();
+    blocked[0].get();
+    check = true;
+    assert(waitUntil([&] { return decided == 2; }, 3000ms));
+    std::this_thread::sleep_for(50ms);
+
+    int stillLooping = looping;
+    size_t compensation = pool.getCompensationThreads();
+    std::cout << "Compensation threads still scheduling: " << stillLooping << ", counted: " << compensation
+              << std::endl;
+
+    quit = true;
+    releaseSecond.set_value();
+    blocked[1].get();
+
+    assert(stillLooping == 1);
+    assert(compensation == 1);
+    assert(waitUntil([&pool] { return pool.getCompensationThreads() == 0; }, 2000ms));
+    std::cout << "Partial retirement test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 混合阻塞/计算负载的吞吐量
+double runMixedWorkload(size_t maxCompensation, int numTasks) {
+    ThreadPool pool(2);
+    pool.setMaxCompensationThreads(maxCompensation);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<void>> futures;
+
+    for (int i = 0; i < numTasks; ++i) {
+        if (i % 2 == 0) {
+            futures.emplace_back(pool.enqueue([] {
+                BlockingScope blocking;
+                std::this_thread::sleep_for(5ms);
+            }));
+        } else {
+            futures.emplace_back(pool.enqueue([] {
+                volatile double x = 0;
+                for (int k = 0; k < 20000; ++k) {
+                    x = x + k * 0.5;
+                }
+            }));
+        }
+    }
+
+    for (auto& f : futures) {
+        f.get();
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return numTasks / elapsed;
+}
+
+// 测试4：混合负载吞吐量对比
+bool benchmarkMixedWorkload() {
+    std::cout << "\n=== Test 4: Mixed blocking/CPU workload throughput ===" << std::endl;
+
+    const int NUM_TASKS = 200;
+    double without = runMixedWorkload(0, NUM_TASKS);
+    double with = runMixedWorkload(8, NUM_TASKS);
+
+    std::cout << "Without compensation: " << without << " tasks/second" << std::endl;
+    std::cout << "With compensation:    " << with << " tasks/second" << std::endl;
+    std::cout << "Speedup: " << (with / without) << "x" << std::endl;
+
+    std::cout << "Mixed workload benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "=== BlockingScope Compensation Tests ===" << std::endl;
+
+    int passed = 0;
+    int total = 5;
+
+    if (testNestedFutureWait()) passed++;
+    if (testCompensationCap()) passed++;
+    if (testSchedulerCompensation()) passed++;
+    if (testPartialRetirement()) passed++;
+    if (benchmarkMixedWorkload()) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
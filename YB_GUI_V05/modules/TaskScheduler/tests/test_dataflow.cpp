@@ -0,0 +1,265 @@
+#include "../include/TaskScheduler.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+TaskResult value(std::any result) {
+    TaskResult taskResult(0, ResultStatus::SUCCESS);
+    taskResult.result = std::move(result);
+    return taskResult;
+}
+
+// 测试1：前驱的结果按dependencies的顺序放入输入槽，完成列表不保留交出的结果
+bool testInputSlots() {
+    std::cout << "\n=== Test 1: Results land in the successor's input slots ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(2)));
+
+    std::atomic<bool> gate{false};
+    TaskID a = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&gate] {
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return value(std::string("left"));
+    });
+    TaskID b = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [] { return value(40); });
+    assert(scheduler.waitForTask(b).status == ResultStatus::SUCCESS);
+
+    // b已完成：登记时从完成列表中取结果；a完成时结果直接放入槽中
+    TaskID joined = scheduler.submitDataflowTask(TaskType::USER_DEFINED, Priority::NORMAL,
+        [](std::vector<std::any>& inputs) {
+            assert(inputs.size() == 3);
+            std::string text = std::any_cast<std::string>(inputs[0]) + std::to_string(std::any_cast<int>(inputs[1]));
+            assert(std::any_cast<std::string>(inputs[2]) == "left");
+            return value(text + "2");
+        }, {a, b, a});
+    assert(scheduler.getTaskStatus(joined) == TaskStatus::PENDING);
+
+    gate = true;
+    TaskResult result = scheduler.waitForTask(joined);
+    assert(result.status == ResultStatus::SUCCESS);
+    assert(std::any_cast<std::string>(result.result) == "left402");
+
+    // a的结果已交给数据流后继，完成列表只保留状态；普通任务的结果照常保留
+    TaskResult forwarded = scheduler.waitForTask(a);
+    assert(forwarded.status == ResultStatus::SUCCESS);
+    assert(!forwarded.result.has_value());
+    assert(std::any_cast<int>(scheduler.waitForTask(b).result) == 40);
+
+    // 前驱失败时数据流任务被取消，不会拿到空输入执行
+    std::atomic<bool> ran{false};
+    TaskID failing = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, []() -> TaskResult {
+        std::this_thread::sleep_for(10ms);
+        throw std::runtime_error("decode failed");
+    });
+    TaskID consumer = scheduler.submitDataflowTask(TaskType::USER_DEFINED, Priority::NORMAL,
+        [&ran](std::vector<std::any>&) {
+            ran = true;
+            return value(0);
+        }, {failing});
+    assert(scheduler.waitForTask(consumer).status == ResultStatus::CANCELLED);
+    assert(!ran);
+
+    scheduler.shutdown();
+    std::cout << "Input slot test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：登记时前驱已完成、但结果已被覆盖或已交给其他数据流后继的，数据流任务被取消而不是拿到空输入执行
+bool testMissingInputs() {
+    std::cout << "\n=== Test 2: Missing predecessor results cancel the dataflow task ===" << std::endl;
+
+    TaskScheduler scheduler;
+    SchedulerConfig config = testConfig(1);
+    config.completedResultCapacity = 2;
+    assert(scheduler.initialize(config));
+
+    std::atomic<int> runs{0};
+    auto consume = [&runs](std::vector<std::any>&) {
+        runs++;
+        return value(0);
+    };
+
+    // 结果被后完成的任务挤出结果环
+    TaskID evicted = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [] { return value(1); });
+    assert(scheduler.waitForTask(evicted).status == ResultStatus::SUCCESS);
+    for (int i = 0; i < 4; ++i) {
+        TaskID filler = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [] { return value(0); });
+        scheduler.waitForTask(filler);
+    }
+    assert(scheduler.getTaskStatus(evicted) == TaskStatus::COMPLETED);
+    TaskID late = scheduler.submitDataflowTask(TaskType::USER_DEFINED, Priority::NORMAL, consume, {evicted});
+    assert(scheduler.getTaskStatus(late) == TaskStatus::CANCELLED);
+
+    // 结果已移交给第一个数据流后继，之后登记的后继取不到
+    TaskID source = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [] {
+        std::this_thread::sleep_for(10ms);
+        return value(2);
+    });
+    TaskID first = scheduler.submitDataflowTask(TaskType::USER_DEFINED, Priority::NORMAL, consume, {source});
+    assert(scheduler.waitForTask(first).status == ResultStatus::SUCCESS);
+    TaskID second = scheduler.submitDataflowTask(TaskType::USER_DEFINED, Priority::NORMAL, consume, {source});
+    assert(scheduler.getTaskStatus(second) == TaskStatus::CANCELLED);
+    assert(runs == 1);
+
+    // 普通后继不需要前驱的结果，照常执行
+    std::atomic<bool> ran{false};
+    TaskID plain = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&ran] {
+        ran = true;
+        return value(0);
+    }, {evicted});
+    assert(scheduler.waitForTask(plain).status == ResultStatus::SUCCESS);
+    assert(ran);
+
+    scheduler.shutdown();
+    std::cout << "Missing input test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 4MB的图像帧
+struct Image {
+    static std::atomic<int> allocations;
+
+    std::vector<uint8_t> pixels;
+
+    explicit Image(uint8_t fill) : pixels(4 * 1024 * 1024, fill) { allocations++; }
+    Image(const Image& other) : pixels(other.pixels) { allocations++; }
+    Image(Image&&) = default;
+};
+
+std::atomic<int> Image::allocations{0};
+
+// 一级处理：每隔一个缓存行改写一个像素
+void process(std::vector<uint8_t>& pixels) {
+    for (size_t i = 0; i < pixels.size(); i += 64) {
+        pixels[i]++;
+    }
+}
+
+// 测试3：4MB图像帧经过10级流水线。对照做法：结果按值放在TaskResult中，后继从getCompletedTasks中查找前驱的结果
+bool benchmarkPipeline(int frames) {
+    const int stages = 10;
+    std::cout << "\n=== Test 3: 4 MB frames through " << stages << " stages (" << frames << " frames) ===" << std::endl;
+
+    auto report = [frames](const char* name, double ms, int allocations) {
+        std::cout << name << ms / frames << " ms/frame, " << allocations << " buffer allocations" << std::endl;
+    };
+
+    // 对照：按值传递，经完成列表查找
+    double lookupMs = 0;
+    int lookupAllocations = 0;
+    {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(testConfig(4)));
+        Image::allocations = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<TaskID> last;
+        for (int frame = 0; frame < frames; ++frame) {
+            TaskID previous = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [] {
+                return value(Image(0));
+            });
+            for (int stage = 1; stage < stages; ++stage) {
+                previous = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&scheduler, previous] {
+                    for (const auto& completed : scheduler.getCompletedTasks()) {
+                        if (completed.taskId == previous) {
+                            Image image = std::any_cast<Image>(completed.result);
+                            process(image.pixels);
+                            return value(std::move(image));
+                        }
+                    }
+                    throw std::runtime_error("predecessor result not found");
+                }, std::vector<TaskID>{previous});
+            }
+            last.push_back(previous);
+        }
+        for (TaskID id : last) {
+            TaskResult result = scheduler.waitForTask(id);
+            assert(result.status == ResultStatus::SUCCESS);
+            assert(std::any_cast<const Image&>(result.result).pixels[0] == stages - 1);
+        }
+        lookupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        lookupAllocations = Image::allocations;
+        scheduler.shutdown();
+    }
+    report("By value via getCompletedTasks: ", lookupMs, lookupAllocations);
+
+    // 数据流：句柄移入后继的输入槽，后继持有唯一引用时就地处理，否则复制一份再处理
+    double dataflowMs = 0;
+    int dataflowAllocations = 0;
+    int sharedCopies = 0;
+    {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(testConfig(4)));
+        Image::allocations = 0;
+        std::atomic<int> shared{0};
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<TaskID> last;
+        for (int frame = 0; frame < frames; ++frame) {
+            TaskID previous = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [] {
+                return value(std::make_shared<Image>(0));
+            });
+            for (int stage = 1; stage < stages; ++stage) {
+                previous = scheduler.submitDataflowTask(TaskType::USER_DEFINED, Priority::NORMAL,
+                    [&shared](std::vector<std::any>& inputs) {
+                        auto image = std::any_cast<DataHandle<Image>>(std::move(inputs[0]));
+                        if (image.use_count() != 1) {
+                            // 前驱在本级登记前已完成，完成列表中还有一份引用
+                            image = std::make_shared<Image>(*image);
+                            shared++;
+                        }
+                        process(image->pixels);
+                        return value(std::move(image));
+                    }, {previous});
+            }
+            last.push_back(previous);
+        }
+        for (TaskID id : last) {
+            TaskResult result = scheduler.waitForTask(id);
+            assert(result.status == ResultStatus::SUCCESS);
+            assert(std::any_cast<DataHandle<Image>>(result.result)->pixels[0] == stages - 1);
+        }
+        dataflowMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        dataflowAllocations = Image::allocations;
+        sharedCopies = shared;
+        scheduler.shutdown();
+    }
+    report("Dataflow handles:               ", dataflowMs, dataflowAllocations);
+    std::cout << "Speedup: " << lookupMs / dataflowMs << "x" << std::endl;
+
+    // 除登记前前驱已完成的少数情况外，每帧只分配一次缓冲区，各级之间不复制
+    assert(dataflowAllocations == frames + sharedCopies);
+    assert(lookupAllocations > frames * stages);
+
+    std::cout << "Pipeline benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_dataflow [帧数]
+int main(int argc, char** argv) {
+    std::cout << "=== Dataflow Tests ===" << std::endl;
+
+    int frames = argc > 1 ? std::atoi(argv[1]) : 4;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testInputSlots()) passed++;
+    if (testMissingInputs()) passed++;
+    if (benchmarkPipeline(frames)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
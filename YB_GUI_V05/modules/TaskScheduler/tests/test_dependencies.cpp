@@ -0,0 +1,261 @@
+#include "../include/TaskScheduler.h"
+#include "../include/TaskGroup.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+std::shared_ptr<Task> dependentTask(std::vector<TaskID> dependencies, std::function<TaskResult()> function) {
+    auto task = std::make_shared<Task>(0, TaskType::USER_DEFINED, Priority::NORMAL, std::move(function));
+    task->dependencies = std::move(dependencies);
+    // 大图中后面的任务要等很久才开始执行，不受默认的30秒超时影响
+    task->timeout = std::chrono::hours(1);
+    return task;
+}
+
+// 测试1：菱形依赖按拓扑顺序执行，等待依赖期间保持PENDING且不会被等待方提前执行
+bool testDiamondOrder() {
+    std::cout << "\n=== Test 1: Diamond runs in dependency order ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(4)));
+
+    std::mutex mutex;
+    std::vector<char> order;
+    auto record = [&](char name) {
+        return [&, name] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+            return success();
+        };
+    };
+
+    std::atomic<bool> gate{false};
+    TaskID a = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&] {
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return record('A')();
+    });
+    TaskID b = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, record('B'), std::vector<TaskID>{a});
+    TaskID c = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, record('C'), std::vector<TaskID>{a});
+    TaskID d = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, record('D'),
+                                    std::vector<TaskID>{b, c});
+    assert(b > a && c > b && d > c);
+
+    std::this_thread::sleep_for(20ms);
+    assert(scheduler.getTaskStatus(b) == TaskStatus::PENDING);
+    assert(scheduler.getTaskStatus(d) == TaskStatus::PENDING);
+    assert(scheduler.getQueueStatus().pendingTasks == 3);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        assert(order.empty());
+    }
+
+    // 等待方不会绕过依赖在自己线程上执行D
+    std::thread releaser([&gate] {
+        std::this_thread::sleep_for(30ms);
+        gate = true;
+    });
+    assert(scheduler.waitForTask(d).status == ResultStatus::SUCCESS);
+    releaser.join();
+
+    assert(order.size() == 4);
+    assert(order.front() == 'A' && order.back() == 'D');
+
+    // 依赖已完成的任务直接入队
+    TaskID e = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, record('E'), std::vector<TaskID>{a, d});
+    assert(scheduler.waitForTask(e).status == ResultStatus::SUCCESS);
+    assert(order.back() == 'E');
+
+    scheduler.shutdown();
+    std::cout << "Diamond order test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：失败、取消和不存在的前驱使后继（及其后继）被取消
+bool testFailurePropagation() {
+    std::cout << "\n=== Test 2: Failed and cancelled predecessors propagate ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(2)));
+
+    std::atomic<int> ran{0};
+    auto work = [&ran] {
+        ran++;
+        return success();
+    };
+
+    {
+        TaskGroup group(scheduler);
+        std::atomic<bool> gate{false};
+        TaskID failing = group.run(dependentTask({}, [&gate]() -> TaskResult {
+            while (!gate) {
+                std::this_thread::sleep_for(1ms);
+            }
+            throw std::runtime_error("predecessor failed");
+        }));
+        TaskID child = group.run(dependentTask({failing}, work));
+        TaskID grandchild = group.run(dependentTask({child}, work));
+        TaskID joined = group.run(dependentTask({grandchild, failing}, work));
+
+        // 失败链上逐层挂接的长链不递归取消
+        TaskID tail = joined;
+        for (int i = 0; i < 20000; ++i) {
+            tail = group.run(dependentTask({tail}, work));
+        }
+
+        gate = true;
+        group.wait();
+        assert(scheduler.getTaskStatus(failing) == TaskStatus::FAILED);
+        assert(scheduler.getTaskStatus(child) == TaskStatus::CANCELLED);
+        assert(scheduler.getTaskStatus(joined) == TaskStatus::CANCELLED);
+        assert(scheduler.getTaskStatus(tail) == TaskStatus::CANCELLED);
+        assert(scheduler.waitForTask(grandchild).status == ResultStatus::CANCELLED);
+        assert(group.getStats().failed == 1);
+        assert(group.getStats().cancelled == 20003);
+
+        // 依赖已失败或不存在的任务提交后即为取消状态
+        TaskID late = group.run(dependentTask({failing}, work));
+        TaskID unknown = group.run(dependentTask({999999}, work));
+        assert(late != 0 && unknown != 0);
+        assert(scheduler.getTaskStatus(late) == TaskStatus::CANCELLED);
+        assert(scheduler.getTaskStatus(unknown) == TaskStatus::CANCELLED);
+    }
+    assert(ran == 0);
+
+    // 取消等待依赖的任务，其后继随之取消；前驱照常执行
+    std::atomic<bool> gate{false};
+    TaskID root = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&gate] {
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return success();
+    });
+    TaskID waiting = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, work, std::vector<TaskID>{root});
+    TaskID after = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, work, std::vector<TaskID>{waiting});
+    TaskID sibling = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, work, std::vector<TaskID>{root});
+    assert(scheduler.cancelTask(waiting));
+    assert(scheduler.getTaskStatus(after) == TaskStatus::CANCELLED);
+    gate = true;
+    assert(scheduler.waitForTask(sibling).status == ResultStatus::SUCCESS);
+    assert(scheduler.getTaskStatus(root) == TaskStatus::COMPLETED);
+    assert(ran == 1);
+
+    // 关闭时仍在等待依赖的任务通知取消
+    std::atomic<bool> blocker{false};
+    std::atomic<int> abandoned{0};
+    {
+        TaskGroup group(scheduler);
+        TaskID blocked = group.run(dependentTask({}, [&blocker] {
+            while (!blocker) {
+                std::this_thread::sleep_for(1ms);
+            }
+            return success();
+        }));
+        for (int i = 0; i < 5; ++i) {
+            group.run(dependentTask({blocked}, work));
+        }
+
+        std::thread releaser([&blocker] {
+            std::this_thread::sleep_for(50ms);
+            blocker = true;
+        });
+        scheduler.shutdown();
+        releaser.join();
+        assert(group.waitFor(1000ms));
+        abandoned = static_cast<int>(group.getStats().cancelled);
+    }
+    assert(abandoned == 5);
+    assert(ran == 1);
+
+    std::cout << "Failure propagation test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：宽图（一个根、N个并行节点、一个汇合节点）和深图（N个节点的链）
+bool benchmarkGraphs(int nodes) {
+    std::cout << "\n=== Test 3: Wide and deep DAGs (" << nodes << " nodes) ===" << std::endl;
+
+    auto run = [nodes](const char* name, auto build) {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(testConfig(4)));
+
+        std::atomic<int> done{0};
+        auto work = [&done] {
+            done++;
+            return success();
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        TaskID last = build(scheduler, work);
+        auto submitted = std::chrono::steady_clock::now();
+        while (done < nodes) {
+            std::this_thread::sleep_for(100us);
+        }
+        auto finished = std::chrono::steady_clock::now();
+        assert(scheduler.waitForTask(last).status == ResultStatus::SUCCESS);
+
+        double submitMs = std::chrono::duration<double, std::milli>(submitted - start).count();
+        double totalMs = std::chrono::duration<double, std::milli>(finished - start).count();
+        std::cout << name << submitMs << " ms to submit, " << totalMs << " ms total, "
+                  << static_cast<size_t>(nodes * 1000.0 / totalMs) << " nodes/s" << std::endl;
+        scheduler.shutdown();
+    };
+
+    // 参照：同样数量的无依赖任务
+    run("Independent: ", [nodes](TaskScheduler& scheduler, auto work) {
+        TaskID last = 0;
+        for (int i = 0; i < nodes; ++i) {
+            last = scheduler.submitTask(dependentTask({}, work));
+        }
+        return last;
+    });
+
+    run("Wide:        ", [nodes](TaskScheduler& scheduler, auto work) {
+        TaskID root = scheduler.submitTask(dependentTask({}, work));
+        std::vector<TaskID> middle;
+        for (int i = 0; i < nodes - 2; ++i) {
+            middle.push_back(scheduler.submitTask(dependentTask({root}, work)));
+        }
+        return scheduler.submitTask(dependentTask(std::move(middle), work));
+    });
+
+    run("Deep:        ", [nodes](TaskScheduler& scheduler, auto work) {
+        TaskID tail = scheduler.submitTask(dependentTask({}, work));
+        for (int i = 1; i < nodes; ++i) {
+            tail = scheduler.submitTask(dependentTask({tail}, work));
+        }
+        return tail;
+    });
+
+    std::cout << "DAG benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_dependencies [节点数]
+int main(int argc, char** argv) {
+    std::cout << "=== Dependency Tests ===" << std::endl;
+
+    int nodes = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testDiamondOrder()) passed++;
+    if (testFailurePropagation()) passed++;
+    if (benchmarkGraphs(nodes)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
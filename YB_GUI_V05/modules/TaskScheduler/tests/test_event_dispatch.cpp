@@ -0,0 +1,285 @@
+#include "../include/TaskScheduler.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+#include <sys/resource.h>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+SchedulerConfig dispatchConfig(size_t threads) {
+    SchedulerConfig config = testConfig(threads);
+    config.maxThreads = 8;
+    return config;
+}
+
+void waitForCount(const std::atomic<int>& count, int expected) {
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (count < expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+// 记录同时运行的任务数的峰值
+struct ConcurrencyProbe {
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    std::atomic<int> finished{0};
+
+    std::function<TaskResult()> task(std::chrono::milliseconds duration) {
+        return [this, duration] {
+            int now = ++running;
+            int previous = peak.load();
+            while (now > previous && !peak.compare_exchange_weak(previous, now)) {
+            }
+            std::this_thread::sleep_for(duration);
+            running--;
+            finished++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        };
+    }
+};
+
+// 提交tasks个任务并等待它们结束，返回同时运行的任务数的峰值
+int peakConcurrency(TaskScheduler& scheduler, int tasks) {
+    ConcurrencyProbe probe;
+    for (int i = 0; i < tasks; ++i) {
+        scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, probe.task(30ms));
+    }
+    waitForCount(probe.finished, tasks);
+    return probe.peak.load();
+}
+
+// 测试1：暂停后不再有任务开始，恢复后排队的任务一个不少地执行
+bool testExactPause() {
+    std::cout << "\n=== Test 1: Exact and loss-free pause/resume ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(dispatchConfig(3)));
+
+    std::atomic<int> started{0};
+    std::atomic<int> submitted{0};
+    std::vector<std::atomic<int>> runs(20000);
+    std::atomic<bool> stop{false};
+
+    // 提交方持续提交，同时反复暂停和恢复
+    std::thread producer([&] {
+        while (!stop && submitted < static_cast<int>(runs.size())) {
+            int index = submitted;
+            TaskID id = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&, index] {
+                started++;
+                runs[index]++;
+                return TaskResult(0, ResultStatus::SUCCESS);
+            });
+            if (id != 0) {
+                submitted++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int violations = 0;
+    for (int round = 0; round < 50; ++round) {
+        std::this_thread::sleep_for(2ms);
+        scheduler.pauseScheduling();
+        // 已被认领的任务可能仍在进入函数体
+        std::this_thread::sleep_for(5ms);
+        int before = started;
+        std::this_thread::sleep_for(10ms);
+        if (started != before) {
+            violations++;
+        }
+        scheduler.resumeScheduling();
+    }
+    stop = true;
+    producer.join();
+
+    waitForCount(started, submitted);
+    assert(violations == 0);
+    assert(started == submitted);
+    for (int i = 0; i < submitted; ++i) {
+        assert(runs[i] == 1);
+    }
+    std::cout << submitted << " tasks across 50 pauses, each run exactly once" << std::endl;
+
+    // 暂停期间排队的任务保持PENDING，可取消
+    std::atomic<int> ran{0};
+    auto work = [&ran] {
+        ran++;
+        return TaskResult(0, ResultStatus::SUCCESS);
+    };
+    TaskID kept = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, work);
+    TaskID dropped = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, work);
+    scheduler.pauseScheduling();
+    std::this_thread::sleep_for(20ms);
+    if (scheduler.getTaskStatus(dropped) == TaskStatus::PENDING) {
+        assert(scheduler.cancelTask(dropped));
+    }
+    scheduler.resumeScheduling();
+    assert(scheduler.waitForTask(kept).status == ResultStatus::SUCCESS);
+
+    scheduler.shutdown();
+    std::cout << "Exact pause test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：adjustThreadPoolSize等于实际的并发执行能力
+bool testPoolSizeIsCapacity() {
+    std::cout << "\n=== Test 2: Pool size equals execution capacity ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(dispatchConfig(2)));
+
+    auto peakWith = [&scheduler](int tasks) { return peakConcurrency(scheduler, tasks); };
+
+    assert(peakWith(8) == 2);
+
+    scheduler.adjustThreadPoolSize(5);
+    assert(peakWith(10) == 5);
+
+    // 缩小到比常驻线程数更少：退役线程的亲和队列转入全局队列
+    scheduler.adjustThreadPoolSize(1);
+    assert(peakWith(4) == 1);
+    std::atomic<int> affinityDone{0};
+    for (uint64_t key = 1; key <= 16; ++key) {
+        scheduler.submitAffinityTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, key, [&affinityDone] {
+            affinityDone++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+    waitForCount(affinityDone, 16);
+    assert(affinityDone == 16);
+
+    // 再次扩大时接管退役的亲和队列
+    scheduler.adjustThreadPoolSize(3);
+    assert(peakWith(6) == 3);
+
+    scheduler.shutdown();
+    std::cout << "Pool capacity test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：在任务中缩小线程数时不等待（要退出的可能正是调用方自己的循环）；
+// updateConfig按工作循环调整线程数，缩小时不会因线程池比运行中的循环更少而挂起
+bool testResizeFromTask() {
+    std::cout << "\n=== Test 3: Shrink from a task and through updateConfig ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(dispatchConfig(2)));
+
+    // 另一个工作线程等到缩小调用返回才结束，要退出的只能是发起缩小的任务所在的循环
+    std::atomic<int> started{0};
+    std::atomic<int> shrunk{0};
+    scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&started, &shrunk] {
+        started++;
+        while (shrunk == 0) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    waitForCount(started, 1);
+    scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&scheduler, &shrunk] {
+        scheduler.adjustThreadPoolSize(1);
+        shrunk++;
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    waitForCount(shrunk, 1);
+    assert(shrunk == 1);
+
+    // 多余的循环退出后只剩一个工作线程
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (scheduler.getPerformanceMetrics().currentActiveThreads != 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    assert(peakConcurrency(scheduler, 4) == 1);
+
+    SchedulerConfig config = dispatchConfig(4);
+    scheduler.updateConfig(config);
+    assert(peakConcurrency(scheduler, 8) == 4);
+
+    config.minThreads = 2;
+    scheduler.updateConfig(config);
+    assert(peakConcurrency(scheduler, 6) == 2);
+    assert(scheduler.getConfig().minThreads == 2);
+
+    scheduler.shutdown();
+    std::cout << "Resize from task test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试4：空闲时的唤醒次数和CPU占用，以及提交到开始执行的延迟
+bool benchmarkIdleAndLatency(size_t threads, int samples) {
+    std::cout << "\n=== Test 4: Idle cost and submit-to-start latency (" << threads << " workers) ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(dispatchConfig(threads)));
+    std::this_thread::sleep_for(50ms);
+
+    rusage before{};
+    getrusage(RUSAGE_SELF, &before);
+    std::this_thread::sleep_for(1s);
+    rusage after{};
+    getrusage(RUSAGE_SELF, &after);
+
+    auto cpuMicros = [](const rusage& usage) {
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000L + usage.ru_utime.tv_usec +
+               usage.ru_stime.tv_usec;
+    };
+    long wakeups = after.ru_nvcsw - before.ru_nvcsw;
+    std::cout << "Idle for 1 s: " << wakeups << " voluntary context switches, "
+              << (cpuMicros(after) - cpuMicros(before)) << " us CPU" << std::endl;
+
+    // 工作线程空闲阻塞时提交，测量到任务开始执行的时间
+    std::vector<double> latencies;
+    for (int i = 0; i < samples; ++i) {
+        std::this_thread::sleep_for(1ms);
+        std::promise<void> startedPromise;
+        auto startedFuture = startedPromise.get_future();
+        auto submitted = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point startedAt;
+        scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&] {
+            startedAt = std::chrono::steady_clock::now();
+            startedPromise.set_value();
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+        startedFuture.wait();
+        latencies.push_back(std::chrono::duration<double, std::micro>(startedAt - submitted).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "Submit-to-start: p50 " << latencies[latencies.size() / 2] << " us, p99 "
+              << latencies[latencies.size() * 99 / 100] << " us, max " << latencies.back() << " us" << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Idle and latency benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_event_dispatch [工作线程数] [延迟采样数]
+int main(int argc, char** argv) {
+    std::cout << "=== Event-Driven Dispatch Tests ===" << std::endl;
+
+    size_t threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8;
+    int samples = argc > 2 ? std::atoi(argv[2]) : 500;
+
+    int passed = 0;
+    int total = 4;
+
+    if (testExactPause()) passed++;
+    if (testPoolSizeIsCapacity()) passed++;
+    if (testResizeFromTask()) passed++;
+    if (benchmarkIdleAndLatency(threads, samples)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
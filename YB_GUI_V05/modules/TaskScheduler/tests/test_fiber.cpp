@@ -0,0 +1,376 @@
+#include "../include/TaskScheduler.h"
+#include "../include/ThreadPool.h"
+#include "../include/Fiber.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <deque>
+#include <cassert>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 纤程可能在另一个载体线程上恢复，每次重新读取线程ID（编译器会缓存pthread_self的结果）
+__attribute__((noinline)) std::thread::id carrierThreadId() {
+    asm volatile("");
+    return std::this_thread::get_id();
+}
+
+// 测试1：栈分配器复用与保护页
+bool testStackAllocator() {
+    std::cout << "\n=== Test 1: Pooled guard-paged stack allocator ===" << std::endl;
+
+    FiberStackAllocator allocator(16 * 1024, true, 4);
+    assert(allocator.getGuardSize() > 0);
+
+    auto stack = allocator.allocate();
+    assert(stack.base != nullptr);
+    assert(stack.size >= 16 * 1024);
+
+    // 栈可写
+    static_cast<char*>(stack.base)[0] = 1;
+    static_cast<char*>(stack.base)[stack.size - 1] = 1;
+
+    // 归还后再次分配应复用同一块栈
+    allocator.deallocate(stack);
+    assert(allocator.getPooledStacks() == 1);
+    auto reused = allocator.allocate();
+    assert(reused.base == stack.base);
+
+    // 写保护页应触发SIGSEGV（在子进程中验证）
+    pid_t pid = fork();
+    if (pid == 0) {
+        volatile char* guard = static_cast<char*>(reused.base) - 1;
+        *guard = 1;
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+
+    allocator.deallocate(reused);
+    std::cout << "Stack allocator test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：单个载体线程上的FiberMutex竞争
+bool testFiberMutex() {
+    std::cout << "\n=== Test 2: FiberMutex on a single carrier ===" << std::endl;
+
+    ThreadPool pool(1);
+    FiberRuntime runtime(pool, 1);
+
+    FiberMutex mutex;
+    int counter = 0;
+    const int NUM_FIBERS = 50;
+    const int ITERATIONS = 100;
+
+    for (int i = 0; i < NUM_FIBERS; ++i) {
+        runtime.spawn([&mutex, &counter] {
+            for (int k = 0; k < ITERATIONS; ++k) {
+                std::lock_guard<FiberMutex> lock(mutex);
+                int value = counter;
+                // 持锁让出，迫使其他纤程在锁上挂起
+                FiberRuntime::yield();
+                counter = value + 1;
+            }
+        });
+    }
+
+    runtime.waitIdle();
+    assert(counter == NUM_FIBERS * ITERATIONS);
+
+    std::cout << "Counter: " << counter << ", context switches: " << runtime.getContextSwitches() << std::endl;
+    std::cout << "FiberMutex test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：FiberCondVar生产者/消费者
+bool testFiberCondVar() {
+    std::cout << "\n=== Test 3: FiberCondVar producer/consumer ===" << std::endl;
+
+    ThreadPool pool(2);
+    FiberRuntime runtime(pool, 2);
+
+    FiberMutex mutex;
+    FiberCondVar notEmpty;
+    std::deque<int> queue;
+    std::atomic<long> consumed{0};
+    const int NUM_ITEMS = 1000;
+    const int NUM_CONSUMERS = 8;
+
+    for (int c = 0; c < NUM_CONSUMERS; ++c) {
+        runtime.spawn([&] {
+            while (true) {
+                std::unique_lock<FiberMutex> lock(mutex);
+                notEmpty.wait(lock, [&] { return !queue.empty(); });
+                int item = queue.front();
+                queue.pop_front();
+                if (item < 0) {
+                    return;
+                }
+                consumed += item;
+            }
+        });
+    }
+
+    runtime.spawn([&] {
+        for (int i = 1; i <= NUM_ITEMS; ++i) {
+            std::lock_guard<FiberMutex> lock(mutex);
+            queue.push_back(i);
+            notEmpty.notify_one();
+        }
+        std::lock_guard<FiberMutex> lock(mutex);
+        for (int c = 0; c < NUM_CONSUMERS; ++c) {
+            queue.push_back(-1);
+        }
+        notEmpty.notify_all();
+    });
+
+    runtime.waitIdle();
+    assert(consumed == static_cast<long>(NUM_ITEMS) * (NUM_ITEMS + 1) / 2);
+
+    std::cout << "FiberCondVar test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试4：调度器纤程任务在单个载体线程上互相等待
+bool testSchedulerFiberTasks() {
+    std::cout << "\n=== Test 4: TaskScheduler fiber tasks ===" << std::endl;
+
+    SchedulerConfig config;
+    config.minThreads = 1;
+    config.fiberCarriers = 1;
+    config.enableLoadBalancing = false;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    FiberMutex mutex;
+    FiberCondVar released;
+    bool gateOpen = false;
+    std::atomic<int> finished{0};
+
+    // 若使用OS线程，4个等待者会占满唯一的载体线程，放行任务永远无法执行
+    for (int i = 0; i < 4; ++i) {
+        scheduler.submitFiberTask(TaskType::USER_DEFINED, Priority::NORMAL, [&] {
+            std::unique_lock<FiberMutex> lock(mutex);
+            released.wait(lock, [&] { return gateOpen; });
+            finished++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+
+    scheduler.submitFiberTask(TaskType::USER_DEFINED, Priority::LOW, [&] {
+        std::lock_guard<FiberMutex> lock(mutex);
+        gateOpen = true;
+        released.notify_all();
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+
+    auto deadline = std::chrono::steady_clock::now() + 3s;
+    while (finished < 4 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    scheduler.shutdown();
+
+    assert(finished == 4);
+    std::cout << "Scheduler fiber task test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试5：纤程任务挂起后在另一个载体线程上恢复，优先级和当前任务随纤程迁移
+bool testFiberMigration() {
+    std::cout << "\n=== Test 5: Fiber task migrates between carriers ===" << std::endl;
+
+    SchedulerConfig config;
+    config.minThreads = 1;
+    config.fiberCarriers = 2;
+    config.enableLoadBalancing = false;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    FiberMutex mutex;
+    FiberCondVar wakeup;
+    bool resume = false;
+    std::atomic<std::thread::id> parkedOn{std::thread::id()};
+    std::atomic<bool> parked{false};
+    std::atomic<bool> woken{false};
+    std::atomic<bool> done{false};
+    std::atomic<bool> migrated{false};
+    std::atomic<bool> priorityKept{false};
+    std::atomic<bool> timeoutSeen{false};
+
+    // 执行时限在挂起期间到期，恢复后应能看到本任务已超时
+    auto waiter = std::make_shared<Task>(0, TaskType::USER_DEFINED, Priority::HIGH, [&] {
+        std::unique_lock<FiberMutex> lock(mutex);
+        parkedOn = carrierThreadId();
+        parked = true;
+        wakeup.wait(lock, [&] { return resume; });
+        migrated = carrierThreadId() != parkedOn.load();
+        priorityKept = currentTaskPriority() == Priority::HIGH;
+        timeoutSeen = TaskScheduler::currentTaskTimedOut();
+        done = true;
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    waiter->runOnFiber = true;
+    waiter->timeout = 20ms;
+    assert(scheduler.submitTask(waiter) != 0);
+
+    auto deadline = std::chrono::steady_clock::now() + 3s;
+    while (!parked && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    assert(parked);
+    std::this_thread::sleep_for(50ms);
+
+    // 占住等待者挂起时的载体线程再唤醒它，它只能在另一个载体线程上恢复；
+    // 占用线程的任务看到的是自己的优先级，而不是挂起的纤程留下的
+    std::atomic<bool> ownStateSeen{false};
+    for (int attempt = 0; attempt < 100 && !woken; ++attempt) {
+        TaskID hog = scheduler.submitFiberTask(TaskType::USER_DEFINED, Priority::LOW, [&] {
+            if (carrierThreadId() == parkedOn.load()) {
+                ownStateSeen = currentTaskPriority() == Priority::LOW && !TaskScheduler::currentTaskTimedOut();
+                {
+                    std::lock_guard<FiberMutex> lock(mutex);
+                    resume = true;
+                    wakeup.notify_all();
+                }
+                woken = true;
+                auto limit = std::chrono::steady_clock::now() + 3s;
+                while (!done && std::chrono::steady_clock::now() < limit) {
+                    std::this_thread::sleep_for(1ms);
+                }
+            }
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+        assert(hog != 0);
+        while (!woken && scheduler.getTaskStatus(hog) != TaskStatus::COMPLETED &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+
+    while (!done && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    scheduler.shutdown();
+
+    assert(woken && done);
+    assert(ownStateSeen);
+    assert(migrated);
+    assert(priorityKept);
+    assert(timeoutSeen);
+    std::cout << "Fiber migration test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试6：上下文切换开销
+bool benchmarkContextSwitch() {
+    std::cout << "\n=== Test 6: Context switch cost ===" << std::endl;
+
+    ThreadPool pool(1);
+    FiberRuntime runtime(pool, 1);
+
+    const int YIELDS = 200000;
+    std::atomic<int> started{0};
+
+    auto pingPong = [&] {
+        started++;
+        while (started < 2) {
+            FiberRuntime::yield();
+        }
+        for (int i = 0; i < YIELDS; ++i) {
+            FiberRuntime::yield();
+        }
+    };
+
+    auto before = runtime.getContextSwitches();
+    auto start = std::chrono::steady_clock::now();
+    runtime.spawn(pingPong);
+    runtime.spawn(pingPong);
+    runtime.waitIdle();
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    auto switches = runtime.getContextSwitches() - before;
+
+    std::cout << "Switches: " << switches << ", cost: " << (elapsed / switches) << " ns/switch" << std::endl;
+    std::cout << "Context switch benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试7：大量同时存活的纤程
+bool benchmarkLiveFibers(size_t numFibers, bool guardPages) {
+    std::cout << "\n=== Test 7: " << numFibers << " live fibers ===" << std::endl;
+
+    ThreadPool pool(1);
+    FiberConfig config;
+    config.stackSize = 16 * 1024;
+    config.guardPages = guardPages;
+    FiberRuntime runtime(pool, 1, config);
+
+    FiberMutex mutex;
+    FiberCondVar go;
+    bool released = false;
+    std::atomic<size_t> waiting{0};
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < numFibers; ++i) {
+        runtime.spawn([&] {
+            std::unique_lock<FiberMutex> lock(mutex);
+            waiting++;
+            go.wait(lock, [&] { return released; });
+        });
+    }
+
+    while (waiting < numFibers) {
+        std::this_thread::sleep_for(1ms);
+    }
+    auto spawned = std::chrono::steady_clock::now();
+    assert(runtime.getLiveFibers() == numFibers);
+
+    {
+        std::lock_guard<FiberMutex> lock(mutex);
+        released = true;
+    }
+    go.notify_all();
+    runtime.waitIdle();
+    auto finished = std::chrono::steady_clock::now();
+
+    std::cout << "Spawn+park: " << std::chrono::duration<double, std::milli>(spawned - start).count() << " ms, "
+              << "wake+finish: " << std::chrono::duration<double, std::milli>(finished - spawned).count() << " ms"
+              << std::endl;
+    std::cout << "Live fiber benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_fiber [存活纤程数] [--no-guard]
+// 带保护页时每个纤程占用两个内存映射区，百万级纤程需要调高vm.max_map_count
+int main(int argc, char** argv) {
+    std::cout << "=== Fiber Runtime Tests ===" << std::endl;
+
+    size_t liveFibers = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    bool guardPages = !(argc > 2 && std::string(argv[2]) == "--no-guard");
+
+    int passed = 0;
+    int total = 7;
+
+    if (testStackAllocator()) passed++;
+    if (testFiberMutex()) passed++;
+    if (testFiberCondVar()) passed++;
+    if (testSchedulerFiberTasks()) passed++;
+    if (testFiberMigration()) passed++;
+    if (benchmarkContextSwitch()) passed++;
+    if (benchmarkLiveFibers(liveFibers, guardPages)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,231 @@
+#include "../include/TaskScheduler.h"
+#include "../include/TaskGroup.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 简单的可重用屏障，超时返回false（部分调度时各部分会在这里空等）
+class Barrier {
+public:
+    explicit Barrier(size_t count) : count_(count), waiting_(0), generation_(0) {}
+
+    bool arriveAndWait(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        size_t generation = generation_;
+        if (++waiting_ == count_) {
+            waiting_ = 0;
+            generation_++;
+            condition_.notify_all();
+            return true;
+        }
+        return condition_.wait_for(lock, timeout, [this, generation] { return generation_ != generation; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    size_t count_;
+    size_t waiting_;
+    size_t generation_;
+};
+
+// 测试1：gang的各部分在不同线程上同时运行
+bool testGangRunsTogether() {
+    std::cout << "\n=== Test 1: Gang parts run simultaneously ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(4)));
+
+    Barrier barrier(4);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::set<size_t> parts;
+    std::atomic<int> barrierTimeouts{0};
+
+    TaskID gang = scheduler.submitGangTask(TaskType::AI_INFERENCE, Priority::HIGH, 4, [&](size_t part, size_t total) {
+        assert(total == 4);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+            parts.insert(part);
+        }
+        for (int step = 0; step < 10; ++step) {
+            if (!barrier.arriveAndWait(2000ms)) {
+                barrierTimeouts++;
+                return;
+            }
+        }
+    });
+    assert(gang != 0);
+
+    TaskResult result = scheduler.waitForTask(gang, 5000ms);
+    assert(result.status == ResultStatus::SUCCESS);
+    assert(barrierTimeouts == 0);
+    assert(threads.size() == 4);
+    assert(parts.size() == 4);
+
+    scheduler.shutdown();
+    std::cout << "Gang test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：超过线程数的gang被拒绝，部分失败时整个gang失败
+bool testRejectAndFailure() {
+    std::cout << "\n=== Test 2: Oversized gangs are rejected ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(2)));
+
+    assert(scheduler.submitGangTask(TaskType::AI_INFERENCE, Priority::NORMAL, 3, [](size_t, size_t) {}) == 0);
+    assert(scheduler.submitGangTask(TaskType::AI_INFERENCE, Priority::NORMAL, 0, [](size_t, size_t) {}) == 0);
+
+    TaskID gang = scheduler.submitGangTask(TaskType::AI_INFERENCE, Priority::NORMAL, 2, [](size_t part, size_t) {
+        if (part == 1) {
+            throw std::runtime_error("part failed");
+        }
+    });
+    TaskResult result = scheduler.waitForTask(gang, 5000ms);
+    assert(result.status == ResultStatus::FAILURE);
+    assert(result.errorMessage.find("part failed") != std::string::npos);
+
+    scheduler.shutdown();
+    std::cout << "Reject test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：集结中的gang在线程池缩减到不足parts个线程时失败，不会永远等待
+bool testShrinkWhileAssembling() {
+    std::cout << "\n=== Test 3: Shrinking the pool fails an assembling gang ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(3)));
+
+    // 占住一个线程，gang只能集结到2个
+    std::atomic<bool> gate{false};
+    TaskID blocker = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&gate] {
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    while (scheduler.getTaskStatus(blocker) != TaskStatus::RUNNING) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    std::atomic<bool> ran{false};
+    TaskID gang = scheduler.submitGangTask(TaskType::AI_INFERENCE, Priority::NORMAL, 3, [&ran](size_t, size_t) {
+        ran = true;
+    });
+    assert(gang != 0);
+    while (scheduler.getTaskStatus(gang) != TaskStatus::RUNNING) {
+        std::this_thread::sleep_for(1ms);
+    }
+    std::this_thread::sleep_for(20ms);
+
+    scheduler.adjustThreadPoolSize(2);
+    TaskResult result = scheduler.waitForTask(gang, 5000ms);
+    assert(result.status == ResultStatus::FAILURE);
+    assert(result.errorMessage.find("shrank") != std::string::npos);
+    assert(!ran);
+
+    // 缩减后的线程池照常执行任务和不超过线程数的gang
+    gate = true;
+    assert(scheduler.waitForTask(blocker, 5000ms).status == ResultStatus::SUCCESS);
+    TaskID small = scheduler.submitGangTask(TaskType::AI_INFERENCE, Priority::NORMAL, 2, [](size_t, size_t) {});
+    assert(scheduler.waitForTask(small, 5000ms).status == ResultStatus::SUCCESS);
+
+    scheduler.shutdown();
+    std::cout << "Shrink test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试4：负载下多个gang与普通任务混合，不会部分调度或死锁
+bool testGangsUnderLoad(int numGangs) {
+    std::cout << "\n=== Test 4: " << numGangs << " gangs mixed with normal load ===" << std::endl;
+
+    const size_t WORKERS = 4;
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(WORKERS)));
+
+    std::atomic<int> barrierTimeouts{0};
+    std::atomic<int> normalDone{0};
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        TaskGroup group(scheduler);
+        for (int g = 0; g < numGangs; ++g) {
+            // 普通任务占住部分线程
+            for (int i = 0; i < 20; ++i) {
+                group.run(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&normalDone] {
+                    std::this_thread::sleep_for(200us);
+                    normalDone++;
+                    return TaskResult(0, ResultStatus::SUCCESS);
+                });
+            }
+
+            // 大小不一的gang，包括占满全部线程的
+            size_t parts = 2 + g % (WORKERS - 1);
+            auto barrier = std::make_shared<Barrier>(parts);
+            group.run(TaskType::AI_INFERENCE, g % 2 ? Priority::HIGH : Priority::NORMAL, [&, parts, barrier] {
+                TaskID gang = scheduler.submitGangTask(TaskType::AI_INFERENCE, Priority::NORMAL, parts,
+                    [barrier, &barrierTimeouts](size_t, size_t) {
+                        for (int step = 0; step < 5; ++step) {
+                            if (!barrier->arriveAndWait(2000ms)) {
+                                barrierTimeouts++;
+                                return;
+                            }
+                        }
+                    });
+                assert(gang != 0);
+                return scheduler.waitForTask(gang);
+            });
+        }
+        group.wait();
+        assert(group.getStats().failed == 0);
+    }
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    auto metrics = scheduler.getPerformanceMetrics();
+    assert(barrierTimeouts == 0);
+    assert(normalDone == numGangs * 20);
+    assert(metrics.totalGangsRun == static_cast<size_t>(numGangs));
+
+    std::cout << "Total time: " << elapsed << " ms" << std::endl;
+    std::cout << "Gang wait for slots: avg " << metrics.averageGangWaitTime << " ms, max "
+              << metrics.maxGangWaitTime << " ms" << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Gangs under load test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_gang_scheduling [gang数量]
+int main(int argc, char** argv) {
+    std::cout << "=== Gang Scheduling Tests ===" << std::endl;
+
+    int numGangs = argc > 1 ? std::atoi(argv[1]) : 30;
+
+    int passed = 0;
+    int total = 4;
+
+    if (testGangRunsTogether()) passed++;
+    if (testRejectAndFailure()) passed++;
+    if (testShrinkWhileAssembling()) passed++;
+    if (testGangsUnderLoad(numGangs)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
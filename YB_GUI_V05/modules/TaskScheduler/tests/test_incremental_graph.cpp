@@ -0,0 +1,269 @@
+#include "../include/TaskScheduler.h"
+#include "../include/TaskGraph.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+
+uint64_t inputValue(const std::any* input) {
+    return std::any_cast<uint64_t>(*input);
+}
+
+// 测试1：只重新计算指纹改变的节点及其下游，其余复用上次的输出
+bool testDirtyTracking() {
+    std::cout << "\n=== Test 1: Only dirty nodes and their descendants rerun ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(2)));
+
+    // 4个分区各自求值，两两相减，再相加：p0 p1 -> d01，p2 p3 -> d23，d01 d23 -> total
+    std::vector<uint64_t> partitions = {10, 20, 30, 40};
+    std::vector<std::atomic<int>> runs(7);
+    bool failTotal = false;
+
+    TaskGraph graph(scheduler);
+    graph.setIncremental(true);
+    std::vector<TaskGraph::NodeID> p;
+    for (size_t i = 0; i < partitions.size(); ++i) {
+        p.push_back(graph.addValueNode([&, i](const std::any&, const std::vector<const std::any*>& inputs) {
+            assert(inputs.empty());
+            runs[i]++;
+            return std::any(partitions[i]);
+        }));
+        graph.setFingerprint(p[i], partitions[i]);
+    }
+    auto difference = [&](size_t slot) {
+        return [&, slot](const std::any&, const std::vector<const std::any*>& inputs) {
+            assert(inputs.size() == 2);
+            runs[slot]++;
+            return std::any(inputValue(inputs[1]) - inputValue(inputs[0]));
+        };
+    };
+    auto d01 = graph.addValueNode(difference(4));
+    auto d23 = graph.addValueNode(difference(5));
+    auto total = graph.addValueNode([&](const std::any&, const std::vector<const std::any*>& inputs) {
+        runs[6]++;
+        if (failTotal) {
+            throw std::runtime_error("total failed");
+        }
+        return std::any(inputValue(inputs[0]) + inputValue(inputs[1]));
+    });
+    // 输入顺序与addEdge顺序一致
+    graph.addEdge(p[0], d01);
+    graph.addEdge(p[1], d01);
+    graph.addEdge(p[3], d23);
+    graph.addEdge(p[2], d23);
+    graph.addEdge(d01, total);
+    graph.addEdge(d23, total);
+
+    auto runCounts = [&] {
+        std::vector<int> counts;
+        for (auto& count : runs) {
+            counts.push_back(count.load());
+        }
+        return counts;
+    };
+
+    // 第一次运行所有节点
+    assert(graph.run());
+    assert(std::any_cast<uint64_t>(graph.output(total)) == 10 + static_cast<uint64_t>(-10));
+    assert(runCounts() == std::vector<int>({1, 1, 1, 1, 1, 1, 1}));
+    assert(graph.getStats().lastRunNodesRun == 7);
+
+    // 输入不变：不执行任何节点
+    assert(graph.run());
+    assert(runCounts() == std::vector<int>({1, 1, 1, 1, 1, 1, 1}));
+    assert(graph.getStats().lastRunNodesReused == 7);
+
+    // 新分区：只有p1及其下游重新计算，d23复用上次的输出
+    partitions[1] = 25;
+    graph.setFingerprint(p[1], 25);
+    assert(graph.run());
+    assert(std::any_cast<uint64_t>(graph.output(d01)) == 15);
+    assert(std::any_cast<uint64_t>(graph.output(total)) == 15 + static_cast<uint64_t>(-10));
+    assert(runCounts() == std::vector<int>({1, 2, 1, 1, 2, 1, 2}));
+    TaskGraphStats stats = graph.getStats();
+    assert(stats.lastRunNodesRun == 3 && stats.lastRunNodesReused == 4);
+
+    // 相同指纹不算改变
+    graph.setFingerprint(p[1], 25);
+    assert(graph.run());
+    assert(runCounts() == std::vector<int>({1, 2, 1, 1, 2, 1, 2}));
+
+    // 失败的节点下一次仍要执行，即使输入没有变化
+    failTotal = true;
+    graph.invalidate(p[3]);
+    assert(!graph.run());
+    assert(graph.lastError() == "total failed");
+    assert(runCounts() == std::vector<int>({1, 2, 1, 2, 2, 2, 3}));
+    failTotal = false;
+    assert(graph.run());
+    assert(runCounts() == std::vector<int>({1, 2, 1, 2, 2, 2, 4}));
+    assert(graph.getStats().lastRunNodesRun == 1);
+
+    // 关闭增量模式后每次执行所有节点
+    graph.setIncremental(false);
+    assert(graph.run());
+    assert(runCounts() == std::vector<int>({2, 3, 2, 3, 3, 3, 5}));
+
+    stats = graph.getStats();
+    assert(stats.runs == 7);
+    assert(stats.nodesRun == 7 + 3 + 3 + 1 + 7);
+    assert(stats.nodesReused == 7 + 4 + 7 + 4 + 6);
+
+    scheduler.shutdown();
+    std::cout << "Dirty tracking test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 模拟一个节点的计算量
+uint64_t mix(uint64_t a, uint64_t b) {
+    uint64_t x = a ^ (b * 0x9E3779B97F4A7C15ull);
+    for (int i = 0; i < 200; ++i) {
+        x ^= x >> 31;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 29;
+    }
+    return x;
+}
+
+// 测试2：DATA_ANALYSIS形状的图，每个分区9级处理再逐层两两汇总；每轮1%的节点输入改变
+bool benchmarkChurn(size_t partitionCount, int rounds, size_t threads) {
+    const size_t stages = 9;
+    const size_t nodes = partitionCount * stages + partitionCount - 1;
+    const size_t churn = nodes / 100;
+    std::cout << "\n=== Test 2: " << nodes << "-node graph with 1% churn (" << rounds << " rounds, "
+              << threads << " workers) ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(threads)));
+
+    // versions[i]为处理节点i的外部输入版本，也作为其指纹
+    std::vector<uint64_t> versions(partitionCount * stages, 1);
+    TaskGraph graph(scheduler);
+    for (size_t i = 0; i < partitionCount * stages; ++i) {
+        graph.addValueNode([&versions, i](const std::any&, const std::vector<const std::any*>& inputs) {
+            uint64_t previous = inputs.empty() ? i : inputValue(inputs[0]);
+            return std::any(mix(previous, versions[i]));
+        });
+        graph.setFingerprint(i, versions[i]);
+        if (i % stages != 0) {
+            graph.addEdge(i - 1, i);
+        }
+    }
+    std::vector<TaskGraph::NodeID> level;
+    for (size_t partition = 0; partition < partitionCount; ++partition) {
+        level.push_back(partition * stages + stages - 1);
+    }
+    while (level.size() > 1) {
+        std::vector<TaskGraph::NodeID> merged;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) {
+            auto node = graph.addValueNode([](const std::any&, const std::vector<const std::any*>& inputs) {
+                return std::any(mix(inputValue(inputs[0]), inputValue(inputs[1])));
+            });
+            graph.addEdge(level[i], node);
+            graph.addEdge(level[i + 1], node);
+            merged.push_back(node);
+        }
+        if (level.size() % 2 == 1) {
+            merged.push_back(level.back());
+        }
+        level = merged;
+    }
+    assert(graph.size() == nodes);
+    const TaskGraph::NodeID root = level.front();
+
+    // 串行计算的参照结果
+    auto reference = [&] {
+        std::vector<uint64_t> values;
+        for (size_t partition = 0; partition < partitionCount; ++partition) {
+            uint64_t value = partition * stages;
+            for (size_t stage = 0; stage < stages; ++stage) {
+                value = mix(value, versions[partition * stages + stage]);
+            }
+            values.push_back(value);
+        }
+        while (values.size() > 1) {
+            std::vector<uint64_t> merged;
+            for (size_t i = 0; i + 1 < values.size(); i += 2) {
+                merged.push_back(mix(values[i], values[i + 1]));
+            }
+            if (values.size() % 2 == 1) {
+                merged.push_back(values.back());
+            }
+            values = merged;
+        }
+        return values.front();
+    };
+
+    std::mt19937_64 random(42);
+    auto applyChurn = [&] {
+        for (size_t i = 0; i < churn; ++i) {
+            size_t node = random() % versions.size();
+            versions[node]++;
+            graph.setFingerprint(node, versions[node]);
+        }
+    };
+
+    // 全量：每轮执行所有节点
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        applyChurn();
+        assert(graph.run());
+    }
+    double fullMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    assert(std::any_cast<uint64_t>(graph.output(root)) == reference());
+    assert(graph.getStats().lastRunNodesRun == nodes);
+
+    // 增量：只执行改变的节点及其下游
+    graph.setIncremental(true);
+    size_t before = graph.getStats().nodesRun;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        applyChurn();
+        assert(graph.run());
+    }
+    double incrementalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    assert(std::any_cast<uint64_t>(graph.output(root)) == reference());
+
+    TaskGraphStats stats = graph.getStats();
+    size_t recomputed = stats.nodesRun - before;
+    assert(stats.lastRunNodesRun + stats.lastRunNodesReused == nodes);
+    assert(recomputed < static_cast<size_t>(rounds) * nodes / 4);
+
+    std::cout << "Full:        " << fullMs / rounds << " ms/run, " << nodes << " nodes/run" << std::endl;
+    std::cout << "Incremental: " << incrementalMs / rounds << " ms/run, "
+              << recomputed / rounds << " recomputed, " << nodes - recomputed / rounds << " reused per run" << std::endl;
+    std::cout << "Speedup: " << fullMs / incrementalMs << "x" << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Churn benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_incremental_graph [分区数] [轮数] [工作线程数]
+int main(int argc, char** argv) {
+    std::cout << "=== Incremental Task Graph Tests ===" << std::endl;
+
+    size_t partitions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+    size_t threads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 4;
+
+    int passed = 0;
+    int total = 2;
+
+    if (testDirtyTracking()) passed++;
+    if (benchmarkChurn(partitions, rounds, threads)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,303 @@
+#include "../include/TaskScheduler.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 占住唯一的工作线程，直到gate被放行
+TaskID submitBlocker(TaskScheduler& scheduler, std::atomic<bool>& started, std::atomic<bool>& gate) {
+    TaskID id = scheduler.submitTask(TaskType::USER_DEFINED, Priority::CRITICAL, [&started, &gate] {
+        started = true;
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+    return id;
+}
+
+// 测试1：工作线程忙时，waitForTask在调用线程上执行排队中的任务
+bool testWaitRunsQueuedTaskInline() {
+    std::cout << "\n=== Test 1: waitForTask runs a queued task inline ===" << std::endl;
+
+    SchedulerConfig config;
+    config.minThreads = 1;
+    config.enableLoadBalancing = false;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> gate{false};
+    TaskID blocker = submitBlocker(scheduler, started, gate);
+
+    std::thread::id executedOn;
+    TaskID taskId = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&executedOn] {
+        executedOn = std::this_thread::get_id();
+        TaskResult result(0, ResultStatus::SUCCESS);
+        result.result = 42;
+        return result;
+    });
+
+    TaskResult result = scheduler.waitForTask(taskId);
+    assert(result.status == ResultStatus::SUCCESS);
+    assert(result.taskId == taskId);
+    assert(std::any_cast<int>(result.result) == 42);
+    assert(executedOn == std::this_thread::get_id());
+    assert(scheduler.getTaskStatus(taskId) == TaskStatus::COMPLETED);
+
+    // 正在运行的任务只能等待
+    TaskResult timedOut = scheduler.waitForTask(blocker, 20ms);
+    assert(timedOut.status == ResultStatus::TIMEOUT);
+
+    gate = true;
+    TaskResult blockerResult = scheduler.waitForTask(blocker);
+    assert(blockerResult.status == ResultStatus::SUCCESS);
+
+    auto metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.totalTasksRunInline == 1);
+
+    scheduler.shutdown();
+    std::cout << "Inline wait test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：submitAndWait同步执行并返回结果和异常
+bool testSubmitAndWait() {
+    std::cout << "\n=== Test 2: submitAndWait ===" << std::endl;
+
+    SchedulerConfig config;
+    config.minThreads = 1;
+    config.enableLoadBalancing = false;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    TaskResult ok = scheduler.submitAndWait(TaskType::USER_DEFINED, Priority::HIGH, [] {
+        TaskResult result(0, ResultStatus::SUCCESS);
+        result.result = std::string("done");
+        return result;
+    });
+    assert(ok.status == ResultStatus::SUCCESS);
+    assert(std::any_cast<std::string>(ok.result) == "done");
+    assert(scheduler.getTaskStatus(ok.taskId) == TaskStatus::COMPLETED);
+
+    TaskResult failed = scheduler.submitAndWait(TaskType::USER_DEFINED, Priority::HIGH, []() -> TaskResult {
+        throw std::runtime_error("boom");
+    });
+    assert(failed.status == ResultStatus::FAILURE);
+    assert(failed.errorMessage == "boom");
+    assert(scheduler.getTaskStatus(failed.taskId) == TaskStatus::FAILED);
+
+    // 未知任务
+    assert(scheduler.waitForTask(999999).status == ResultStatus::CANCELLED);
+
+    scheduler.shutdown();
+    std::cout << "submitAndWait test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：队列已满时的REJECT与CALLER_RUNS策略
+bool testRejectionPolicies() {
+    std::cout << "\n=== Test 3: Rejection policies ===" << std::endl;
+
+    for (RejectionPolicy policy : {RejectionPolicy::REJECT, RejectionPolicy::CALLER_RUNS}) {
+        SchedulerConfig config;
+        config.minThreads = 1;
+        config.maxQueueSize = 4;
+        config.rejectionPolicy = policy;
+        config.enableLoadBalancing = false;
+
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(config));
+
+        std::atomic<bool> started{false};
+        std::atomic<bool> gate{false};
+        submitBlocker(scheduler, started, gate);
+
+        std::atomic<int> ranOnCaller{0};
+        std::thread::id caller = std::this_thread::get_id();
+        int accepted = 0;
+        for (int i = 0; i < 10; ++i) {
+            TaskID id = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&ranOnCaller, caller] {
+                if (std::this_thread::get_id() == caller) {
+                    ranOnCaller++;
+                }
+                return TaskResult(0, ResultStatus::SUCCESS);
+            });
+            if (id != 0) {
+                accepted++;
+            }
+        }
+
+        auto metrics = scheduler.getPerformanceMetrics();
+        if (policy == RejectionPolicy::REJECT) {
+            assert(accepted == 4);
+            assert(metrics.totalTasksRejected == 6);
+            assert(ranOnCaller == 0);
+        } else {
+            assert(accepted == 10);
+            assert(metrics.totalTasksRunInline == 6);
+            assert(ranOnCaller == 6);
+        }
+
+        gate = true;
+        scheduler.shutdown();
+    }
+
+    std::cout << "Rejection policy test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试4：等待方认领并执行的任务不再计入排队任务数，队列留下的旧条目不会使后续提交被拒绝或在调用线程上执行
+bool testInlineClaimLeavesQueue() {
+    std::cout << "\n=== Test 4: Inline-claimed tasks leave the queue count ===" << std::endl;
+
+    for (RejectionPolicy policy : {RejectionPolicy::REJECT, RejectionPolicy::CALLER_RUNS}) {
+        SchedulerConfig config;
+        config.minThreads = 1;
+        config.maxQueueSize = 4;
+        config.rejectionPolicy = policy;
+        config.enableLoadBalancing = false;
+
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(config));
+
+        std::atomic<bool> started{false};
+        std::atomic<bool> gate{false};
+        submitBlocker(scheduler, started, gate);
+
+        auto work = [] { return TaskResult(0, ResultStatus::SUCCESS); };
+        for (int round = 0; round < 3; ++round) {
+            // 填满队列后全部由等待方执行
+            std::vector<TaskID> ids;
+            for (int i = 0; i < 4; ++i) {
+                ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, work));
+                assert(ids.back() != 0);
+            }
+            for (const auto& result : scheduler.waitForTasks(ids)) {
+                assert(result.status == ResultStatus::SUCCESS);
+            }
+            assert(scheduler.getPerformanceMetrics().currentQueueSize == 0);
+        }
+
+        auto metrics = scheduler.getPerformanceMetrics();
+        assert(metrics.totalTasksRejected == 0);
+        assert(metrics.totalTasksRunInline == 12);
+
+        // 工作线程放行后跳过旧条目，计数保持一致
+        gate = true;
+        std::vector<TaskID> ids;
+        for (int i = 0; i < 4; ++i) {
+            ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, work));
+        }
+        scheduler.waitForTasks(ids);
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (scheduler.getPerformanceMetrics().currentQueueSize != 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(1ms);
+        }
+        assert(scheduler.getPerformanceMetrics().currentQueueSize == 0);
+
+        scheduler.shutdown();
+    }
+
+    std::cout << "Inline claim queue count test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 打印往返延迟分布
+void printLatency(const std::string& name, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double q) { return samples[static_cast<size_t>(q * (samples.size() - 1))]; };
+    std::cout << name << " p50: " << at(0.50) << " us, p99: " << at(0.99) << " us" << std::endl;
+}
+
+// 测试5：submit+wait往返延迟对比
+bool benchmarkRoundTrip(int iterations) {
+    std::cout << "\n=== Test 5: Submit+wait round trip (" << iterations << " iterations) ===" << std::endl;
+
+    SchedulerConfig config;
+    config.minThreads = 2;
+    config.enableLoadBalancing = false;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    auto work = [] {
+        TaskResult result(0, ResultStatus::SUCCESS);
+        result.result = 1;
+        return result;
+    };
+
+    auto measure = [iterations](auto&& roundTrip) {
+        std::vector<double> samples;
+        samples.reserve(iterations);
+        for (int i = 0; i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            roundTrip();
+            samples.push_back(std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+        return samples;
+    };
+
+    // 现有方式：提交后轮询状态，等工作线程执行
+    auto polling = measure([&] {
+        TaskID id = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, work);
+        while (scheduler.getTaskStatus(id) != TaskStatus::COMPLETED) {
+            std::this_thread::yield();
+        }
+    });
+
+    size_t inlineBefore = scheduler.getPerformanceMetrics().totalTasksRunInline;
+    auto waiting = measure([&] {
+        TaskID id = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, work);
+        assert(scheduler.waitForTask(id).status == ResultStatus::SUCCESS);
+    });
+    size_t claimed = scheduler.getPerformanceMetrics().totalTasksRunInline - inlineBefore;
+
+    auto direct = measure([&] {
+        assert(scheduler.submitAndWait(TaskType::USER_DEFINED, Priority::NORMAL, work).status ==
+               ResultStatus::SUCCESS);
+    });
+
+    printLatency("submit + poll status:", polling);
+    printLatency("submit + waitForTask:", waiting);
+    std::cout << "  (claimed inline: " << claimed << "/" << iterations << ")" << std::endl;
+    printLatency("submitAndWait:       ", direct);
+
+    scheduler.shutdown();
+    std::cout << "Round trip benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_inline_execution [往返次数]
+int main(int argc, char** argv) {
+    std::cout << "=== Inline Execution Tests ===" << std::endl;
+
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+
+    int passed = 0;
+    int total = 5;
+
+    if (testWaitRunsQueuedTaskInline()) passed++;
+    if (testSubmitAndWait()) passed++;
+    if (testRejectionPolicies()) passed++;
+    if (testInlineClaimLeavesQueue()) passed++;
+    if (benchmarkRoundTrip(iterations)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
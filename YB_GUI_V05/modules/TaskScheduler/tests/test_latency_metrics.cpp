@@ -0,0 +1,193 @@
+#include "../include/TaskScheduler.h"
+#include "../include/LatencyHistogram.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 测试1：桶边界覆盖全部取值，分位数的相对误差不超过桶宽，合并等于逐桶相加
+bool testBuckets() {
+    std::cout << "\n=== Test 1: Log-bucketed histogram accuracy ===" << std::endl;
+
+    // 桶连续且不重叠，桶宽不超过下界的1/16
+    for (size_t i = 0; i + 1 < LatencyDistribution::kBucketCount; ++i) {
+        uint64_t lower = LatencyDistribution::bucketLowerBound(i);
+        uint64_t upper = LatencyDistribution::bucketUpperBound(i);
+        assert(LatencyDistribution::bucketLowerBound(i + 1) == upper + 1);
+        assert(upper - lower <= lower / 16);
+        assert(LatencyDistribution::bucketIndex(lower) == i);
+        assert(LatencyDistribution::bucketIndex(upper) == i);
+    }
+    assert(LatencyDistribution::bucketIndex(UINT64_MAX) == LatencyDistribution::kBucketCount - 1);
+
+    // 1微秒到100毫秒之间的对数均匀分布
+    std::mt19937_64 random(7);
+    std::vector<uint64_t> values;
+    LatencyDistribution even, odd;
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t value = static_cast<uint64_t>(std::exp(std::log(1e3) + (std::log(1e8) - std::log(1e3)) *
+                                                        (random() % 1000000) / 1e6));
+        values.push_back(value);
+        (i % 2 ? odd : even).buckets[LatencyDistribution::bucketIndex(value)]++;
+    }
+    LatencyDistribution merged = even;
+    merged.merge(odd);
+    assert(merged.count() == values.size());
+
+    std::sort(values.begin(), values.end());
+    for (double percent : {50.0, 90.0, 99.0, 99.9}) {
+        double exact = values[static_cast<size_t>(std::ceil(percent / 100 * values.size())) - 1] / 1e6;
+        double estimate = merged.percentile(percent);
+        assert(estimate >= exact && estimate <= exact * 1.0625);
+    }
+    double exactMean = 0;
+    for (uint64_t value : values) {
+        exactMean += value / 1e6;
+    }
+    exactMean /= values.size();
+    assert(std::abs(merged.mean() - exactMean) <= exactMean * 0.0625);
+    assert(merged.max() >= values.back() / 1e6);
+
+    std::cout << "Histogram accuracy test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：单个工作线程被占住时提交的任务，按优先级和任务类型分开统计等待和执行时间
+bool testSchedulerLatencies() {
+    std::cout << "\n=== Test 2: Wait, execution and end-to-end latency by priority and type ===" << std::endl;
+
+    SchedulerConfig config;
+    config.minThreads = 1;
+    config.enableLoadBalancing = false;
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    std::atomic<bool> gate{false};
+    std::vector<TaskID> ids;
+    ids.push_back(scheduler.submitTask(TaskType::SYSTEM_MAINTENANCE, Priority::CRITICAL, [&gate] {
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    }));
+    std::this_thread::sleep_for(5ms);
+
+    // 高优先级的图像任务先执行，低优先级的分析任务排在它们之后
+    for (int i = 0; i < 10; ++i) {
+        ids.push_back(scheduler.submitTask(TaskType::DATA_ANALYSIS, Priority::LOW, [] {
+            return TaskResult(0, ResultStatus::SUCCESS);
+        }));
+        ids.push_back(scheduler.submitTask(TaskType::IMAGE_PROCESSING, Priority::HIGH, [] {
+            std::this_thread::sleep_for(2ms);
+            return TaskResult(0, ResultStatus::SUCCESS);
+        }));
+    }
+    std::this_thread::sleep_for(20ms);
+    gate = true;
+    // 不用waitForTasks：等待方会按ID顺序认领排队的任务，打乱优先级顺序
+    while (scheduler.getPerformanceMetrics().totalTasksCompleted < ids.size()) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    auto count = [&](LatencyKind kind, std::optional<Priority> priority, std::optional<TaskType> type) {
+        return scheduler.getLatencyDistribution(kind, priority, type).count();
+    };
+    assert(count(LatencyKind::QUEUE_WAIT, std::nullopt, std::nullopt) == 21);
+    assert(count(LatencyKind::EXECUTION, Priority::HIGH, std::nullopt) == 10);
+    assert(count(LatencyKind::END_TO_END, std::nullopt, TaskType::DATA_ANALYSIS) == 10);
+    assert(count(LatencyKind::EXECUTION, Priority::HIGH, TaskType::DATA_ANALYSIS) == 0);
+
+    double highWait = scheduler.getLatencyPercentile(LatencyKind::QUEUE_WAIT, 50, Priority::HIGH);
+    double lowWait = scheduler.getLatencyPercentile(LatencyKind::QUEUE_WAIT, 50, Priority::LOW);
+    double imageExecution = scheduler.getLatencyPercentile(LatencyKind::EXECUTION, 50, std::nullopt,
+                                                           TaskType::IMAGE_PROCESSING);
+    double imageEndToEnd = scheduler.getLatencyPercentile(LatencyKind::END_TO_END, 99.9, std::nullopt,
+                                                          TaskType::IMAGE_PROCESSING);
+    double blockerExecution = scheduler.getLatencyPercentile(LatencyKind::EXECUTION, 100, Priority::CRITICAL);
+    std::cout << "Queue wait p50: HIGH " << highWait << " ms, LOW " << lowWait << " ms; image execution p50 "
+              << imageExecution << " ms, end-to-end p99.9 " << imageEndToEnd << " ms" << std::endl;
+
+    // 排队期间阻塞任务至少占住20ms；低优先级任务等全部图像任务（每个至少2ms）执行完才开始
+    assert(highWait >= 20);
+    assert(lowWait >= highWait + 5);
+    assert(scheduler.getLatencyPercentile(LatencyKind::QUEUE_WAIT, 0, Priority::LOW) >=
+           scheduler.getLatencyPercentile(LatencyKind::QUEUE_WAIT, 100, Priority::HIGH));
+    assert(imageExecution >= 2);
+    assert(imageEndToEnd >= highWait + imageExecution);
+    assert(blockerExecution >= 20);
+
+    PerformanceMetrics metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.averageWaitTime >= 20);
+
+    scheduler.shutdown();
+    std::cout << "Scheduler latency test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：记录开销。每个任务在三个直方图中各记一次
+bool benchmarkRecording(size_t records) {
+    std::cout << "\n=== Test 3: Recording overhead (" << records << " tasks) ===" << std::endl;
+
+    // 预先生成时间戳，只测记录本身
+    std::mt19937_64 random(11);
+    auto base = std::chrono::steady_clock::now();
+    std::vector<std::chrono::steady_clock::time_point> points;
+    std::vector<Priority> priorities;
+    std::vector<TaskType> types;
+    for (int i = 0; i < 4096; ++i) {
+        points.push_back(base + std::chrono::nanoseconds(random() % 50000000));
+        priorities.push_back(static_cast<Priority>(random() % 5));
+        types.push_back(static_cast<TaskType>(random() % 5));
+    }
+    std::sort(points.begin(), points.end());
+
+    LatencyRecorder recorder;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < records; ++i) {
+        size_t at = i & 4095;
+        recorder.record(priorities[at], types[at], base, points[at >> 1], points[at]);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / records;
+
+    uint64_t recorded = recorder.distribution(LatencyKind::END_TO_END, std::nullopt, std::nullopt).count();
+    assert(recorded == records);
+
+    // 合并全部组合的开销（查询侧）
+    start = std::chrono::steady_clock::now();
+    double p99 = recorder.distribution(LatencyKind::QUEUE_WAIT, std::nullopt, std::nullopt).percentile(99);
+    double mergeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << ns << " ns per task recorded, " << mergeUs << " us to merge 25 histograms (p99 " << p99
+              << " ms)" << std::endl;
+
+    std::cout << "Recording benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_latency_metrics [记录次数]
+int main(int argc, char** argv) {
+    std::cout << "=== Latency Metrics Tests ===" << std::endl;
+
+    size_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testBuckets()) passed++;
+    if (testSchedulerLatencies()) passed++;
+    if (benchmarkRecording(records)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+#include "../include/TaskScheduler.h"
+#include "../include/MetricCounters.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+
+SchedulerConfig counterConfig(size_t threads, bool collectMetrics) {
+    SchedulerConfig config = testConfig(threads);
+    config.collectMetrics = collectMetrics;
+    config.maxFinishedTaskRecords = 10000000;
+    return config;
+}
+
+// 测试1：多个线程提交、完成和失败的计数合并后准确；线程退出后计数保留，重新初始化时清零，关闭后不再记录
+bool testCounts() {
+    std::cout << "\n=== Test 1: Sharded counts add up across threads ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(counterConfig(2, true)));
+
+    const int producers = 4;
+    const int perProducer = 2000;
+    std::vector<std::thread> threads;
+    std::vector<std::vector<TaskID>> ids(producers);
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                if (i % 10 == 0) {
+                    ids[p].push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL,
+                                                          []() -> TaskResult { throw std::runtime_error("fail"); }));
+                } else {
+                    ids[p].push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& batch : ids) {
+        scheduler.waitForTasks(batch);
+    }
+    assert(scheduler.submitAndWait(TaskType::USER_DEFINED, Priority::NORMAL, success).status == ResultStatus::SUCCESS);
+
+    PerformanceMetrics metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.totalTasksSubmitted == producers * perProducer + 1);
+    assert(metrics.totalTasksFailed == producers * perProducer / 10);
+    assert(metrics.totalTasksCompleted == producers * perProducer * 9 / 10 + 1);
+    assert(metrics.totalTasksRunInline >= 1);
+    scheduler.shutdown();
+
+    // 重新初始化后从零开始计数
+    assert(scheduler.initialize(counterConfig(2, false)));
+    assert(scheduler.getPerformanceMetrics().totalTasksSubmitted == 0);
+
+    // 关闭记录后计数和延迟分布都不增长
+    std::vector<TaskID> unrecorded;
+    for (int i = 0; i < 100; ++i) {
+        unrecorded.push_back(scheduler.submitTask(TaskType::IMAGE_PROCESSING, Priority::NORMAL, success));
+    }
+    scheduler.waitForTasks(unrecorded);
+    metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.totalTasksSubmitted == 0 && metrics.totalTasksCompleted == 0);
+    assert(scheduler.getLatencyDistribution(LatencyKind::EXECUTION, std::nullopt, TaskType::IMAGE_PROCESSING).count() == 0);
+    scheduler.shutdown();
+
+    std::cout << "Count test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：多个线程同时递增同一个计数：互斥锁保护、共享原子变量与按线程分片的对比
+bool benchmarkIncrements(int threadCount, size_t increments) {
+    std::cout << "\n=== Test 2: " << threadCount << " threads x " << increments << " increments ===" << std::endl;
+
+    auto run = [&](const char* name, const std::function<void()>& increment) {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&] {
+                for (size_t i = 0; i < increments; ++i) {
+                    increment();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                    (static_cast<double>(increments) * threadCount);
+        std::cout << name << ns << " ns per increment" << std::endl;
+        return ns;
+    };
+
+    std::mutex mutex;
+    size_t locked = 0;
+    double mutexNs = run("Mutex:         ", [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        locked++;
+    });
+
+    std::atomic<size_t> shared{0};
+    double atomicNs = run("Shared atomic: ", [&] { shared.fetch_add(1, std::memory_order_relaxed); });
+
+    MetricCounters counters;
+    double shardedNs = run("Sharded:       ", [&] { counters.add(Metric::TASKS_COMPLETED); });
+
+    size_t expected = increments * threadCount;
+    assert(locked == expected && shared == expected);
+    assert(counters.snapshot()[static_cast<size_t>(Metric::TASKS_COMPLETED)] == expected);
+    assert(shardedNs < mutexNs);
+
+    std::cout << "Sharded vs mutex: " << mutexNs / shardedNs << "x, vs shared atomic: " << atomicNs / shardedNs << "x"
+              << std::endl;
+    std::cout << "Increment benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：多个生产者提交空任务，对比记录指标与关闭指标时的完成吞吐量
+bool benchmarkCompletionThroughput(int producers, size_t tasksPerProducer, size_t workers) {
+    std::cout << "\n=== Test 3: Completion throughput, " << producers << " producers x " << tasksPerProducer
+              << " tasks, " << workers << " workers ===" << std::endl;
+
+    auto run = [&](bool collectMetrics) {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(counterConfig(workers, collectMetrics)));
+
+        std::vector<std::thread> threads;
+        std::vector<std::vector<TaskID>> ids(producers);
+        auto start = std::chrono::steady_clock::now();
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                ids[p].reserve(tasksPerProducer);
+                for (size_t i = 0; i < tasksPerProducer; ++i) {
+                    ids[p].push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& batch : ids) {
+            scheduler.waitForTasks(batch);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double rate = producers * tasksPerProducer / seconds;
+
+        PerformanceMetrics metrics = scheduler.getPerformanceMetrics();
+        size_t expected = collectMetrics ? producers * tasksPerProducer : 0;
+        assert(metrics.totalTasksSubmitted == expected);
+        assert(metrics.totalTasksCompleted == expected);
+        scheduler.shutdown();
+
+        std::cout << (collectMetrics ? "Metrics on:  " : "Metrics off: ") << rate << " tasks/s" << std::endl;
+        return rate;
+    };
+
+    // 交替运行，各取最好的一次，减少先后顺序和调度抖动的影响
+    double off = 0.0;
+    double on = 0.0;
+    for (int round = 0; round < 2; ++round) {
+        off = std::max(off, run(false));
+        on = std::max(on, run(true));
+    }
+    std::cout << "Metrics overhead: " << (off / on - 1) * 100 << " %" << std::endl;
+
+    std::cout << "Completion throughput benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_metric_counters [线程数] [每线程递增次数] [每个生产者的任务数] [工作线程数]
+int main(int argc, char** argv) {
+    std::cout << "=== Metric Counter Tests ===" << std::endl;
+
+    int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    size_t increments = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000000;
+    size_t tasks = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 25000;
+    size_t workers = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 4;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testCounts()) passed++;
+    if (benchmarkIncrements(threads, increments)) passed++;
+    if (benchmarkCompletionThroughput(threads, tasks, workers)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+#include "../include/TaskScheduler.h"
+#include "../include/ThreadPool.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+SchedulerConfig nestedConfig(size_t threads) {
+    SchedulerConfig config = testConfig(threads);
+    config.maxCompensationThreads = 0;  // 不依赖补偿线程，验证线程数有界
+    return config;
+}
+
+// 递归fib：每层提交两个子任务并等待，子任务把结果写回父任务的栈上
+void fibTask(TaskScheduler& scheduler, int n, long* out, std::atomic<long>& tasks) {
+    tasks++;
+    if (n < 2) {
+        *out = n;
+        return;
+    }
+
+    long a = 0;
+    long b = 0;
+    TaskID left = scheduler.submitTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&scheduler, n, &a, &tasks] {
+        fibTask(scheduler, n - 1, &a, tasks);
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    TaskID right = scheduler.submitTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&scheduler, n, &b, &tasks] {
+        fibTask(scheduler, n - 2, &b, tasks);
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+
+    for (const auto& result : scheduler.waitForTasks({left, right})) {
+        assert(result.status == ResultStatus::SUCCESS);
+    }
+    *out = a + b;
+}
+
+long serialFib(int n) {
+    return n < 2 ? n : serialFib(n - 1) + serialFib(n - 2);
+}
+
+// 测试1：等待中的工作线程帮忙执行，递归深度远超线程数也不会死锁
+bool testRecursiveFib(int n) {
+    std::cout << "\n=== Test 1: Recursive fib(" << n << ") on 2 workers ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(nestedConfig(2)));
+
+    std::atomic<long> tasks{0};
+    long value = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    TaskID root = scheduler.submitTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&] {
+        fibTask(scheduler, n, &value, tasks);
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    TaskResult result = scheduler.waitForTask(root, 60000ms);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    assert(result.status == ResultStatus::SUCCESS);
+    assert(value == serialFib(n));
+    // 进程内只有这个调度器的2个工作线程，没有新建补偿线程
+    assert(ThreadPool::getProcessThreadCount() <= 2);
+
+    auto metrics = scheduler.getPerformanceMetrics();
+    std::cout << "fib(" << n << ") = " << value << ", tasks: " << tasks << ", depth: " << n
+              << ", time: " << elapsed << " ms (" << elapsed * 1000 / tasks << " us/task)" << std::endl;
+    std::cout << "Run inline while waiting: " << metrics.totalTasksRunInline << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Recursive fib test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 四叉树分治：对图像区域求和，区域大于叶子尺寸时拆成四个子任务
+void quadTask(TaskScheduler& scheduler, const std::vector<uint8_t>& image, size_t width,
+              size_t x, size_t y, size_t size, size_t leaf, uint64_t* out) {
+    if (size <= leaf) {
+        uint64_t sum = 0;
+        for (size_t row = y; row < y + size; ++row) {
+            for (size_t col = x; col < x + size; ++col) {
+                sum += image[row * width + col];
+            }
+        }
+        *out = sum;
+        return;
+    }
+
+    size_t half = size / 2;
+    uint64_t sums[4] = {0, 0, 0, 0};
+    std::vector<TaskID> children;
+    for (int quadrant = 0; quadrant < 4; ++quadrant) {
+        size_t cx = x + (quadrant % 2) * half;
+        size_t cy = y + (quadrant / 2) * half;
+        uint64_t* slot = &sums[quadrant];
+        children.push_back(scheduler.submitTask(TaskType::IMAGE_PROCESSING, Priority::NORMAL,
+            [&scheduler, &image, width, cx, cy, half, leaf, slot] {
+                quadTask(scheduler, image, width, cx, cy, half, leaf, slot);
+                return TaskResult(0, ResultStatus::SUCCESS);
+            }));
+    }
+    scheduler.waitForTasks(children);
+    *out = sums[0] + sums[1] + sums[2] + sums[3];
+}
+
+// 测试2：四叉树递归
+bool testQuadTree(size_t size, size_t leaf) {
+    size_t depth = 0;
+    for (size_t s = size; s > leaf; s /= 2) {
+        depth++;
+    }
+    std::cout << "\n=== Test 2: Quad-tree " << size << "x" << size << " to " << leaf << "x" << leaf
+              << " (depth " << depth << ") on 2 workers ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(nestedConfig(2)));
+
+    std::vector<uint8_t> image(size * size);
+    uint64_t expected = 0;
+    for (size_t i = 0; i < image.size(); ++i) {
+        image[i] = static_cast<uint8_t>(i * 31 + 7);
+        expected += image[i];
+    }
+
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    TaskID root = scheduler.submitTask(TaskType::IMAGE_PROCESSING, Priority::NORMAL, [&] {
+        quadTask(scheduler, image, size, 0, 0, size, leaf, &sum);
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    assert(scheduler.waitForTask(root, 60000ms).status == ResultStatus::SUCCESS);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    assert(sum == expected);
+    std::cout << "Sum: " << sum << ", time: " << elapsed << " ms" << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Quad-tree test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：不在任务中等待时不帮忙执行无关任务
+bool testExternalWaitDoesNotHelp() {
+    std::cout << "\n=== Test 3: External waits only run awaited tasks ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(nestedConfig(1)));
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> gate{false};
+    TaskID blocker = scheduler.submitTask(TaskType::USER_DEFINED, Priority::CRITICAL, [&] {
+        started = true;
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    TaskID unrelated = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [] {
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+
+    // 正在运行的任务只能等待，且不会把无关任务拉到调用线程上
+    assert(scheduler.waitForTask(blocker, 30ms).status == ResultStatus::TIMEOUT);
+    assert(scheduler.getTaskStatus(unrelated) == TaskStatus::PENDING);
+
+    gate = true;
+    auto results = scheduler.waitForTasks({blocker, unrelated});
+    assert(results[0].status == ResultStatus::SUCCESS);
+    assert(results[1].status == ResultStatus::SUCCESS);
+    assert(results[1].taskId == unrelated);
+
+    // 已在调用线程上执行的任务在队列中留下的旧条目不会被再次执行
+    std::this_thread::sleep_for(150ms);
+    assert(scheduler.getPerformanceMetrics().totalTasksCompleted == 2);
+
+    scheduler.shutdown();
+    std::cout << "External wait test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_nested_parallelism [fib的n] [四叉树边长]
+int main(int argc, char** argv) {
+    std::cout << "=== Nested Parallelism Tests ===" << std::endl;
+
+    int fibN = argc > 1 ? std::atoi(argv[1]) : 16;
+    size_t quadSize = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 512;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testRecursiveFib(fibN)) passed++;
+    if (testQuadTree(quadSize, 8)) passed++;
+    if (testExternalWaitDoesNotHelp()) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+#include "../include/TaskScheduler.h"
+#include "../include/ThreadPool.h"
+#include "../include/ParallelAlgorithms.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <numeric>
+#include <random>
+#include <set>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+std::vector<uint64_t> randomData(size_t count, uint64_t seed) {
+    std::vector<uint64_t> data(count);
+    std::mt19937_64 random(seed);
+    for (auto& value : data) {
+        value = random() % 1000000;
+    }
+    return data;
+}
+
+// 测试1：各算法结果与串行std::版本一致
+bool testMatchesSerial() {
+    std::cout << "\n=== Test 1: Results match serial std:: algorithms ===" << std::endl;
+
+    ThreadPool pool(3);
+    ParallelPolicy policy(pool);
+    policy.grainSize = 1000;
+
+    for (size_t count : {0ul, 1ul, 999ul, 1000ul, 123457ul}) {
+        auto data = randomData(count, count);
+
+        // transform
+        std::vector<uint64_t> expected(count), actual(count);
+        std::transform(data.begin(), data.end(), expected.begin(), [](uint64_t v) { return v * 3 + 1; });
+        parallelTransform(policy, data.begin(), data.end(), actual.begin(), [](uint64_t v) { return v * 3 + 1; });
+        assert(actual == expected);
+
+        // reduce / transform_reduce
+        assert(parallelReduce(policy, data.begin(), data.end(), uint64_t(7)) ==
+               std::reduce(data.begin(), data.end(), uint64_t(7)));
+        assert(parallelTransformReduce(policy, data.begin(), data.end(), uint64_t(0), std::plus<>(),
+                                       [](uint64_t v) { return v % 13; }) ==
+               std::transform_reduce(data.begin(), data.end(), uint64_t(0), std::plus<>(),
+                                     [](uint64_t v) { return v % 13; }));
+
+        // inclusive_scan
+        std::inclusive_scan(data.begin(), data.end(), expected.begin());
+        parallelInclusiveScan(policy, data.begin(), data.end(), actual.begin());
+        assert(actual == expected);
+
+        // sort（含大量重复值）
+        auto sorted = data;
+        std::sort(sorted.begin(), sorted.end());
+        parallelSort(policy, data.begin(), data.end());
+        assert(data == sorted);
+
+        std::vector<int> duplicates(count, 5);
+        parallelSort(policy, duplicates.begin(), duplicates.end(), std::greater<>());
+        assert(std::all_of(duplicates.begin(), duplicates.end(), [](int v) { return v == 5; }));
+    }
+
+    std::cout << "Serial equivalence test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：分块继承提交任务的优先级
+bool testPriorityInheritance() {
+    std::cout << "\n=== Test 2: Chunks inherit the task priority ===" << std::endl;
+
+    SchedulerConfig config;
+    config.minThreads = 1;
+    config.enableLoadBalancing = false;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    ThreadPool pool(3);
+    std::mutex mutex;
+    std::set<Priority> seen;
+    std::set<std::thread::id> threads;
+
+    TaskResult result = scheduler.waitForTask(scheduler.submitTask(TaskType::DATA_ANALYSIS, Priority::HIGH, [&] {
+        ParallelPolicy policy(pool);
+        policy.grainSize = 1;
+        assert(policy.priority == Priority::HIGH);
+
+        parallelFor(policy, 64, [&](size_t, size_t) {
+            std::this_thread::sleep_for(1ms);
+            std::lock_guard<std::mutex> lock(mutex);
+            seen.insert(currentTaskPriority());
+            threads.insert(std::this_thread::get_id());
+        });
+        return TaskResult(0, ResultStatus::SUCCESS);
+    }));
+    assert(result.status == ResultStatus::SUCCESS);
+
+    assert(seen.size() == 1 && *seen.begin() == Priority::HIGH);
+    std::cout << "Chunks ran on " << threads.size() << " threads" << std::endl;
+
+    // 任务外默认为NORMAL
+    assert(ParallelPolicy().priority == Priority::NORMAL);
+
+    scheduler.shutdown();
+    std::cout << "Priority inheritance test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：分块中的异常传回调用线程
+bool testExceptionPropagation() {
+    std::cout << "\n=== Test 3: Exception propagation ===" << std::endl;
+
+    ThreadPool pool(2);
+    ParallelPolicy policy(pool);
+    policy.grainSize = 10;
+
+    bool caught = false;
+    try {
+        parallelFor(policy, 1000, [](size_t begin, size_t) {
+            if (begin >= 500) {
+                throw std::runtime_error("chunk failed");
+            }
+        });
+    } catch (const std::runtime_error& e) {
+        caught = std::string(e.what()) == "chunk failed";
+    }
+    assert(caught);
+
+    // 线程池仍可继续使用
+    std::vector<int> data(1000, 1);
+    assert(parallelReduce(policy, data.begin(), data.end(), 0) == 1000);
+
+    std::cout << "Exception propagation test PASSED ✓" << std::endl;
+    return true;
+}
+
+template<typename F>
+double timeMs(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 测试4：与串行std::版本的性能对比
+bool benchmarkAgainstSerial(size_t count) {
+    std::cout << "\n=== Test 4: Parallel vs serial on " << count << " elements ===" << std::endl;
+    std::cout << "Helper threads: " << defaultParallelPool().getPoolSize() << " (+ caller)" << std::endl;
+
+    ParallelPolicy policy;
+    auto data = randomData(count, 42);
+    std::vector<uint64_t> output(count);
+
+    auto report = [](const char* name, double serial, double parallel) {
+        std::cout << name << " serial: " << serial << " ms, parallel: " << parallel
+                  << " ms, speedup: " << serial / parallel << "x" << std::endl;
+    };
+
+    auto square = [](uint64_t v) { return v * v; };
+    report("transform:       ",
+           timeMs([&] { std::transform(data.begin(), data.end(), output.begin(), square); }),
+           timeMs([&] { parallelTransform(policy, data.begin(), data.end(), output.begin(), square); }));
+
+    uint64_t serialSum = 0, parallelSum = 0;
+    report("transform_reduce:",
+           timeMs([&] { serialSum = std::transform_reduce(data.begin(), data.end(), uint64_t(0), std::plus<>(), square); }),
+           timeMs([&] { parallelSum = parallelTransformReduce(policy, data.begin(), data.end(), uint64_t(0), std::plus<>(), square); }));
+    assert(serialSum == parallelSum);
+
+    report("inclusive_scan:  ",
+           timeMs([&] { std::inclusive_scan(data.begin(), data.end(), output.begin()); }),
+           timeMs([&] { parallelInclusiveScan(policy, data.begin(), data.end(), output.begin()); }));
+
+    auto copy = data;
+    report("sort:            ",
+           timeMs([&] { std::sort(copy.begin(), copy.end()); }),
+           timeMs([&] { parallelSort(policy, data.begin(), data.end()); }));
+    assert(copy == data);
+
+    std::cout << "Parallel algorithms benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_parallel_algorithms [元素数量]
+// 10M～1B规模的对比需要按元素数量准备足够内存（每元素8字节，排序需两倍）
+int main(int argc, char** argv) {
+    std::cout << "=== Parallel Algorithms Tests ===" << std::endl;
+
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+    int passed = 0;
+    int total = 4;
+
+    if (testMatchesSerial()) passed++;
+    if (testPriorityInheritance()) passed++;
+    if (testExceptionPropagation()) passed++;
+    if (benchmarkAgainstSerial(count)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
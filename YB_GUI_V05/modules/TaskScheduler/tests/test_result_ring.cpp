@@ -0,0 +1,297 @@
+#include "../include/TaskScheduler.h"
+#include "../include/ResultRing.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <unordered_set>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+SchedulerConfig ringConfig(size_t capacity) {
+    SchedulerConfig config = testConfig(2);
+    config.completedResultCapacity = capacity;
+    return config;
+}
+
+TaskResult payload(int index) {
+    TaskResult result(0, ResultStatus::SUCCESS);
+    result.result = std::string("frame-") + std::to_string(index);
+    return result;
+}
+
+// 测试1：每个游标只读到上次之后的新结果，drain每个结果只交出一次，环写满后覆盖最早的结果
+bool testCursors() {
+    std::cout << "\n=== Test 1: Cursors see only new completions ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(ringConfig(16)));
+
+    auto submitBatch = [&scheduler](int count) {
+        std::vector<TaskID> ids;
+        for (int i = 0; i < count; ++i) {
+            ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [i] { return payload(i); }));
+        }
+        scheduler.waitForTasks(ids);
+        return ids;
+    };
+    auto collect = [](std::vector<TaskID>& seen) {
+        return [&seen](const TaskResult& result) { seen.push_back(result.taskId); };
+    };
+
+    ResultCursor early;
+    std::vector<TaskID> first = submitBatch(10);
+    ResultCursor late = scheduler.completedTasksCursor();
+
+    // 默认游标从环中最早的结果开始，completedTasksCursor只看到之后的结果
+    std::vector<TaskID> seen;
+    assert(scheduler.readCompletedTasks(early, collect(seen)) == 10);
+    assert(std::unordered_set<TaskID>(seen.begin(), seen.end()) == std::unordered_set<TaskID>(first.begin(), first.end()));
+    assert(scheduler.readCompletedTasks(late, collect(seen)) == 0);
+    assert(scheduler.readCompletedTasks(early, collect(seen)) == 0);
+
+    // 两个读取方各自读到同样的新结果；maxResults限制单次读取的个数
+    std::vector<TaskID> second = submitBatch(6);
+    std::vector<TaskID> a, b;
+    assert(scheduler.readCompletedTasks(early, collect(a), 4) == 4);
+    assert(scheduler.readCompletedTasks(early, collect(a)) == 2);
+    assert(scheduler.readCompletedTasks(late, collect(b)) == 6);
+    assert(a == b);
+    assert(std::unordered_set<TaskID>(a.begin(), a.end()) == std::unordered_set<TaskID>(second.begin(), second.end()));
+
+    // drain使用调度器内部的游标，结果只交出一次
+    std::vector<TaskID> drained;
+    assert(scheduler.drainCompletedTasks(collect(drained)) == 16);
+    assert(scheduler.drainCompletedTasks(collect(drained)) == 0);
+
+    // 环容量为16：落后的游标跳过被覆盖的结果并计数，完成列表只保留最近的16个
+    submitBatch(40);
+    assert(scheduler.getCompletedTasks().size() == 16);
+    std::vector<TaskID> lapped;
+    assert(scheduler.readCompletedTasks(early, collect(lapped)) == 16);
+    assert(early.missed == 24);
+    assert(scheduler.drainCompletedTasks(collect(lapped)) == 16);
+
+    // 被覆盖的结果只能查到状态
+    assert(scheduler.waitForTask(first.front()).status == ResultStatus::SUCCESS);
+    assert(!scheduler.waitForTask(first.front()).result.has_value());
+
+    // 清空后游标从下一个结果开始，不计为丢失
+    scheduler.clearCompletedTasks();
+    assert(scheduler.getCompletedTasks().empty());
+    std::vector<TaskID> third = submitBatch(3);
+    std::vector<TaskID> afterClear;
+    assert(scheduler.readCompletedTasks(late, collect(afterClear)) == 3);
+    assert(late.missed == 0);
+
+    scheduler.shutdown();
+    std::cout << "Cursor test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：生产者按目标速率提交带字符串结果的小任务，GUI线程每16.7ms读取一次新完成的结果。
+// 对照做法：每帧getCompletedTasks复制整个完成列表，再按已处理的ID过滤
+bool benchmarkGuiReader(double seconds, size_t rate) {
+    std::cout << "\n=== Test 2: 60 Hz GUI reader vs " << rate << " completions/s (" << seconds << " s) ===" << std::endl;
+
+    auto run = [seconds, rate](bool useCursor) {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(ringConfig(8192)));
+
+        std::atomic<bool> producing{true};
+        std::vector<TaskID> submitted;
+        std::thread producer([&] {
+            auto start = std::chrono::steady_clock::now();
+            size_t issued = 0;
+            while (true) {
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (elapsed >= seconds) {
+                    break;
+                }
+                size_t due = static_cast<size_t>(elapsed * rate);
+                for (; issued < due; ++issued) {
+                    int index = static_cast<int>(issued);
+                    submitted.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL,
+                                                             [index] { return payload(index); }));
+                }
+                std::this_thread::sleep_for(200us);
+            }
+            producing = false;
+        });
+
+        // GUI线程：每帧处理新完成的结果
+        ResultCursor cursor = scheduler.completedTasksCursor();
+        std::unordered_set<TaskID> handled;
+        size_t delivered = 0;
+        size_t copied = 0;
+        size_t frames = 0;
+        double readMs = 0;
+        double worstMs = 0;
+        auto frame = [&] {
+            auto begin = std::chrono::steady_clock::now();
+            if (useCursor) {
+                delivered += scheduler.readCompletedTasks(cursor, [&](const TaskResult& result) {
+                    assert(!std::any_cast<const std::string&>(result.result).empty());
+                });
+            } else {
+                std::vector<TaskResult> results = scheduler.getCompletedTasks();
+                copied += results.size();
+                for (const auto& result : results) {
+                    if (handled.insert(result.taskId).second) {
+                        delivered++;
+                    }
+                }
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+            readMs += ms;
+            worstMs = std::max(worstMs, ms);
+            frames++;
+        };
+        while (producing) {
+            frame();
+            std::this_thread::sleep_for(std::chrono::microseconds(16667));
+        }
+        producer.join();
+        scheduler.waitForTasks(submitted);
+        frame();
+
+        std::cout << (useCursor ? "Cursor read:       " : "getCompletedTasks: ")
+                  << submitted.size() / seconds << " completions/s, " << readMs / frames << " ms/frame (worst "
+                  << worstMs << " ms), " << delivered << " delivered, " << cursor.missed << " missed, "
+                  << copied << " results copied" << std::endl;
+
+        if (useCursor) {
+            // 每个完成结果恰好交出一次（或在落后一整圈时计为丢失），读取时不复制结果
+            assert(delivered + cursor.missed == submitted.size());
+            assert(copied == 0);
+        } else {
+            assert(copied >= delivered);
+        }
+        scheduler.shutdown();
+        return readMs / frames;
+    };
+
+    double copyMs = run(false);
+    double cursorMs = run(true);
+    std::cout << "Per-frame speedup: " << copyMs / cursorMs << "x" << std::endl;
+
+    std::cout << "GUI reader benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 结果析构时计数，用来确认被覆盖的结果交还给写入方、由写入方销毁
+struct Tracked {
+    std::atomic<size_t>* destroyed;
+    TaskID id;
+    ~Tracked() { destroyed->fetch_add(1); }
+};
+
+// 测试3：一个写入方持续覆盖环，多个读取方同时按ID查找和按游标读取；
+// 读到的结果与任务ID一致，被覆盖的结果由push交还，写入方释放前不会被销毁
+bool testConcurrentReaders() {
+    std::cout << "\n=== Test 3: Concurrent readers and evicted results ===" << std::endl;
+
+    std::atomic<size_t> destroyed{0};
+    auto tracked = [&destroyed](TaskID id) {
+        TaskResult result(id, ResultStatus::SUCCESS);
+        result.result = std::shared_ptr<Tracked>(new Tracked{&destroyed, id});
+        return result;
+    };
+
+    {
+        ResultRing ring(64);
+        assert(ring.capacity() == 64);
+
+        // 写满之前没有被覆盖的结果；之后每次push交还最早的结果，调用方持有期间不会被销毁
+        for (TaskID id = 1; id <= 64; ++id) {
+            assert(!ring.push(tracked(id)));
+        }
+        auto evicted = ring.push(tracked(65));
+        assert(evicted);
+        auto evictedResult = std::static_pointer_cast<const TaskResult>(evicted);
+        assert(evictedResult->taskId == 1);
+        assert(!ring.find(1));
+        assert(destroyed == 0);
+        evicted.reset();
+        evictedResult.reset();
+        assert(destroyed == 1);
+
+        const TaskID total = 200000;
+        std::atomic<bool> writing{true};
+        std::atomic<size_t> found{0};
+        std::atomic<size_t> delivered{0};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&, r] {
+                ResultCursor cursor;
+                uint64_t seed = r + 1;
+                while (writing) {
+                    // 按ID查找最近写入的结果
+                    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                    uint64_t head = ring.head();
+                    TaskID id = static_cast<TaskID>(head - (seed >> 58));
+                    if (auto result = ring.find(id)) {
+                        assert(result->taskId == id);
+                        assert(std::any_cast<const std::shared_ptr<Tracked>&>(result->result)->id == id);
+                        found++;
+                    }
+                    // 按游标读取，ID随序号递增
+                    TaskID last = 0;
+                    delivered += ring.read(cursor, [&last](const TaskResult& result) {
+                        assert(result.taskId > last);
+                        assert(std::any_cast<const std::shared_ptr<Tracked>&>(result.result)->id == result.taskId);
+                        last = result.taskId;
+                    }, 32);
+                }
+            });
+        }
+
+        size_t returned = 1;
+        for (TaskID id = 66; id <= total; ++id) {
+            auto old = ring.push(tracked(id));
+            assert(old && std::static_pointer_cast<const TaskResult>(old)->taskId == id - 64);
+            returned++;
+        }
+        writing = false;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        // 读取方已释放复制的指针：被覆盖的结果全部已销毁，环中只剩最近的64个
+        assert(destroyed == returned);
+        assert(ring.snapshot().size() == 64);
+        assert(ring.clear().size() == 64);
+        assert(destroyed == total);
+        std::cout << found.load() << " lookups and " << delivered.load() << " cursor reads during "
+                  << total << " pushes" << std::endl;
+    }
+
+    std::cout << "Concurrent reader test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_result_ring [秒数] [每秒完成数]
+int main(int argc, char** argv) {
+    std::cout << "=== Completed Result Ring Tests ===" << std::endl;
+
+    double seconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+    size_t rate = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testCursors()) passed++;
+    if (benchmarkGuiReader(seconds, rate)) passed++;
+    if (testConcurrentReaders()) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+#include "../include/TaskScheduler.h"
+#include "../include/ThreadPool.h"
+#include "../include/SharedExecutor.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 等待条件成立（带超时）
+template<typename Predicate>
+bool waitUntil(Predicate pred, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+// 测试1：两个调度器共享执行器，各自保留独立的指标
+bool testSeparateMetrics() {
+    std::cout << "\n=== Test 1: Schedulers keep separate metrics ===" << std::endl;
+
+    auto executor = std::make_shared<SharedExecutor>(2);
+
+    SchedulerConfig config;
+    config.sharedExecutor = executor;
+    config.enableLoadBalancing = false;
+
+    TaskScheduler schedulerA;
+    TaskScheduler schedulerB;
+    assert(schedulerA.initialize(config));
+    assert(schedulerB.initialize(config));
+
+    std::atomic<int> doneA{0};
+    std::atomic<int> doneB{0};
+
+    for (int i = 0; i < 20; ++i) {
+        schedulerA.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&doneA] {
+            doneA++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+    for (int i = 0; i < 5; ++i) {
+        schedulerB.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&doneB] {
+            doneB++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+
+    assert(waitUntil([&] { return doneA == 20 && doneB == 5; }, 3000ms));
+    assert(waitUntil([&] {
+        return schedulerA.getPerformanceMetrics().totalTasksCompleted == 20 &&
+               schedulerB.getPerformanceMetrics().totalTasksCompleted == 5;
+    }, 3000ms));
+
+    auto metrics = executor->getMetrics();
+    assert(metrics.attachedSources == 2);
+    assert(metrics.tasksExecuted == 25);
+    assert(metrics.poolThreads <= metrics.maxThreads + executor->getThreadPool().getCompensationThreads());
+
+    schedulerA.shutdown();
+    schedulerB.shutdown();
+    assert(executor->getMetrics().attachedSources == 0);
+
+    std::cout << "Separate metrics test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：一个调度器积压大量任务时，另一个调度器的任务不会被饿死
+bool testFairness() {
+    std::cout << "\n=== Test 2: Round-robin fairness between schedulers ===" << std::endl;
+
+    auto executor = std::make_shared<SharedExecutor>(1);
+
+    SchedulerConfig config;
+    config.sharedExecutor = executor;
+    config.enableLoadBalancing = false;
+
+    TaskScheduler flooder;
+    TaskScheduler victim;
+    assert(flooder.initialize(config));
+    assert(victim.initialize(config));
+
+    const int FLOOD_TASKS = 200;
+    const int VICTIM_TASKS = 10;
+    std::atomic<int> floodDone{0};
+    std::atomic<int> victimDone{0};
+    std::atomic<int> floodDoneWhenVictimFinished{-1};
+
+    // 积压任务先提交，受害者的任务排在其后
+    for (int i = 0; i < FLOOD_TASKS; ++i) {
+        flooder.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&floodDone] {
+            std::this_thread::sleep_for(1ms);
+            floodDone++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+    for (int i = 0; i < VICTIM_TASKS; ++i) {
+        victim.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&] {
+            std::this_thread::sleep_for(1ms);
+            if (++victimDone == VICTIM_TASKS) {
+                floodDoneWhenVictimFinished = floodDone.load();
+            }
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+
+    assert(waitUntil([&] { return floodDone == FLOOD_TASKS && victimDone == VICTIM_TASKS; }, 10000ms));
+
+    // 轮转取任务时，受害者的任务应在积压任务完成前早早结束
+    std::cout << "Flood tasks finished when victim completed: "
+              << floodDoneWhenVictimFinished << "/" << FLOOD_TASKS << std::endl;
+    assert(floodDoneWhenVictimFinished < FLOOD_TASKS / 2);
+
+    flooder.shutdown();
+    victim.shutdown();
+
+    std::cout << "Fairness test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：多个调度器各自建线程池与共享执行器的进程线程数对比
+bool benchmarkOversubscription(size_t numSchedulers) {
+    std::cout << "\n=== Test 3: Oversubscription with " << numSchedulers << " schedulers ===" << std::endl;
+
+    size_t baseline = ThreadPool::getProcessThreadCount();
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+
+    SchedulerConfig config;
+    config.minThreads = 4;
+    config.enableLoadBalancing = false;
+
+    size_t ownPoolThreads = 0;
+    {
+        std::vector<std::unique_ptr<TaskScheduler>> schedulers;
+        for (size_t i = 0; i < numSchedulers; ++i) {
+            schedulers.push_back(std::make_unique<TaskScheduler>());
+            assert(schedulers.back()->initialize(config));
+        }
+        ownPoolThreads = ThreadPool::getProcessThreadCount() - baseline;
+        for (auto& scheduler : schedulers) {
+            scheduler->shutdown();
+        }
+    }
+
+    size_t sharedThreads = 0;
+    {
+        auto executor = std::make_shared<SharedExecutor>(hardware);
+        SchedulerConfig sharedConfig = config;
+        sharedConfig.sharedExecutor = executor;
+
+        std::vector<std::unique_ptr<TaskScheduler>> schedulers;
+        for (size_t i = 0; i < numSchedulers; ++i) {
+            schedulers.push_back(std::make_unique<TaskScheduler>());
+            assert(schedulers.back()->initialize(sharedConfig));
+        }
+        sharedThreads = ThreadPool::getProcessThreadCount() - baseline;
+
+        auto metrics = executor->getMetrics();
+        assert(metrics.attachedSources == numSchedulers);
+
+        for (auto& scheduler : schedulers) {
+            scheduler->shutdown();
+        }
+    }
+
+    assert(sharedThreads == hardware);
+    assert(sharedThreads < ownPoolThreads);
+
+    std::cout << "Hardware threads: " << hardware << std::endl;
+    std::cout << "Own pools:        " << ownPoolThreads << " threads ("
+              << static_cast<double>(ownPoolThreads) / hardware << "x oversubscription)" << std::endl;
+    std::cout << "Shared executor:  " << sharedThreads << " threads ("
+              << static_cast<double>(sharedThreads) / hardware << "x oversubscription)" << std::endl;
+    std::cout << "Oversubscription benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_shared_executor [调度器数量]
+int main(int argc, char** argv) {
+    std::cout << "=== Shared Executor Tests ===" << std::endl;
+
+    size_t numSchedulers = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 6;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testSeparateMetrics()) passed++;
+    if (testFairness()) passed++;
+    if (benchmarkOversubscription(numSchedulers)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,312 @@
+#include "../include/TaskScheduler.h"
+#include "../include/SubmissionChannel.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+SchedulerConfig channelConfig(size_t threads) {
+    SchedulerConfig config = testConfig(threads);
+    config.maxCompensationThreads = 0;
+    return config;
+}
+
+// 在唯一的工作线程上放一个阻塞任务，返回后工作线程被占住直到gate置位
+void blockWorker(TaskScheduler& scheduler, std::atomic<bool>& gate) {
+    std::atomic<bool> started{false};
+    scheduler.submitTask(TaskType::USER_DEFINED, Priority::CRITICAL, [&] {
+        started = true;
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+void waitForOrder(std::mutex& mutex, const std::vector<int>& order, size_t expected) {
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (order.size() >= expected) {
+                return;
+            }
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+// 测试1：同一线程交替经通道和submitTask提交，单工作线程上按提交顺序执行
+bool testOrderingWithDirectSubmits() {
+    std::cout << "\n=== Test 1: Ordering across channel and direct submits ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(channelConfig(1)));
+    SubmissionChannel channel(scheduler);
+
+    // 提交期间占住工作线程，之后只由它按队列顺序执行
+    std::atomic<bool> gate{false};
+    blockWorker(scheduler, gate);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::vector<TaskID> ids;
+    for (int i = 0; i < 1000; ++i) {
+        auto record = [&, i] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+            return TaskResult(0, ResultStatus::SUCCESS);
+        };
+        // 每隔几个任务穿插一次直接提交
+        TaskID id = i % 7 == 3 ? scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, record)
+                               : channel.submit(TaskType::USER_DEFINED, Priority::NORMAL, record);
+        assert(id != 0);
+        ids.push_back(id);
+    }
+    for (size_t i = 1; i < ids.size(); ++i) {
+        assert(ids[i] > ids[i - 1]);
+    }
+
+    // 不用waitForTasks：调用线程帮忙执行会与工作线程并行
+    gate = true;
+    waitForOrder(mutex, order, 1000);
+    assert(order.size() == 1000);
+    assert(std::is_sorted(order.begin(), order.end()));
+    assert(channel.pending() == 0);
+    assert(channel.overflowCount() == 0);
+
+    scheduler.shutdown();
+    std::cout << "Ordering test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：缓冲区满时走慢路径，顺序不变
+bool testOverflow() {
+    std::cout << "\n=== Test 2: Overflow falls back without reordering ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(channelConfig(1)));
+    SubmissionChannel channel(scheduler, 3);
+    assert(channel.capacity() == 4);
+
+    std::atomic<bool> gate{false};
+    blockWorker(scheduler, gate);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    for (int i = 0; i < 20; ++i) {
+        TaskID id = channel.submit(TaskType::USER_DEFINED, Priority::NORMAL, [&, i] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+        assert(id != 0);
+    }
+    assert(channel.overflowCount() > 0);
+    assert(scheduler.getQueueStatus().pendingTasks + channel.pending() == 20);
+
+    gate = true;
+    waitForOrder(mutex, order, 20);
+    assert(order.size() == 20);
+    assert(std::is_sorted(order.begin(), order.end()));
+    std::cout << "Overflowed " << channel.overflowCount() << " times" << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Overflow test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：通道任务的状态查询、取消和关闭语义与直接提交一致
+bool testStatusAndCancel() {
+    std::cout << "\n=== Test 3: Status, cancel and shutdown ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(channelConfig(1)));
+
+    std::atomic<bool> gate{false};
+    blockWorker(scheduler, gate);
+
+    std::atomic<int> ran{0};
+    auto work = [&ran] {
+        ran++;
+        return TaskResult(0, ResultStatus::SUCCESS);
+    };
+    {
+        SubmissionChannel channel(scheduler);
+        TaskID first = channel.submit(TaskType::USER_DEFINED, Priority::NORMAL, work);
+        TaskID second = channel.submit(TaskType::USER_DEFINED, Priority::NORMAL, work);
+        assert(scheduler.getTaskStatus(first) == TaskStatus::PENDING);
+        assert(scheduler.cancelTask(second));
+        assert(scheduler.getTaskStatus(second) == TaskStatus::CANCELLED);
+
+        // 通道析构时尚未取出的任务照常执行
+        channel.submit(TaskType::USER_DEFINED, Priority::NORMAL, work);
+    }
+
+    gate = true;
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (ran < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    assert(ran == 2);
+
+    // 暂停或关闭后拒绝提交
+    SubmissionChannel channel(scheduler);
+    scheduler.pauseScheduling();
+    assert(channel.submit(TaskType::USER_DEFINED, Priority::NORMAL, work) == 0);
+    scheduler.resumeScheduling();
+    scheduler.shutdown();
+    assert(channel.submit(TaskType::USER_DEFINED, Priority::NORMAL, work) == 0);
+
+    std::cout << "Status and cancel test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试4：其他线程反复注册、注销通道（占用通道锁）时，经通道提交的任务不滞留在缓冲区中。
+// 只等待任务自己置位的标志，不调用会取出通道的waitForTask
+bool testDrainDuringChannelChurn(int rounds) {
+    std::cout << "\n=== Test 4: No stranded submits while channels attach and detach (" << rounds
+              << " rounds) ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(channelConfig(2)));
+    SubmissionChannel channel(scheduler);
+
+    std::atomic<bool> stop{false};
+    std::thread churn([&] {
+        while (!stop) {
+            SubmissionChannel other(scheduler, 16);
+        }
+    });
+
+    std::atomic<int> ran{0};
+    auto work = [&ran] {
+        ran++;
+        return TaskResult(0, ResultStatus::SUCCESS);
+    };
+    int stranded = 0;
+    for (int i = 0; i < rounds; ++i) {
+        assert(channel.submit(TaskType::USER_DEFINED, Priority::NORMAL, work) != 0);
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (ran <= i && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        if (ran <= i) {
+            stranded++;
+            break;
+        }
+    }
+
+    stop = true;
+    churn.join();
+    scheduler.shutdown();
+    assert(stranded == 0);
+
+    std::cout << ran.load() << " channel submits picked up without a second wake" << std::endl;
+    std::cout << "Channel churn test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试5：后台线程大量提交时，GUI线程经通道与submitTask提交的延迟对比
+bool benchmarkSubmitLatency(int guiSubmits, int backgroundProducers) {
+    std::cout << "\n=== Test 5: GUI submit latency (" << guiSubmits << " submits, " << backgroundProducers
+              << " background producers) ===" << std::endl;
+
+    auto run = [&](bool useChannel) {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(channelConfig(2)));
+        SubmissionChannel channel(scheduler);
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> producers;
+        // 后台任务总数不超过保留记录数的一半，最后仍能查到全部GUI任务的结果
+        const size_t budget = scheduler.getConfig().maxFinishedTaskRecords / 2 / backgroundProducers;
+        for (int p = 0; p < backgroundProducers; ++p) {
+            producers.emplace_back([&] {
+                for (size_t n = 0; n < budget && !stop; ++n) {
+                    scheduler.submitTask(TaskType::DATA_ANALYSIS, Priority::LOW, [] {
+                        return TaskResult(0, ResultStatus::SUCCESS);
+                    });
+                    // 限制积压，避免后台任务无限堆积
+                    if (scheduler.getPerformanceMetrics().currentQueueSize > 5000) {
+                        std::this_thread::sleep_for(1ms);
+                    }
+                }
+            });
+        }
+
+        std::vector<double> latencies;
+        latencies.reserve(guiSubmits);
+        std::vector<TaskID> ids;
+        ids.reserve(guiSubmits);
+        auto noop = [] {
+            return TaskResult(0, ResultStatus::SUCCESS);
+        };
+        for (int i = 0; i < guiSubmits; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            TaskID id = useChannel ? channel.submit(TaskType::USER_DEFINED, Priority::HIGH, noop)
+                                   : scheduler.submitTask(TaskType::USER_DEFINED, Priority::HIGH, noop);
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            assert(id != 0);
+            ids.push_back(id);
+            // GUI线程每帧提交少量任务
+            if (i % 16 == 15) {
+                std::this_thread::sleep_for(100us);
+            }
+        }
+
+        stop = true;
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        for (const auto& result : scheduler.waitForTasks(ids)) {
+            assert(result.status == ResultStatus::SUCCESS);
+        }
+        scheduler.shutdown();
+
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << (useChannel ? "Channel:     " : "submitTask:  ") << "p50 " << latencies[latencies.size() / 2]
+                  << " us, p99 " << latencies[latencies.size() * 99 / 100] << " us, max " << latencies.back()
+                  << " us" << std::endl;
+    };
+
+    run(false);
+    run(true);
+
+    std::cout << "Submit latency benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_submission_channel [GUI提交数] [后台生产者数]
+int main(int argc, char** argv) {
+    std::cout << "=== Submission Channel Tests ===" << std::endl;
+
+    int guiSubmits = argc > 1 ? std::atoi(argv[1]) : 5000;
+    int backgroundProducers = argc > 2 ? std::atoi(argv[2]) : 8;
+
+    int passed = 0;
+    int total = 5;
+
+    if (testOrderingWithDirectSubmits()) passed++;
+    if (testOverflow()) passed++;
+    if (testStatusAndCancel()) passed++;
+    if (testDrainDuringChannelChurn(20000)) passed++;
+    if (benchmarkSubmitLatency(guiSubmits, backgroundProducers)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
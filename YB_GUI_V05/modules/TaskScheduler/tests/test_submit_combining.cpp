@@ -0,0 +1,183 @@
+#include "../include/TaskScheduler.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <set>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+SchedulerConfig combiningConfig(bool combine) {
+    SchedulerConfig config = testConfig(2);
+    config.combineSubmissions = combine;
+    return config;
+}
+
+// 多个生产者并发提交，返回所有任务ID
+std::vector<TaskID> submitConcurrently(TaskScheduler& scheduler, int producers, int tasksPerProducer,
+                                       std::atomic<int>& done) {
+    std::vector<std::vector<TaskID>> ids(producers);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < tasksPerProducer; ++i) {
+                ids[p].push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&done] {
+                    done++;
+                    return TaskResult(0, ResultStatus::SUCCESS);
+                }));
+            }
+        });
+    }
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<TaskID> all;
+    for (const auto& producerIds : ids) {
+        all.insert(all.end(), producerIds.begin(), producerIds.end());
+    }
+    return all;
+}
+
+void waitForCount(const std::atomic<int>& done, int expected) {
+    auto deadline = std::chrono::steady_clock::now() + 30s;
+    while (done < expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+// 测试1：并发提交的任务全部登记、执行，ID唯一且每个生产者内递增
+bool testConcurrentProducers(int producers) {
+    std::cout << "\n=== Test 1: " << producers << " concurrent producers ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(combiningConfig(true)));
+
+    const int perProducer = 2000;
+    std::atomic<int> done{0};
+    auto ids = submitConcurrently(scheduler, producers, perProducer, done);
+
+    std::set<TaskID> unique(ids.begin(), ids.end());
+    assert(unique.size() == ids.size());
+    assert(unique.count(0) == 0);
+    for (int p = 0; p < producers; ++p) {
+        for (int i = 1; i < perProducer; ++i) {
+            assert(ids[p * perProducer + i] > ids[p * perProducer + i - 1]);
+        }
+    }
+
+    waitForCount(done, producers * perProducer);
+    assert(done == producers * perProducer);
+
+    auto metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.totalTasksSubmitted == static_cast<size_t>(producers * perProducer));
+    assert(metrics.totalSubmitBatches > 0 && metrics.totalSubmitBatches <= metrics.totalTasksSubmitted);
+    std::cout << "Average batch size: "
+              << static_cast<double>(metrics.totalTasksSubmitted) / metrics.totalSubmitBatches << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Concurrent producers test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：提交后的状态语义不变（立即可查为PENDING、可取消）
+bool testSubmitSemantics() {
+    std::cout << "\n=== Test 2: Status visible right after submit ===" << std::endl;
+
+    TaskScheduler scheduler;
+    SchedulerConfig config = combiningConfig(true);
+    config.minThreads = 1;
+    assert(scheduler.initialize(config));
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> gate{false};
+    scheduler.submitTask(TaskType::USER_DEFINED, Priority::CRITICAL, [&] {
+        started = true;
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    TaskID id = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [] {
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    assert(scheduler.getTaskStatus(id) == TaskStatus::PENDING);
+    assert(scheduler.cancelTask(id));
+
+    gate = true;
+    scheduler.shutdown();
+    std::cout << "Submit semantics test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：直接提交与合并提交在1～32个生产者下的扩展性
+bool benchmarkScaling(int totalTasks) {
+    std::cout << "\n=== Test 3: Submission scaling (" << totalTasks << " tasks) ===" << std::endl;
+
+    for (int producers : {1, 2, 4, 8, 16, 32}) {
+        double rates[2] = {0, 0};
+        double batchSize = 0;
+        for (int combine = 0; combine < 2; ++combine) {
+            TaskScheduler scheduler;
+            assert(scheduler.initialize(combiningConfig(combine == 1)));
+
+            std::atomic<int> done{0};
+            int perProducer = totalTasks / producers;
+            auto start = std::chrono::steady_clock::now();
+            submitConcurrently(scheduler, producers, perProducer, done);
+            auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            rates[combine] = producers * perProducer / elapsed;
+
+            waitForCount(done, producers * perProducer);
+            assert(done == producers * perProducer);
+
+            auto metrics = scheduler.getPerformanceMetrics();
+            if (combine) {
+                batchSize = static_cast<double>(metrics.totalTasksSubmitted) / metrics.totalSubmitBatches;
+            }
+            scheduler.shutdown();
+        }
+
+        std::cout << producers << " producers: direct " << static_cast<size_t>(rates[0])
+                  << " submits/s, combined " << static_cast<size_t>(rates[1]) << " submits/s ("
+                  << rates[1] / rates[0] << "x, avg batch " << batchSize << ")" << std::endl;
+    }
+
+    std::cout << "Submission scaling benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_submit_combining [任务数]
+int main(int argc, char** argv) {
+    std::cout << "=== Submit Combining Tests ===" << std::endl;
+
+    int totalTasks = argc > 1 ? std::atoi(argv[1]) : 64000;
+
+    int passed = 0;
+    int total = 4;
+
+    if (testConcurrentProducers(8)) passed++;
+    // 多于槽位数的生产者部分回退到直接提交
+    if (testConcurrentProducers(80)) passed++;
+    if (testSubmitSemantics()) passed++;
+    if (benchmarkScaling(totalTasks)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+#include "../include/TaskScheduler.h"
+#include "../include/TaskGraph.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 40个节点的逐帧图像流水线：解码 -> 8个分块各4级处理 -> 两两合并为一帧（8 -> 4 -> 2 -> 1）
+struct PipelineShape {
+    std::vector<std::pair<size_t, size_t>> edges;
+    size_t nodes = 0;
+};
+
+PipelineShape pipelineShape() {
+    PipelineShape shape;
+    size_t decode = shape.nodes++;
+    std::vector<size_t> level;
+    for (int tile = 0; tile < 8; ++tile) {
+        size_t previous = decode;
+        for (int stage = 0; stage < 4; ++stage) {
+            size_t node = shape.nodes++;
+            shape.edges.push_back({previous, node});
+            previous = node;
+        }
+        level.push_back(previous);
+    }
+    while (level.size() > 1) {
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            size_t node = shape.nodes++;
+            shape.edges.push_back({level[i], node});
+            shape.edges.push_back({level[i + 1], node});
+            merged.push_back(node);
+        }
+        level = merged;
+    }
+    return shape;
+}
+
+// 测试1：多次运行都按拓扑顺序执行每个节点一次，参数传给每个节点
+bool testRepeatedRuns() {
+    std::cout << "\n=== Test 1: Repeated runs in topological order ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(4)));
+
+    auto shape = pipelineShape();
+    assert(shape.nodes == 40);
+
+    std::vector<std::vector<size_t>> predecessors(shape.nodes);
+    for (auto [from, to] : shape.edges) {
+        predecessors[to].push_back(from);
+    }
+
+    // 每个节点记录最近运行的帧号，开始时检查所有前驱已处理同一帧
+    std::vector<std::atomic<int>> lastFrame(shape.nodes);
+    std::atomic<int> executions{0};
+    std::atomic<int> violations{0};
+
+    TaskGraph graph(scheduler);
+    for (size_t i = 0; i < shape.nodes; ++i) {
+        graph.addNode([&, i](const std::any& params) {
+            int frame = std::any_cast<int>(params);
+            for (size_t predecessor : predecessors[i]) {
+                if (lastFrame[predecessor] != frame) {
+                    violations++;
+                }
+            }
+            lastFrame[i] = frame;
+            executions++;
+        });
+    }
+    for (auto [from, to] : shape.edges) {
+        assert(graph.addEdge(from, to));
+    }
+    assert(!graph.addEdge(3, 3));
+    assert(!graph.addEdge(0, 40));
+
+    const int frames = 500;
+    for (int frame = 1; frame <= frames; ++frame) {
+        assert(graph.run(frame));
+        for (size_t i = 0; i < shape.nodes; ++i) {
+            assert(lastFrame[i] == frame);
+        }
+    }
+    assert(violations == 0);
+    assert(executions == frames * static_cast<int>(shape.nodes));
+
+    // 节点不登记状态
+    assert(scheduler.getPerformanceMetrics().totalTasksSubmitted == 0);
+
+    scheduler.shutdown();
+    std::cout << frames << " runs of " << shape.nodes << " nodes PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：节点失败跳过其后继、环和嵌套运行
+bool testFailureCycleAndNesting() {
+    std::cout << "\n=== Test 2: Failures, cycles and nested runs ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(1)));
+
+    // a -> b -> c，a -> d；b在奇数帧失败
+    std::atomic<int> ranA{0}, ranC{0}, ranD{0};
+    TaskGraph graph(scheduler);
+    auto a = graph.addNode([&](const std::any&) { ranA++; });
+    auto b = graph.addNode([](const std::any& params) {
+        if (std::any_cast<int>(params) % 2 == 1) {
+            throw std::runtime_error("stage b failed");
+        }
+    });
+    auto c = graph.addNode([&](const std::any&) { ranC++; });
+    auto d = graph.addNode([&](const std::any&) { ranD++; });
+    graph.addEdge(a, b);
+    graph.addEdge(b, c);
+    graph.addEdge(a, d);
+
+    assert(!graph.run(1));
+    assert(graph.lastError() == "stage b failed");
+    assert(ranA == 1 && ranC == 0 && ranD == 1);
+
+    // 失败不影响下一次运行
+    assert(graph.run(2));
+    assert(graph.lastError().empty());
+    assert(ranA == 2 && ranC == 1 && ranD == 2);
+
+    // 在唯一的工作线程上的任务中运行图：等待时帮忙执行节点，不会死锁
+    std::atomic<bool> nestedOk{false};
+    TaskID outer = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&] {
+        nestedOk = graph.run(4);
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    assert(scheduler.waitForTask(outer, 5000ms).status == ResultStatus::SUCCESS);
+    assert(nestedOk);
+    assert(ranC == 2);
+
+    // 有环的图不执行
+    TaskGraph cyclic(scheduler);
+    auto x = cyclic.addNode([&](const std::any&) { ranA++; });
+    auto y = cyclic.addNode([&](const std::any&) { ranA++; });
+    cyclic.addEdge(x, y);
+    cyclic.addEdge(y, x);
+    assert(!cyclic.run());
+    assert(cyclic.lastError() == "Task graph has a cycle");
+    assert(ranA == 3);
+
+    scheduler.shutdown();
+    assert(!graph.run(6));
+
+    std::cout << "Failure, cycle and nesting test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：每帧重新提交带依赖的任务与复用预建图的单节点开销
+bool benchmarkFrames(int frames, size_t threads) {
+    std::cout << "\n=== Test 3: 40-node frame graph (" << frames << " frames, " << threads << " workers) ===" << std::endl;
+
+    auto shape = pipelineShape();
+    const size_t nodes = shape.nodes;
+
+    auto report = [&](const char* name, double ms) {
+        std::cout << name << ms << " ms, " << ms * 1000.0 / frames << " us/frame, "
+                  << ms * 1e6 / (static_cast<double>(frames) * nodes) << " ns/node" << std::endl;
+    };
+
+    std::atomic<size_t> executed{0};
+
+    // 逐帧构建：每个节点分配Task、TaskID和状态，依赖列表每帧重建
+    double submitMs = 0;
+    {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(testConfig(threads)));
+        std::vector<std::vector<size_t>> predecessors(nodes);
+        for (auto [from, to] : shape.edges) {
+            predecessors[to].push_back(from);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            std::vector<TaskID> ids(nodes);
+            for (size_t i = 0; i < nodes; ++i) {
+                std::vector<TaskID> dependencies;
+                for (size_t predecessor : predecessors[i]) {
+                    dependencies.push_back(ids[predecessor]);
+                }
+                ids[i] = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&executed] {
+                    executed++;
+                    return TaskResult(0, ResultStatus::SUCCESS);
+                }, dependencies);
+            }
+            assert(scheduler.waitForTask(ids.back()).status == ResultStatus::SUCCESS);
+        }
+        submitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        scheduler.shutdown();
+    }
+    assert(executed == frames * nodes);
+    report("Per-frame submitTask: ", submitMs);
+
+    // 预建图：构建一次，每帧只重置计数
+    double graphMs = 0;
+    {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(testConfig(threads)));
+        TaskGraph graph(scheduler);
+        for (size_t i = 0; i < nodes; ++i) {
+            graph.addNode([&executed](const std::any&) { executed++; });
+        }
+        for (auto [from, to] : shape.edges) {
+            graph.addEdge(from, to);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            assert(graph.run(frame));
+        }
+        graphMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        scheduler.shutdown();
+    }
+    assert(executed == 2 * frames * nodes);
+    report("Reusable TaskGraph:   ", graphMs);
+    std::cout << "Speedup: " << submitMs / graphMs << "x" << std::endl;
+
+    std::cout << "Frame graph benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_task_graph [帧数] [工作线程数]
+int main(int argc, char** argv) {
+    std::cout << "=== Task Graph Tests ===" << std::endl;
+
+    int frames = argc > 1 ? std::atoi(argv[1]) : 2000;
+    size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testRepeatedRuns()) passed++;
+    if (testFailureCycleAndNesting()) passed++;
+    if (benchmarkFrames(frames, threads)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
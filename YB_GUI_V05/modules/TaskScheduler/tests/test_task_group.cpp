@@ -0,0 +1,261 @@
+#include "../include/TaskScheduler.h"
+#include "../include/TaskGroup.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 测试1：组等待与统计
+bool testGroupWaitAndStats() {
+    std::cout << "\n=== Test 1: Group wait and stats ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(2)));
+
+    std::atomic<int> ran{0};
+    TaskGroupStats stats;
+    {
+        TaskGroup group(scheduler);
+        for (int i = 0; i < 50; ++i) {
+            assert(group.run(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&ran] {
+                std::this_thread::sleep_for(1ms);
+                ran++;
+                return TaskResult(0, ResultStatus::SUCCESS);
+            }) != 0);
+        }
+        group.run(TaskType::DATA_ANALYSIS, Priority::NORMAL, []() -> TaskResult {
+            throw std::runtime_error("member failed");
+        });
+
+        group.wait();
+        stats = group.getStats();
+    }
+
+    assert(ran == 50);
+    assert(stats.submitted == 51);
+    assert(stats.completed == 50);
+    assert(stats.failed == 1);
+    assert(stats.pending == 0);
+    assert(stats.wallTime.count() > 0);
+    assert(stats.throughput > 0);
+
+    std::cout << "Wall time: " << stats.wallTime.count() << " ms, execution time: "
+              << stats.totalExecutionTime.count() << " ms, throughput: " << stats.throughput << " tasks/s"
+              << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Group wait test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：cancelAll一次移除所有排队成员
+bool testCancelAll() {
+    std::cout << "\n=== Test 2: cancelAll ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(1)));
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> gate{false};
+    scheduler.submitTask(TaskType::USER_DEFINED, Priority::CRITICAL, [&] {
+        started = true;
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    // 组外任务不受影响
+    TaskID outsider = scheduler.submitTask(TaskType::USER_DEFINED, Priority::LOW, [] {
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+
+    std::atomic<int> ran{0};
+    TaskGroup group(scheduler);
+    std::vector<TaskID> members;
+    for (int i = 0; i < 100; ++i) {
+        members.push_back(group.run(TaskType::USER_DEFINED, Priority::NORMAL, [&ran] {
+            ran++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        }));
+    }
+
+    assert(group.cancelAll() == 100);
+    assert(group.waitFor(0ms));
+    assert(group.getStats().cancelled == 100);
+    for (TaskID member : members) {
+        assert(scheduler.getTaskStatus(member) == TaskStatus::CANCELLED);
+    }
+    assert(scheduler.getTaskStatus(outsider) == TaskStatus::PENDING);
+
+    gate = true;
+    assert(scheduler.waitForTask(outsider).status == ResultStatus::SUCCESS);
+    assert(ran == 0);
+
+    scheduler.shutdown();
+    std::cout << "cancelAll test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：工作线程内的组等待帮忙执行，单线程也不会死锁
+bool testNestedGroup() {
+    std::cout << "\n=== Test 3: Nested group on a single worker ===" << std::endl;
+
+    TaskScheduler scheduler;
+    SchedulerConfig config = testConfig(1);
+    config.maxCompensationThreads = 0;
+    assert(scheduler.initialize(config));
+
+    std::atomic<int> leaves{0};
+    TaskID root = scheduler.submitTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&] {
+        TaskGroup outer(scheduler);
+        for (int i = 0; i < 4; ++i) {
+            outer.run(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&] {
+                TaskGroup inner(scheduler);
+                for (int k = 0; k < 4; ++k) {
+                    inner.run(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&leaves] {
+                        leaves++;
+                        return TaskResult(0, ResultStatus::SUCCESS);
+                    });
+                }
+                inner.wait();
+                return TaskResult(0, ResultStatus::SUCCESS);
+            });
+        }
+        outer.wait();
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+
+    assert(scheduler.waitForTask(root, 5000ms).status == ResultStatus::SUCCESS);
+    assert(leaves == 16);
+
+    scheduler.shutdown();
+    std::cout << "Nested group test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试4：调度器关闭时排队中的成员计为取消，组等待不会挂起
+bool testShutdownReleasesGroup() {
+    std::cout << "\n=== Test 4: Shutdown releases pending members ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(1)));
+
+    TaskGroup group(scheduler);
+    std::atomic<bool> gate{false};
+    group.run(TaskType::USER_DEFINED, Priority::CRITICAL, [&gate] {
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    });
+    for (int i = 0; i < 10; ++i) {
+        group.run(TaskType::USER_DEFINED, Priority::NORMAL, [] {
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+
+    std::thread releaser([&gate] {
+        std::this_thread::sleep_for(50ms);
+        gate = true;
+    });
+    std::this_thread::sleep_for(10ms);
+    scheduler.shutdown();
+    releaser.join();
+
+    assert(group.waitFor(1000ms));
+    auto stats = group.getStats();
+    assert(stats.completed + stats.cancelled == 11);
+
+    std::cout << "Completed: " << stats.completed << ", cancelled: " << stats.cancelled << std::endl;
+    std::cout << "Shutdown test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试5：逐个轮询getTaskStatus与组等待的对比
+bool benchmarkPollingVsGroup(int numTasks) {
+    std::cout << "\n=== Test 5: Polling vs group wait (" << numTasks << " tasks) ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(2)));
+
+    auto work = [] {
+        volatile int x = 0;
+        for (int i = 0; i < 1000; ++i) {
+            x = x + i;
+        }
+        return TaskResult(0, ResultStatus::SUCCESS);
+    };
+
+    // 现有方式：提交一批后循环轮询每个任务的状态
+    size_t polls = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<TaskID> ids;
+        for (int i = 0; i < numTasks; ++i) {
+            ids.push_back(scheduler.submitTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, work));
+        }
+        bool allDone = false;
+        while (!allDone) {
+            allDone = true;
+            for (TaskID id : ids) {
+                polls++;
+                TaskStatus status = scheduler.getTaskStatus(id);
+                if (status == TaskStatus::PENDING || status == TaskStatus::RUNNING) {
+                    allDone = false;
+                    break;
+                }
+            }
+        }
+    }
+    auto polling = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    {
+        TaskGroup group(scheduler);
+        for (int i = 0; i < numTasks; ++i) {
+            group.run(TaskType::DATA_ANALYSIS, Priority::NORMAL, work);
+        }
+        group.wait();
+    }
+    auto grouped = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Polling getTaskStatus: " << polling << " ms (" << polls << " statusMutex_ acquisitions)"
+              << std::endl;
+    std::cout << "TaskGroup::wait:       " << grouped << " ms" << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Polling vs group benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_task_group [任务数]
+int main(int argc, char** argv) {
+    std::cout << "=== Task Group Tests ===" << std::endl;
+
+    int numTasks = argc > 1 ? std::atoi(argv[1]) : 5000;
+
+    int passed = 0;
+    int total = 5;
+
+    if (testGroupWaitAndStats()) passed++;
+    if (testCancelAll()) passed++;
+    if (testNestedGroup()) passed++;
+    if (testShutdownReleasesGroup()) passed++;
+    if (benchmarkPollingVsGroup(numTasks)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
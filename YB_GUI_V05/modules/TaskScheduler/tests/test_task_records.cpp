@@ -0,0 +1,229 @@
+#include "../include/TaskScheduler.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+#include <unistd.h>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+SchedulerConfig recordConfig(size_t maxRecords, std::chrono::milliseconds retention) {
+    SchedulerConfig config = testConfig(2);
+    config.maxFinishedTaskRecords = maxRecords;
+    config.finishedTaskRetention = retention;
+    return config;
+}
+
+size_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// 测试1：超过保留数量时回收最早结束的记录，旧ID在槽位被复用后仍能识别为已回收
+bool testCountRetention() {
+    std::cout << "\n=== Test 1: Finished records are reclaimed by count ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(recordConfig(100, std::chrono::hours(1))));
+
+    TaskID first = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success);
+    assert(scheduler.waitForTask(first).status == ResultStatus::SUCCESS);
+    assert(scheduler.hasTaskRecord(first));
+    assert(scheduler.getTaskStatus(first) == TaskStatus::COMPLETED);
+
+    std::vector<TaskID> ids;
+    for (int i = 0; i < 300; ++i) {
+        ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success));
+        assert(ids.back() > (i == 0 ? first : ids[i - 1]));
+    }
+    for (TaskID id : ids) {
+        assert(scheduler.waitForTask(id).status == ResultStatus::SUCCESS);
+    }
+
+    // 最早的记录已被回收；复用了同一槽位的新任务有不同的ID，互不混淆
+    assert(!scheduler.hasTaskRecord(first));
+    assert(scheduler.getTaskStatus(first) == TaskStatus::CANCELLED);
+    TaskID reuser = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success);
+    assert(scheduler.waitForTask(reuser).status == ResultStatus::SUCCESS);
+    assert(scheduler.getTaskStatus(reuser) == TaskStatus::COMPLETED);
+    assert(!scheduler.hasTaskRecord(first));
+
+    PerformanceMetrics metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.retainedTaskRecords == 100);
+    assert(metrics.taskRecordSlots <= 100 + ids.size() + 2);
+
+    // 依赖已回收的任务视为前驱已完成，照常执行；依赖从未分配的ID时取消，数据流任务取不到结果时同样取消
+    TaskID late = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success, std::vector<TaskID>{first});
+    assert(scheduler.waitForTask(late).status == ResultStatus::SUCCESS);
+    TaskID unknown = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success,
+                                          std::vector<TaskID>{TaskID(1) << 50});
+    assert(scheduler.getTaskStatus(unknown) == TaskStatus::CANCELLED);
+    TaskID dataflow = scheduler.submitDataflowTask(TaskType::USER_DEFINED, Priority::NORMAL,
+        [](std::vector<std::any>&) { return success(); }, {first});
+    assert(scheduler.getTaskStatus(dataflow) == TaskStatus::CANCELLED);
+
+    scheduler.shutdown();
+    std::cout << "Count retention test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：超过保留时长的记录在没有新任务结束时也被回收；并发查询不加锁且不会读到复用者的状态
+bool testAgeRetentionAndLockFreeReads() {
+    std::cout << "\n=== Test 2: Records expire by age, reads never see a reused slot ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(recordConfig(1000, 200ms)));
+
+    std::vector<TaskID> stale;
+    for (int i = 0; i < 50; ++i) {
+        stale.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success));
+    }
+    scheduler.waitForTasks(stale);
+    assert(scheduler.hasTaskRecord(stale.front()));
+
+    std::this_thread::sleep_for(500ms);
+    assert(scheduler.getPerformanceMetrics().retainedTaskRecords == 0);
+    for (TaskID id : stale) {
+        assert(!scheduler.hasTaskRecord(id));
+    }
+
+    // 新任务复用这些槽位时，读取旧ID始终得到“不存在”，不会读到新任务的PENDING/RUNNING
+    std::atomic<bool> stop{false};
+    std::atomic<int> misreads{0};
+    std::atomic<size_t> reads{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            while (!stop) {
+                for (TaskID id : stale) {
+                    if (scheduler.getTaskStatus(id) != TaskStatus::CANCELLED) {
+                        misreads++;
+                    }
+                }
+                reads += stale.size();
+            }
+        });
+    }
+
+    for (int round = 0; round < 200; ++round) {
+        std::vector<TaskID> ids;
+        for (int i = 0; i < 50; ++i) {
+            ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success));
+        }
+        scheduler.waitForTasks(ids);
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    assert(misreads == 0);
+    assert(scheduler.getPerformanceMetrics().taskRecordSlots < 1200);
+
+    scheduler.shutdown();
+    std::cout << reads.load() << " lock-free reads of stale IDs, age retention test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：长时间运行（完成、失败、取消和依赖任务混合）时槽位数和常驻内存保持平稳。
+// 默认运行固定轮数；指定秒数时按时长运行（如604800为一周）
+bool soakTest(double seconds, int waves) {
+    std::cout << "\n=== Test 3: Soak (" << (seconds > 0 ? std::to_string(seconds) + " s" : std::to_string(waves) + " waves")
+              << ") ===" << std::endl;
+
+    const size_t maxRecords = 10000;
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(recordConfig(maxRecords, std::chrono::minutes(10))));
+
+    auto failing = []() -> TaskResult { throw std::runtime_error("soak failure"); };
+
+    size_t baselineSlots = 0;
+    size_t baselineBytes = 0;
+    size_t peakSlots = 0;
+    size_t tasks = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+    for (int wave = 0; seconds > 0 ? elapsed() < seconds : wave < waves; ++wave) {
+        std::vector<TaskID> ids;
+        std::atomic<bool> gate{false};
+        auto waitGate = [&gate] {
+            while (!gate) {
+                std::this_thread::sleep_for(100us);
+            }
+            return success();
+        };
+        TaskID blocker = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, waitGate);
+        ids.push_back(blocker);
+        // 另一个工作线程同样等到提交结束，每轮同时存在的记录数不随工作线程的快慢波动
+        ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, waitGate));
+        for (int i = 0; i < 1000; ++i) {
+            if (i % 50 == 0) {
+                ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, failing));
+            } else if (i % 10 == 0) {
+                ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success,
+                                                   std::vector<TaskID>{blocker}));
+            } else {
+                ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success));
+            }
+        }
+        // 一部分排队中的任务被取消
+        scheduler.cancelTasks(std::vector<TaskID>(ids.end() - 100, ids.end()));
+        gate = true;
+        scheduler.waitForTasks(ids);
+        tasks += ids.size();
+
+        PerformanceMetrics metrics = scheduler.getPerformanceMetrics();
+        assert(metrics.retainedTaskRecords <= maxRecords);
+        peakSlots = std::max(peakSlots, metrics.taskRecordSlots);
+
+        // 保留的记录填满后作为基线
+        if (wave == 20) {
+            baselineSlots = metrics.taskRecordSlots;
+            baselineBytes = residentBytes();
+        }
+    }
+
+    PerformanceMetrics metrics = scheduler.getPerformanceMetrics();
+    size_t finalBytes = residentBytes();
+    double growthMb = (static_cast<double>(finalBytes) - static_cast<double>(baselineBytes)) / (1024.0 * 1024.0);
+    std::cout << tasks << " tasks in " << elapsed() << " s; record slots " << baselineSlots << " -> "
+              << metrics.taskRecordSlots << " (peak " << peakSlots << "), retained " << metrics.retainedTaskRecords
+              << ", RSS growth " << growthMb << " MB" << std::endl;
+
+    // 槽位数只随同时存在的记录数（保留上限加一轮的任务数）波动，不随运行时长增长
+    assert(baselineSlots > 0);
+    assert(peakSlots <= baselineSlots + 16);
+    assert(peakSlots <= maxRecords + 1001 + 16);
+    assert(growthMb < 8.0);
+
+    scheduler.shutdown();
+    std::cout << "Soak test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_task_records [秒数] —— 不指定时运行200轮（约20万个任务）
+int main(int argc, char** argv) {
+    std::cout << "=== Task Record Table Tests ===" << std::endl;
+
+    double seconds = argc > 1 ? std::atof(argv[1]) : 0;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testCountRetention()) passed++;
+    if (testAgeRetentionAndLockFreeReads()) passed++;
+    if (soakTest(seconds, 200)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -342,7 +342,7 @@ bool testDataStructures() {
         assert(task2.id == 123);
         assert(task2.type == TaskType::AI_INFERENCE);
         assert(task2.priority == Priority::HIGH);
-        assert(task2.timeout == std::chrono::milliseconds(30000)); // 默认超时
+        assert(task2.timeout == std::chrono::milliseconds::max()); // 默认不限时
         
         // 测试TaskResult结构体
         TaskResult result1;
@@ -0,0 +1,339 @@
+#include "../include/TaskScheduler.h"
+#include "../include/DeadlineHeap.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+SchedulerConfig timeoutConfig(size_t threads) {
+    SchedulerConfig config = testConfig(threads);
+    config.maxFinishedTaskRecords = 10000000;
+    return config;
+}
+
+double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 轮询任务状态直到满足条件（不调用waitForTask，避免在测试线程上认领排队的任务）
+bool waitForStatus(TaskScheduler& scheduler, TaskID taskId, TaskStatus status,
+                   std::chrono::milliseconds limit = 5000ms) {
+    auto deadline = std::chrono::steady_clock::now() + limit;
+    while (scheduler.getTaskStatus(taskId) != status) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+// 测试1：排队超时的任务到期即结束，不再执行，后继随之取消
+bool testQueueTimeout() {
+    std::cout << "\n=== Test 1: Queue timeout ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(timeoutConfig(1)));
+
+    // 唯一的工作线程被占住，之后的任务只能排队
+    std::atomic<bool> release{false};
+    TaskID blocker = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&]() {
+        while (!release) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return success();
+    });
+    assert(waitForStatus(scheduler, blocker, TaskStatus::RUNNING));
+
+    std::atomic<bool> ran{false};
+    std::atomic<int> notified{-1};
+    auto task = std::make_shared<Task>(0, TaskType::USER_DEFINED, Priority::NORMAL, [&]() {
+        ran = true;
+        return success();
+    });
+    task->queueTimeout = 50ms;
+    task->onComplete = [&](const TaskResult& result) { notified = static_cast<int>(result.status); };
+    auto start = std::chrono::steady_clock::now();
+    TaskID expiring = scheduler.submitTask(task);
+    TaskID successor = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success,
+                                            std::vector<TaskID>{expiring});
+
+    assert(waitForStatus(scheduler, expiring, TaskStatus::TIMEOUT));
+    double expiredAfter = millisSince(start);
+    std::cout << "Queued task expired after " << expiredAfter << " ms (limit 50 ms)" << std::endl;
+    assert(expiredAfter >= 49.0);
+
+    assert(waitForStatus(scheduler, successor, TaskStatus::CANCELLED));
+    assert(notified == static_cast<int>(ResultStatus::TIMEOUT));
+    TaskResult result = scheduler.waitForTask(expiring);
+    assert(result.status == ResultStatus::TIMEOUT && result.errorMessage == "Task queue timeout");
+
+    // 放开工作线程：队列中的旧条目被跳过，排在它后面的任务照常执行
+    release = true;
+    TaskID after = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success);
+    assert(waitForStatus(scheduler, after, TaskStatus::COMPLETED));
+    assert(!ran);
+    assert(scheduler.getPerformanceMetrics().totalTasksTimedOut == 1);
+
+    scheduler.shutdown();
+    std::cout << "Queue timeout test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：执行时限从开始执行起算；超时的任务状态和结果立即变为TIMEOUT，等待方不再等它结束
+bool testExecutionTimeout() {
+    std::cout << "\n=== Test 2: Execution timeout ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(timeoutConfig(1)));
+
+    TaskID blocker = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, []() {
+        std::this_thread::sleep_for(150ms);
+        return success();
+    });
+
+    // 排队超过100ms，但执行只需20ms，不算超时
+    TaskID shortTask = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, []() {
+        std::this_thread::sleep_for(20ms);
+        return success();
+    }, 100ms);
+
+    // 执行300ms，时限50ms：任务不配合中止，结束时能看到自己已超时
+    std::atomic<bool> sawTimeout{false};
+    std::atomic<bool> finished{false};
+    TaskID longTask = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&]() {
+        assert(!TaskScheduler::currentTaskTimedOut());
+        std::this_thread::sleep_for(300ms);
+        sawTimeout = TaskScheduler::currentTaskTimedOut();
+        finished = true;
+        return success();
+    }, 50ms);
+
+    assert(waitForStatus(scheduler, longTask, TaskStatus::RUNNING));
+    assert(scheduler.getTaskStatus(shortTask) == TaskStatus::COMPLETED);
+    assert(scheduler.getTaskStatus(blocker) == TaskStatus::COMPLETED);
+
+    auto start = std::chrono::steady_clock::now();
+    TaskResult result = scheduler.waitForTask(longTask);
+    double waited = millisSince(start);
+    std::cout << "Waiter released after " << waited << " ms (task runs 300 ms, limit 50 ms)" << std::endl;
+    assert(result.status == ResultStatus::TIMEOUT && result.errorMessage == "Task execution timeout");
+    assert(!finished);
+    assert(waited < 250.0);
+
+    // 任务结束后仍保持超时结果，不再记为完成
+    while (!finished) {
+        std::this_thread::sleep_for(5ms);
+    }
+    assert(scheduler.submitAndWait(TaskType::USER_DEFINED, Priority::NORMAL, success).status == ResultStatus::SUCCESS);
+    assert(sawTimeout);
+    assert(scheduler.getTaskStatus(longTask) == TaskStatus::TIMEOUT);
+
+    PerformanceMetrics metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.totalTasksTimedOut == 1);
+    assert(metrics.totalTasksCompleted == 3);
+
+    scheduler.shutdown();
+    std::cout << "Execution timeout test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：超时堆的开销与到期数量成正比，与堆中未到期的任务数基本无关
+bool benchmarkDeadlineHeap(size_t pending, size_t expiring) {
+    std::cout << "\n=== Test 3: Deadline heap, " << expiring << " expirations ===" << std::endl;
+
+    auto measure = [&](size_t armed) {
+        DeadlineHeap heap;
+        auto far = std::chrono::steady_clock::now() + std::chrono::hours(1);
+        std::vector<std::shared_ptr<Task>> tasks;
+        tasks.reserve(armed + expiring);
+        for (size_t i = 0; i < armed; ++i) {
+            tasks.push_back(std::make_shared<Task>());
+            heap.arm(tasks.back(), DeadlineHeap::Kind::EXECUTION, far + std::chrono::microseconds(i * 7919 % 100000));
+        }
+
+        // 开始执行和结束时各一次（armed个任务之外的任务）
+        std::vector<std::shared_ptr<Task>> fresh;
+        for (size_t i = 0; i < expiring; ++i) {
+            fresh.push_back(std::make_shared<Task>());
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (auto& task : fresh) {
+            heap.arm(task, DeadlineHeap::Kind::QUEUE_WAIT, far);
+            heap.disarm(*task);
+        }
+        double armNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                       expiring;
+
+        // 已到期的条目一次取出
+        auto past = std::chrono::steady_clock::now() - 1ms;
+        for (auto& task : fresh) {
+            heap.arm(task, DeadlineHeap::Kind::EXECUTION, past);
+        }
+        start = std::chrono::steady_clock::now();
+        auto expired = heap.waitExpired(std::chrono::steady_clock::now());
+        double expireNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                          expiring;
+        assert(expired.size() == expiring);
+        assert(heap.size() == armed);
+
+        std::cout << armed << " pending: arm+disarm " << armNs << " ns, " << expireNs << " ns per expiration"
+                  << std::endl;
+        return expireNs;
+    };
+
+    // 只输出测量值：墙钟时间的比例在负载较高时（如ctest -j）不稳定
+    double small = measure(pending / 100);
+    double large = measure(pending);
+    std::cout << "Per-expiration cost grew " << large / small << "x for 100x pending tasks" << std::endl;
+
+    std::cout << "Deadline heap benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试4：设置执行时限时（每个任务开始和结束时更新超时堆）与不设时限时的吞吐量
+bool benchmarkTimedThroughput(size_t tasks, size_t workers) {
+    std::cout << "\n=== Test 4: Throughput with execution deadlines, " << tasks << " tasks ===" << std::endl;
+
+    auto run = [&](std::chrono::milliseconds timeout) {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(timeoutConfig(workers)));
+
+        std::vector<TaskID> ids;
+        ids.reserve(tasks);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < tasks; ++i) {
+            ids.push_back(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success, timeout));
+        }
+        for (const auto& result : scheduler.waitForTasks(ids)) {
+            assert(result.status == ResultStatus::SUCCESS);
+        }
+        double rate = tasks / (millisSince(start) / 1000.0);
+        scheduler.shutdown();
+        return rate;
+    };
+
+    // 交替运行，各取最好的一次
+    double unlimited = 0.0;
+    double timed = 0.0;
+    for (int round = 0; round < 2; ++round) {
+        unlimited = std::max(unlimited, run(std::chrono::milliseconds::max()));
+        timed = std::max(timed, run(30000ms));
+    }
+    std::cout << "No deadline:   " << unlimited << " tasks/s" << std::endl;
+    std::cout << "30 s deadline: " << timed << " tasks/s" << std::endl;
+
+    std::cout << "Timed throughput benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试5：排队超时的任务不再占用队列容量，队列中的旧条目出队时跳过
+bool testExpiredTasksLeaveQueue() {
+    std::cout << "\n=== Test 5: Expired tasks leave the queue ===" << std::endl;
+
+    SchedulerConfig config = timeoutConfig(1);
+    config.maxQueueSize = 4;
+    config.rejectionPolicy = RejectionPolicy::REJECT;
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    std::atomic<bool> release{false};
+    TaskID blocker = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, [&]() {
+        while (!release) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return success();
+    });
+    assert(waitForStatus(scheduler, blocker, TaskStatus::RUNNING));
+
+    // 占满队列，全部在排队时到期
+    std::atomic<int> ran{0};
+    std::vector<TaskID> expiring;
+    for (size_t i = 0; i < config.maxQueueSize; ++i) {
+        auto task = std::make_shared<Task>(0, TaskType::USER_DEFINED, Priority::NORMAL, [&ran]() {
+            ran++;
+            return success();
+        });
+        task->queueTimeout = 20ms;
+        expiring.push_back(scheduler.submitTask(task));
+        assert(expiring.back() != 0);
+    }
+    assert(scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success) == 0);
+    for (TaskID taskId : expiring) {
+        assert(waitForStatus(scheduler, taskId, TaskStatus::TIMEOUT));
+    }
+
+    // 到期的任务不再计入排队任务数，新任务可以入队
+    assert(scheduler.getPerformanceMetrics().currentQueueSize == 0);
+    TaskID accepted = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, success);
+    assert(accepted != 0);
+
+    release = true;
+    assert(waitForStatus(scheduler, accepted, TaskStatus::COMPLETED));
+    assert(ran == 0);
+    assert(scheduler.getPerformanceMetrics().currentQueueSize == 0);
+    scheduler.shutdown();
+    std::cout << "Expired queue entries test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试6：任务默认不限时；未指定执行时限的任务使用SchedulerConfig::defaultTimeout
+bool testDefaultTimeout() {
+    std::cout << "\n=== Test 6: Default execution timeout ===" << std::endl;
+
+    assert(Task().timeout == std::chrono::milliseconds::max());
+    assert(SchedulerConfig().defaultTimeout == std::chrono::milliseconds::max());
+
+    SchedulerConfig config = timeoutConfig(1);
+    config.defaultTimeout = 50ms;
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    auto slow = []() {
+        std::this_thread::sleep_for(150ms);
+        return success();
+    };
+    TaskID usesDefault = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, slow);
+    TaskID ownLimit = scheduler.submitTask(TaskType::USER_DEFINED, Priority::NORMAL, slow, 1000ms);
+
+    TaskResult result = scheduler.waitForTask(usesDefault);
+    assert(result.status == ResultStatus::TIMEOUT && result.errorMessage == "Task execution timeout");
+    assert(scheduler.waitForTask(ownLimit).status == ResultStatus::SUCCESS);
+
+    scheduler.shutdown();
+    std::cout << "Default timeout test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_task_timeouts [未到期任务数] [到期任务数] [吞吐量测试任务数] [工作线程数]
+int main(int argc, char** argv) {
+    std::cout << "=== Task Timeout Tests ===" << std::endl;
+
+    size_t pending = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    size_t expiring = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+    size_t tasks = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 50000;
+    size_t workers = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 4;
+
+    int passed = 0;
+    int total = 6;
+
+    if (testQueueTimeout()) passed++;
+    if (testExecutionTimeout()) passed++;
+    if (benchmarkDeadlineHeap(pending, expiring)) passed++;
+    if (benchmarkTimedThroughput(tasks, workers)) passed++;
+    if (testExpiredTasksLeaveQueue()) passed++;
+    if (testDefaultTimeout()) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
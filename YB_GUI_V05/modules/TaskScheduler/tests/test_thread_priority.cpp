@@ -0,0 +1,255 @@
+#include "../include/TaskScheduler.h"
+#include "../include/ThreadPriority.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cassert>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 读取当前线程的调度策略和nice值
+struct ObservedPriority {
+    int policy = 0;
+    int niceValue = 0;
+};
+
+ObservedPriority observeCurrentThread() {
+    ObservedPriority observed;
+#ifdef __linux__
+    observed.policy = sched_getscheduler(0);
+    pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    observed.niceValue = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+#endif
+    return observed;
+}
+
+// 测试1：权限探测与回退映射
+bool testCapabilitiesAndFallback() {
+    std::cout << "\n=== Test 1: Capability probe and fallback mapping ===" << std::endl;
+
+    const auto& caps = getOsPriorityCapabilities();
+    std::cout << "supported=" << caps.supported << " canRaise=" << caps.canRaise
+              << " canUseFifo=" << caps.canUseFifo << " canRestore=" << caps.canRestore << std::endl;
+
+    // NORMAL始终映射为默认类别
+    auto normal = mapPriorityToOs(Priority::NORMAL, true);
+    assert(normal.schedClass == OsSchedulingClass::NORMAL);
+
+    // 无权限时高优先级回退为默认nice值，而不是失败
+    auto critical = mapPriorityToOs(Priority::CRITICAL, false);
+    assert(critical.schedClass == OsSchedulingClass::NORMAL);
+    if (!caps.canRaise) {
+        assert(critical.niceValue == normal.niceValue);
+    } else {
+        assert(critical.niceValue < normal.niceValue);
+    }
+
+    auto background = mapPriorityToOs(Priority::BACKGROUND, false);
+    if (caps.canRestore) {
+        assert(background.schedClass == OsSchedulingClass::IDLE);
+    } else {
+        assert(background.schedClass == OsSchedulingClass::NORMAL);
+    }
+
+    // 未开启实时调度时不使用SCHED_FIFO
+    assert(mapPriorityToOs(Priority::CRITICAL, false).schedClass != OsSchedulingClass::REALTIME_FIFO);
+
+    std::cout << "Capability and fallback test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：线程类别随任务优先级切换
+bool testThreadClassSwitch() {
+    std::cout << "\n=== Test 2: Thread class switches per task priority ===" << std::endl;
+
+    const auto& caps = getOsPriorityCapabilities();
+    bool ok = true;
+
+    std::thread([&] {
+        auto before = observeCurrentThread();
+
+        applyThreadPriority(Priority::CRITICAL, false);
+        auto critical = observeCurrentThread();
+        if (caps.canRaise && critical.niceValue >= before.niceValue) ok = false;
+
+#ifdef __linux__
+        applyThreadPriority(Priority::BACKGROUND, false);
+        auto background = observeCurrentThread();
+        if (caps.canRestore && background.policy != SCHED_IDLE) ok = false;
+#endif
+
+        resetThreadPriority();
+        auto after = observeCurrentThread();
+        if (after.policy != before.policy || after.niceValue != before.niceValue) {
+            // 无恢复权限时不应降级，因此仍应回到初始状态
+            ok = false;
+        }
+    }).join();
+
+    assert(ok);
+    std::cout << "Thread class switch test PASSED ✓" << std::endl;
+    return ok;
+}
+
+// 测试3：调度器按任务优先级设置工作线程类别
+bool testSchedulerMapping() {
+    std::cout << "\n=== Test 3: Scheduler applies mapping per task ===" << std::endl;
+
+    SchedulerConfig config;
+    config.minThreads = 2;
+    config.enableLoadBalancing = false;
+    config.enableOsPriorityMapping = true;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(config));
+
+    std::mutex mutex;
+    std::vector<std::pair<Priority, ObservedPriority>> observed;
+    std::atomic<int> done{0};
+
+    for (auto priority : {Priority::CRITICAL, Priority::NORMAL, Priority::BACKGROUND}) {
+        scheduler.submitTask(TaskType::USER_DEFINED, priority, [priority, &mutex, &observed, &done] {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                observed.emplace_back(priority, observeCurrentThread());
+            }
+            done++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + 3s;
+    while (done < 3 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    scheduler.shutdown();
+    assert(done == 3);
+
+    const auto& caps = getOsPriorityCapabilities();
+    auto base = mapPriorityToOs(Priority::NORMAL, false);
+    for (const auto& [priority, seen] : observed) {
+        std::cout << priorityToString(priority) << ": policy=" << seen.policy
+                  << " nice=" << seen.niceValue << std::endl;
+        if (priority == Priority::CRITICAL && caps.canRaise) {
+            assert(seen.niceValue < base.niceValue);
+        }
+#ifdef __linux__
+        if (priority == Priority::BACKGROUND && caps.canRestore) {
+            assert(seen.policy == SCHED_IDLE);
+        }
+#endif
+        if (priority == Priority::NORMAL) {
+            assert(seen.niceValue == base.niceValue);
+        }
+    }
+
+    std::cout << "Scheduler mapping test PASSED ✓" << std::endl;
+    return true;
+}
+
+// CPU密集干扰下CRITICAL任务的提交到开始延迟（微秒）
+std::vector<double> measureCriticalLatency(bool enableMapping, int numTasks) {
+    std::atomic<bool> stopHogs{false};
+    std::vector<std::thread> hogs;
+    size_t numHogs = std::max(2u, std::thread::hardware_concurrency()) * 2;
+    for (size_t i = 0; i < numHogs; ++i) {
+        hogs.emplace_back([&stopHogs] {
+            volatile unsigned long x = 0;
+            while (!stopHogs.load(std::memory_order_relaxed)) {
+                x = x + 1;
+            }
+        });
+    }
+
+    SchedulerConfig config;
+    config.minThreads = 2;
+    config.enableLoadBalancing = false;
+    config.enableOsPriorityMapping = enableMapping;
+
+    TaskScheduler scheduler;
+    scheduler.initialize(config);
+
+    std::mutex mutex;
+    std::vector<double> latencies;
+    std::atomic<int> done{0};
+
+    for (int i = 0; i < numTasks; ++i) {
+        auto submitted = std::chrono::steady_clock::now();
+        scheduler.submitTask(TaskType::USER_DEFINED, Priority::CRITICAL, [submitted, &mutex, &latencies, &done] {
+            auto started = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                latencies.push_back(std::chrono::duration<double, std::micro>(started - submitted).count());
+            }
+            done++;
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+        std::this_thread::sleep_for(5ms);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (done < numTasks && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    stopHogs = true;
+    for (auto& t : hogs) {
+        t.join();
+    }
+    scheduler.shutdown();
+
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+// 测试4：CPU干扰下CRITICAL延迟对比
+bool benchmarkCriticalLatency() {
+    std::cout << "\n=== Test 4: CRITICAL latency under CPU hog ===" << std::endl;
+
+    const int NUM_TASKS = 40;
+    auto report = [](const char* label, const std::vector<double>& latencies) {
+        if (latencies.empty()) {
+            std::cout << label << ": no samples" << std::endl;
+            return;
+        }
+        double p50 = latencies[latencies.size() / 2];
+        double p99 = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+        std::cout << label << ": p50=" << p50 << " us, p99=" << p99 << " us, max="
+                  << latencies.back() << " us" << std::endl;
+    };
+
+    report("Mapping off", measureCriticalLatency(false, NUM_TASKS));
+    report("Mapping on ", measureCriticalLatency(true, NUM_TASKS));
+
+    std::cout << "CRITICAL latency benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "=== OS Thread Priority Mapping Tests ===" << std::endl;
+
+    int passed = 0;
+    int total = 4;
+
+    if (testCapabilitiesAndFallback()) passed++;
+    if (testThreadClassSwitch()) passed++;
+    if (testSchedulerMapping()) passed++;
+    if (benchmarkCriticalLatency()) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
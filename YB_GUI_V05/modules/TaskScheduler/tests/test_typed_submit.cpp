@@ -0,0 +1,291 @@
+#include "../include/TaskScheduler.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <new>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+// 统计全局分配次数
+std::atomic<size_t> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+struct CustomError {
+    int code;
+};
+
+// 测试1：结果类型原样返回，包括void和只能移动的类型
+bool testResultTypes() {
+    std::cout << "\n=== Test 1: Exact result types ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(2)));
+
+    TaskHandle<int> number = scheduler.submit(TaskType::DATA_ANALYSIS, Priority::NORMAL, [] { return 42; });
+    TaskHandle<std::string> text = scheduler.submit(TaskType::DATA_ANALYSIS, Priority::HIGH, [] {
+        return std::string(100, 'x');
+    });
+
+    // 只能移动的可调用对象和结果
+    auto owned = std::make_unique<int>(7);
+    auto pointer = scheduler.submit(TaskType::DATA_ANALYSIS, Priority::NORMAL, [owned = std::move(owned)]() mutable {
+        return std::move(owned);
+    });
+    static_assert(std::is_same_v<decltype(pointer), TaskHandle<std::unique_ptr<int>>>);
+
+    std::atomic<bool> ran{false};
+    TaskHandle<void> nothing = scheduler.submit(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&ran] { ran = true; });
+
+    assert(number.valid() && number.id() != 0);
+    assert(text.id() > number.id());
+    assert(number.get() == 42);
+    assert(text.get() == std::string(100, 'x'));
+    assert(*pointer.get() == 7);
+    nothing.get();
+    assert(ran);
+    assert(number.status() == TaskStatus::COMPLETED);
+
+    // 与submitTask的任务共用同一套登记和统计
+    auto metrics = scheduler.getPerformanceMetrics();
+    assert(metrics.totalTasksSubmitted == 4);
+    assert(metrics.totalTasksCompleted == 4);
+
+    scheduler.shutdown();
+    std::cout << "Result types test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：异常、取消、提交失败和嵌套等待
+bool testErrorsAndNesting() {
+    std::cout << "\n=== Test 2: Exceptions, cancellation and nesting ===" << std::endl;
+
+    TaskScheduler scheduler;
+    SchedulerConfig config = testConfig(1);
+    config.maxCompensationThreads = 0;
+    assert(scheduler.initialize(config));
+
+    // 任务抛出的异常原样传给get，调度器记为失败
+    auto failing = scheduler.submit(TaskType::USER_DEFINED, Priority::NORMAL, []() -> int {
+        throw CustomError{17};
+    });
+    try {
+        failing.get();
+        assert(false);
+    } catch (const CustomError& error) {
+        assert(error.code == 17);
+    }
+    assert(failing.status() == TaskStatus::FAILED);
+    assert(scheduler.getPerformanceMetrics().totalTasksFailed == 1);
+
+    // 占住工作线程后取消排队的任务
+    std::atomic<bool> started{false};
+    std::atomic<bool> gate{false};
+    auto blocker = scheduler.submit(TaskType::USER_DEFINED, Priority::CRITICAL, [&] {
+        started = true;
+        while (!gate) {
+            std::this_thread::sleep_for(1ms);
+        }
+    });
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+    auto cancelled = scheduler.submit(TaskType::USER_DEFINED, Priority::NORMAL, [] { return 1; });
+    assert(cancelled.status() == TaskStatus::PENDING);
+    assert(cancelled.cancel());
+    assert(!cancelled.wait());
+    bool threw = false;
+    try {
+        cancelled.get();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    gate = true;
+    blocker.get();
+
+    // 任务内等待子任务：被等待的子任务在同一线程上执行
+    auto outer = scheduler.submit(TaskType::USER_DEFINED, Priority::NORMAL, [&scheduler] {
+        std::vector<TaskHandle<int>> children;
+        for (int i = 1; i <= 10; ++i) {
+            children.push_back(scheduler.submit(TaskType::USER_DEFINED, Priority::NORMAL, [i] { return i * i; }));
+        }
+        int sum = 0;
+        for (auto& child : children) {
+            sum += child.get();
+        }
+        return sum;
+    });
+    assert(outer.get() == 385);
+
+    // 暂停时提交失败，得到无效句柄
+    scheduler.pauseScheduling();
+    auto rejected = scheduler.submit(TaskType::USER_DEFINED, Priority::NORMAL, [] { return 0; });
+    assert(!rejected.valid() && rejected.id() == 0 && !rejected.wait());
+    scheduler.resumeScheduling();
+
+    scheduler.shutdown();
+    std::cout << "Errors and nesting test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：执行超时的任务仍在运行，get立即抛出而不读取它之后写入的结果
+bool testTimedOutHandle() {
+    std::cout << "\n=== Test 3: Handle of a timed-out task ===" << std::endl;
+
+    TaskScheduler scheduler;
+    SchedulerConfig config = testConfig(1);
+    config.defaultTimeout = 30ms;
+    assert(scheduler.initialize(config));
+
+    std::atomic<bool> finished{false};
+    auto slow = scheduler.submit(TaskType::USER_DEFINED, Priority::NORMAL, [&finished] {
+        std::this_thread::sleep_for(200ms);
+        finished = true;
+        return std::string(1000, 'x');
+    });
+
+    // 等到工作线程开始执行，get不会在调用线程上认领它
+    while (slow.status() == TaskStatus::PENDING) {
+        std::this_thread::sleep_for(1ms);
+    }
+    std::string message;
+    try {
+        slow.get();
+        assert(false);
+    } catch (const std::runtime_error& error) {
+        message = error.what();
+    }
+    assert(!finished);
+    assert(message.find("Task execution timeout") != std::string::npos);
+
+    // 任务结束后仍不交出结果
+    while (!finished) {
+        std::this_thread::sleep_for(5ms);
+    }
+    assert(slow.status() == TaskStatus::TIMEOUT);
+    assert(!slow.wait());
+
+    scheduler.shutdown();
+    std::cout << "Timed-out handle test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试4：与submitTask + std::any相比的分配次数和延迟
+bool benchmarkAllocationsAndLatency(int numTasks) {
+    std::cout << "\n=== Test 4: Allocations and latency (" << numTasks << " tasks) ===" << std::endl;
+
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(2)));
+
+    // 典型的小任务：捕获几个参数，返回一个小的聚合结果
+    struct Stats {
+        double min;
+        double max;
+        double mean;
+    };
+    std::vector<double> data(64);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<double>(i % 17);
+    }
+    auto compute = [&data](size_t begin, size_t end) {
+        Stats stats{data[begin], data[begin], 0};
+        for (size_t i = begin; i < end; ++i) {
+            stats.min = std::min(stats.min, data[i]);
+            stats.max = std::max(stats.max, data[i]);
+            stats.mean += data[i];
+        }
+        stats.mean /= static_cast<double>(end - begin);
+        return stats;
+    };
+
+    double checksum[2] = {0, 0};
+    auto run = [&](bool typed) {
+        std::vector<double> latencies;
+        latencies.reserve(numTasks);
+        size_t before = allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numTasks; ++i) {
+            size_t begin = static_cast<size_t>(i) % 32;
+            size_t end = begin + 32;
+            auto submitted = std::chrono::steady_clock::now();
+            Stats stats;
+            if (typed) {
+                stats = scheduler.submit(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&compute, begin, end] {
+                    return compute(begin, end);
+                }).get();
+            } else {
+                TaskID id = scheduler.submitTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&compute, begin, end] {
+                    TaskResult result(0, ResultStatus::SUCCESS);
+                    result.result = compute(begin, end);
+                    return result;
+                });
+                stats = std::any_cast<Stats>(scheduler.waitForTask(id).result);
+            }
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - submitted).count());
+            checksum[typed] += stats.mean + stats.max - stats.min;
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        double perTask = static_cast<double>(allocations.load() - before) / numTasks;
+
+        scheduler.clearCompletedTasks();
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << (typed ? "submit<F>:   " : "submitTask:  ") << perTask << " allocations/task, "
+                  << elapsed << " ms, p50 " << latencies[latencies.size() / 2] << " us, p99 "
+                  << latencies[latencies.size() * 99 / 100] << " us" << std::endl;
+        return perTask;
+    };
+
+    double erased = run(false);
+    double typed = run(true);
+    assert(checksum[0] == checksum[1]);
+    // 省去std::function的堆存储和std::any的装箱
+    assert(typed + 1.5 <= erased);
+
+    scheduler.shutdown();
+    std::cout << "Allocation benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_typed_submit [任务数]
+int main(int argc, char** argv) {
+    std::cout << "=== Typed Submit Tests ===" << std::endl;
+
+    int numTasks = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    int passed = 0;
+    int total = 4;
+
+    if (testResultTypes()) passed++;
+    if (testErrorsAndNesting()) passed++;
+    if (testTimedOutHandle()) passed++;
+    if (benchmarkAllocationsAndLatency(numTasks)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+#include "../include/TaskScheduler.h"
+#include "TestUtil.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+
+using namespace YB;
+using namespace std::chrono_literals;
+
+std::atomic<int> contextsCreated{0};
+std::atomic<int> contextsDestroyed{0};
+std::atomic<int> destroyedOnOwner{0};
+
+// 模拟推理会话：创建时分配并初始化暂存缓冲区，记录所属线程
+class ScratchContext : public WorkerContext {
+public:
+    explicit ScratchContext(size_t bytes) : owner(std::this_thread::get_id()), scratch(bytes) {
+        std::memset(scratch.data(), 1, scratch.size());
+        contextsCreated++;
+    }
+
+    ~ScratchContext() override {
+        contextsDestroyed++;
+        if (std::this_thread::get_id() == owner) {
+            destroyedOnOwner++;
+        }
+    }
+
+    std::thread::id owner;
+    std::vector<uint8_t> scratch;
+    size_t uses = 0;
+};
+
+void resetCounters() {
+    contextsCreated = 0;
+    contextsDestroyed = 0;
+    destroyedOnOwner = 0;
+}
+
+// 测试1：每个工作线程只创建一次上下文，调度器关闭后全部销毁
+bool testCreatedOncePerWorker() {
+    std::cout << "\n=== Test 1: One context per worker and TaskType ===" << std::endl;
+
+    resetCounters();
+    std::atomic<int> wrongThread{0};
+    {
+        TaskScheduler scheduler;
+        assert(scheduler.initialize(testConfig(3)));
+        scheduler.setWorkerContextFactory(TaskType::AI_INFERENCE, [] {
+            return std::make_unique<ScratchContext>(1024);
+        });
+        scheduler.setWorkerContextFactory(TaskType::IMAGE_PROCESSING, [] {
+            return std::make_unique<ScratchContext>(4096);
+        });
+
+        std::vector<TaskID> ids;
+        for (int i = 0; i < 2000; ++i) {
+            TaskType type = i % 2 ? TaskType::AI_INFERENCE : TaskType::IMAGE_PROCESSING;
+            size_t expectedSize = i % 2 ? 1024 : 4096;
+            TaskID id = scheduler.submitContextTask(type, Priority::NORMAL, [&wrongThread, expectedSize](WorkerContext& context) {
+                auto& scratch = static_cast<ScratchContext&>(context);
+                if (scratch.owner != std::this_thread::get_id() || scratch.scratch.size() != expectedSize) {
+                    wrongThread++;
+                }
+                scratch.uses++;
+                return TaskResult(0, ResultStatus::SUCCESS);
+            });
+            assert(id != 0);
+            ids.push_back(id);
+        }
+        for (const auto& result : scheduler.waitForTasks(ids)) {
+            assert(result.status == ResultStatus::SUCCESS);
+        }
+
+        // 3个工作线程 × 2种类型，外加调用线程上直接执行时创建的
+        auto metrics = scheduler.getPerformanceMetrics();
+        assert(metrics.totalWorkerContextsCreated == static_cast<size_t>(contextsCreated.load()));
+        std::cout << "Contexts created for 2000 tasks: " << contextsCreated << std::endl;
+        assert(contextsCreated <= 8);
+
+        scheduler.shutdown();
+    }
+    assert(wrongThread == 0);
+    assert(contextsDestroyed == contextsCreated);
+    std::cout << "Destroyed on the owning worker: " << destroyedOnOwner << "/" << contextsDestroyed << std::endl;
+
+    std::cout << "Created once test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试2：未注册工厂时任务失败；替换工厂后重建；嵌套执行时使用临时上下文
+bool testFactoryRules() {
+    std::cout << "\n=== Test 2: Missing, replaced and nested contexts ===" << std::endl;
+
+    resetCounters();
+    {
+        TaskScheduler scheduler;
+        SchedulerConfig config = testConfig(1);
+        config.maxCompensationThreads = 0;
+        assert(scheduler.initialize(config));
+
+        TaskID missing = scheduler.submitContextTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, [](WorkerContext&) {
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+        assert(scheduler.waitForTask(missing).status == ResultStatus::FAILURE);
+
+        scheduler.setWorkerContextFactory(TaskType::DATA_ANALYSIS, [] {
+            return std::make_unique<ScratchContext>(16);
+        });
+
+        // 外层任务等待同类子任务，子任务在同一线程上帮忙执行时不能与外层共用上下文
+        std::atomic<bool> shared{false};
+        TaskID outer = scheduler.submitContextTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&](WorkerContext& context) {
+            WorkerContext* outerContext = &context;
+            TaskID inner = scheduler.submitContextTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&, outerContext](WorkerContext& innerContext) {
+                if (&innerContext == outerContext) {
+                    shared = true;
+                }
+                return TaskResult(0, ResultStatus::SUCCESS);
+            });
+            return scheduler.waitForTask(inner);
+        });
+        assert(scheduler.waitForTask(outer, 5000ms).status == ResultStatus::SUCCESS);
+        assert(!shared);
+        int beforeReplace = contextsCreated;
+
+        // 替换工厂后下次使用时重建
+        scheduler.setWorkerContextFactory(TaskType::DATA_ANALYSIS, [] {
+            return std::make_unique<ScratchContext>(32);
+        });
+        std::atomic<size_t> size{0};
+        TaskID replaced = scheduler.submitContextTask(TaskType::DATA_ANALYSIS, Priority::NORMAL, [&size](WorkerContext& context) {
+            size = static_cast<ScratchContext&>(context).scratch.size();
+            return TaskResult(0, ResultStatus::SUCCESS);
+        });
+        assert(scheduler.waitForTask(replaced).status == ResultStatus::SUCCESS);
+        assert(size == 32);
+        assert(contextsCreated == beforeReplace + 1);
+
+        scheduler.shutdown();
+    }
+    assert(contextsDestroyed == contextsCreated);
+
+    std::cout << "Factory rules test PASSED ✓" << std::endl;
+    return true;
+}
+
+// 测试3：每个任务自行初始化与复用工作线程上下文的对比
+bool benchmarkAmortizedSetup(int numTasks, size_t scratchBytes) {
+    std::cout << "\n=== Test 3: Per-task setup vs worker context (" << numTasks << " tasks, "
+              << scratchBytes / 1024 << " KB scratch) ===" << std::endl;
+
+    resetCounters();
+    TaskScheduler scheduler;
+    assert(scheduler.initialize(testConfig(2)));
+    scheduler.setWorkerContextFactory(TaskType::IMAGE_PROCESSING, [scratchBytes] {
+        return std::make_unique<ScratchContext>(scratchBytes);
+    });
+
+    std::atomic<uint64_t> checksum{0};
+    auto work = [&checksum](std::vector<uint8_t>& scratch) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < scratch.size(); i += 4096) {
+            scratch[i]++;
+            sum += scratch[i];
+        }
+        checksum += sum;
+    };
+
+    // 现有方式：每次运行都分配并初始化缓冲区
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<TaskID> ids;
+        ids.reserve(numTasks);
+        for (int i = 0; i < numTasks; ++i) {
+            ids.push_back(scheduler.submitTask(TaskType::IMAGE_PROCESSING, Priority::NORMAL, [&work, scratchBytes] {
+                ScratchContext context(scratchBytes);
+                work(context.scratch);
+                return TaskResult(0, ResultStatus::SUCCESS);
+            }));
+        }
+        for (const auto& result : scheduler.waitForTasks(ids)) {
+            assert(result.status == ResultStatus::SUCCESS);
+        }
+    }
+    auto perTask = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    int perTaskSetups = contextsCreated;
+
+    resetCounters();
+    start = std::chrono::steady_clock::now();
+    {
+        std::vector<TaskID> ids;
+        ids.reserve(numTasks);
+        for (int i = 0; i < numTasks; ++i) {
+            ids.push_back(scheduler.submitContextTask(TaskType::IMAGE_PROCESSING, Priority::NORMAL, [&work](WorkerContext& context) {
+                work(static_cast<ScratchContext&>(context).scratch);
+                return TaskResult(0, ResultStatus::SUCCESS);
+            }));
+        }
+        for (const auto& result : scheduler.waitForTasks(ids)) {
+            assert(result.status == ResultStatus::SUCCESS);
+        }
+    }
+    auto pooled = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    int pooledSetups = contextsCreated;
+
+    assert(perTaskSetups == numTasks);
+    assert(pooledSetups <= 3);
+
+    std::cout << "Per-task setup:  " << perTask << " ms (" << perTaskSetups << " setups)" << std::endl;
+    std::cout << "Worker context:  " << pooled << " ms (" << pooledSetups << " setups, "
+              << perTask / pooled << "x)" << std::endl;
+
+    scheduler.shutdown();
+    std::cout << "Amortized setup benchmark PASSED ✓" << std::endl;
+    return true;
+}
+
+// 用法：test_worker_context [任务数] [缓冲区KB]
+int main(int argc, char** argv) {
+    std::cout << "=== Worker Context Tests ===" << std::endl;
+
+    int numTasks = argc > 1 ? std::atoi(argv[1]) : 100000;
+    size_t scratchKb = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 256;
+
+    int passed = 0;
+    int total = 3;
+
+    if (testCreatedOncePerWorker()) passed++;
+    if (testFactoryRules()) passed++;
+    if (benchmarkAmortizedSetup(numTasks, scratchKb * 1024)) passed++;
+
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return (passed == total) ? 0 : 1;
+}